@@ -58,6 +58,7 @@ class AOS : public internal::AOSBase<typename Box_t::Var_t, double, Arg_t, Box_t
                                  RecordOption::DONT_RECORD_FITNESS>;
 
   HEU_RELOAD_MEMBERFUCTION_RUN
+  HEU_RELOAD_MEMBERFUCTION_CHECKPOINT
 
  protected:
   static inline bool electronIteratorCompareFun(const ElectronIt_t& a,
@@ -78,11 +78,11 @@ class AOS4Eigen : public AOSBoxed<Var_t, Fitness_t, Arg_t, Box_t, _iFun_, _fFun_
         layer.bindingState += layer.at(idx)->state;
         layer.bindingEnergy += layer.at(idx)->energy;
         if constexpr (fOpt == FitnessOption::FITNESS_LESS_BETTER) {
-          if (layer.at(idx) < layer.at(layer.layerBestIdx)) {
+          if (layer.at(idx)->energy < layer.layerBestEnergy()) {
             layer.layerBestIdx = idx;
           }
         } else {
-          if (layer.at(idx) > layer.at(layer.layerBestIdx)) {
+          if (layer.at(idx)->energy > layer.layerBestEnergy()) {
             layer.layerBestIdx = idx;
           }
         }
@@ -114,19 +114,16 @@ class AOS4Eigen : public AOSBoxed<Var_t, Fitness_t, Arg_t, Box_t, _iFun_, _fFun_
                          (layerIdx + 1);
     }
 
-    for (int varIdx = 0; varIdx < alpha.size(); varIdx++) {
-      this->applyConstraint(&child->state, varIdx);
-    }
+    this->applyConstraint(&child->state);
   }
 
   inline void __impl2_applyNonPhotonEffect(const Electron& parent,
                                            Electron_t* child) const noexcept {
-    child->state =
-        parent.state + this->delta() * Var_t::Random(parent.state.rows(), parent.state.cols());
-
-    for (int idx = 0; idx < parent.state.size(); idx++) {
-      this->applyConstraint(&child->state, idx);
-    }
+    // draw from heu's streams instead of Var_t::Random, which uses std::rand
+    Var_t offset(parent.state.rows(), parent.state.cols());
+    randD(offset.data(), int(offset.size()), -1, 1);
+    child->state = parent.state + this->delta() * offset;
+    this->applyConstraint(&child->state);
   }
 };
 
@@ -250,9 +247,7 @@ class AOS4Std : public AOSBoxed<Var_t, Fitness_t, Arg_t, Box_t, _iFun_, _fFun_,
       }
     }
 
-    for (int idx = 0; idx < this->dimensions(); idx++) {
-      this->applyConstraint(&child->state, idx);
-    }
+    this->applyConstraint(&child->state);
   }
 
   inline void __impl2_applyNonPhotonEffect(const Electron& parent,
@@ -264,9 +259,8 @@ class AOS4Std : public AOSBoxed<Var_t, Fitness_t, Arg_t, Box_t, _iFun_, _fFun_,
     child->state = parent.state;
     for (int idx = 0; idx < this->dimensions(); idx++) {
       child->state[idx] += randD(-this->delta(idx), this->delta(idx));
-
-      this->applyConstraint(&child->state, idx);
     }
+    this->applyConstraint(&child->state);
   }
 };
 }  // namespace internal
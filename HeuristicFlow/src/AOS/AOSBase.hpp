@@ -20,6 +20,8 @@ This file is part of HeuristicFlow.
 #ifndef HEU_AOSBASE_HPP
 #define HEU_AOSBASE_HPP
 
+#include <unordered_map>
+
 #include "InternalHeaderCheck.h"
 #include "AOS4EigenAndStd.hpp"
 
@@ -79,7 +81,8 @@ class AOSBase
 
   inline bool __impl_shouldTerminate() const noexcept {
     return this->_generation >= this->_option.maxGeneration ||
-           this->_earlyStopCounter >= this->_option.maxEarlyStop;
+           this->_earlyStopCounter >= this->_option.maxEarlyStop ||
+           this->_termination.shouldStop(this->_option.termination);
   }
 
   template <class this_t>
@@ -101,29 +104,163 @@ class AOSBase
     }
   }
 
+  template <class this_t, class Observer_t>
+  void __impl_run(Observer_t&& observer) noexcept {
+    this->_termination.start();
+    this->_profile.reset();
+    static_cast<this_t*>(this)->template __impl_evaluate<this_t>();
+    if (!notifyObserver(observer, *static_cast<const this_t*>(this))) {
+      return;
+    }
+    __impl_resume<this_t>(observer);
+  }
+
+  /**
+   * \brief Run generations until the solver terminates. It continues a run after the first
+   * generation is evaluated or a checkpoint is loaded.
+   */
+  template <class this_t, class Observer_t>
+  void __impl_resume(Observer_t&& observer) noexcept {
+    while (!static_cast<this_t*>(this)->__impl_shouldTerminate()) {
+      {
+        ProfileTimer timer(&this->_profile, PHASE_UPDATE_POPULATION);
+        static_cast<this_t*>(this)->__impl_computeLayerBSBELE();
+
+        static_cast<this_t*>(this)->template __impl_updateElectrons<this_t>();
+      }
+
+      this->_generation++;
+      static_cast<this_t*>(this)->template __impl_evaluate<this_t>();
+      if (!notifyObserver(observer, *static_cast<const this_t*>(this))) {
+        return;
+      }
+    }
+  }
+
+  /// Compute energies, find the best electron, record fitness and make layers.
   template <class this_t>
-  void __impl_run() noexcept {
-    while (true) {
+  inline void __impl_evaluate() noexcept {
+    {
+      ProfileTimer timer(&this->_profile, PHASE_FITNESS);
       static_cast<this_t*>(this)->__impl_computeFitness();
+    }
+
+    ProfileTimer timer(&this->_profile, PHASE_MAKE_LAYERS);
+    static_cast<this_t*>(this)->__impl_computeAtomBSBELE();
+    this->_termination.template reportBestFitness<fOpt>(this->_option.termination,
+                                                        this->_atomBestPtr->energy);
+
+    static_cast<this_t*>(this)->__impl_recordFitness();
 
-      static_cast<this_t*>(this)->__impl_computeAtomBSBELE();
+    static_cast<this_t*>(this)->__impl_selectAndMakeLayers();
+  }
+
+  /**
+   * \brief Write the state of a paused run to a binary stream.
+   *
+   * The checkpoint contains the random state of the calling thread, counters, electrons in order,
+   * layers as indices of electrons, the binding state and energy, and records.
+   *
+   * \return Whether all bytes are written.
+   */
+  template <class this_t>
+  bool __impl_saveCheckpoint(std::ostream& os) const noexcept {
+    std::unordered_map<const Electron_t*, uint64_t> indices;
+    indices.reserve(this->_electrons.size());
+    for (const Electron_t& elec : this->_electrons) {
+      indices.emplace(&elec, uint64_t(indices.size()));
+    }
 
-      static_cast<this_t*>(this)->__impl_recordFitness();
+    writeCheckpointHeader<this_t>(os);
+    writeBinary(os, uint64_t(this->_generation));
+    writeBinary(os, uint64_t(this->_earlyStopCounter));
+    writeBinary(os, uint64_t(this->_termination.evaluations()));
+    writeBinary(os, this->_termination.targetReached());
+    writeBinary(os, uint64_t(this->_electrons.size()));
+    for (const Electron_t& elec : this->_electrons) {
+      writeBinary(os, elec.state);
+      writeBinary(os, elec.energy);
+      writeBinary(os, elec.isComputed);
+    }
+    writeBinary(os, indices.at(this->_atomBestPtr));
+    writeBinary(os, uint64_t(this->_layers.size()));
+    for (const Layer_t& layer : this->_layers) {
+      std::vector<uint64_t> members(layer.size());
+      for (size_t i = 0; i < layer.size(); i++) {
+        members[i] = indices.at(layer[i]);
+      }
+      writeBinary(os, members);
+    }
+    writeBinary(os, this->_bindingState);
+    writeBinary(os, this->_bindingEnergy);
+    static_cast<const this_t*>(this)->__impl_saveRecord(os);
+    return bool(os);
+  }
 
-      static_cast<this_t*>(this)->__impl_selectAndMakeLayers();
+  /**
+   * \brief Restore a run written by `__impl_saveCheckpoint`. `initializePop` must be called before
+   * with the same options. The time limit starts again from loading.
+   *
+   * \return false if the stream is truncated or belongs to another kind of solver. The solver must
+   * be initialized again in that case.
+   */
+  template <class this_t>
+  bool __impl_loadCheckpoint(std::istream& is) noexcept {
+    uint64_t generation = 0, earlyStopCounter = 0, evaluations = 0, elecNum = 0;
+    bool targetReached = false;
+    if (!readCheckpointHeader<this_t>(is) || !readBinary(is, &generation) ||
+        !readBinary(is, &earlyStopCounter) || !readBinary(is, &evaluations) ||
+        !readBinary(is, &targetReached) || !readBinary(is, &elecNum) || elecNum == 0) {
+      return false;
+    }
 
-      if (static_cast<this_t*>(this)->__impl_shouldTerminate()) {
-        break;
+    this->_electrons.resize(elecNum);
+    std::vector<Electron_t*> electrons;
+    electrons.reserve(elecNum);
+    for (Electron_t& elec : this->_electrons) {
+      if (!readBinary(is, &elec.state) || !readBinary(is, &elec.energy) ||
+          !readBinary(is, &elec.isComputed)) {
+        return false;
       }
+      electrons.emplace_back(&elec);
+    }
 
-      static_cast<this_t*>(this)->__impl_computeLayerBSBELE();
+    uint64_t bestIdx = 0, layerNum = 0;
+    if (!readBinary(is, &bestIdx) || bestIdx >= elecNum || !readBinary(is, &layerNum)) {
+      return false;
+    }
+    this->_atomBestPtr = electrons[bestIdx];
 
-      static_cast<this_t*>(this)->template __impl_updateElectrons<this_t>();
+    this->_layers.resize(layerNum);
+    for (Layer_t& layer : this->_layers) {
+      std::vector<uint64_t> members;
+      if (!readBinary(is, &members)) {
+        return false;
+      }
+      layer.clear();
+      for (uint64_t idx : members) {
+        if (idx >= elecNum) {
+          return false;
+        }
+        layer.emplace_back(electrons[idx]);
+      }
+    }
 
-      this->_generation++;
+    if (!readBinary(is, &this->_bindingState) || !readBinary(is, &this->_bindingEnergy) ||
+        !static_cast<this_t*>(this)->__impl_loadRecord(is)) {
+      return false;
     }
+    this->_generation = generation;
+    this->_earlyStopCounter = earlyStopCounter;
+    this->_termination.resume(evaluations, targetReached);
+    this->_profile.reset();
+    return true;
   }
 
+  inline void __impl_saveRecord(std::ostream&) const noexcept {}
+
+  inline bool __impl_loadRecord(std::istream&) noexcept { return true; }
+
   static_assert(rOpt == RecordOption::DONT_RECORD_FITNESS, "Wrong specilization!");
 };
 
@@ -155,6 +292,10 @@ class AOSBase<Var_t, Fitness_t, Arg_t, Box_t, _iFun_, _fFun_, Electron, fOpt,
   std::vector<Fitness_t> _record;
 
   inline void __impl_recordFitness() noexcept { _record.emplace_back(this->_atomBestPtr->energy); }
+
+  inline void __impl_saveRecord(std::ostream& os) const noexcept { writeBinary(os, _record); }
+
+  inline bool __impl_loadRecord(std::istream& is) noexcept { return readBinary(is, &_record); }
 };
 
 }  // namespace internal
@@ -42,7 +42,8 @@ requires isBoxConstraint<Box_t>
 class AOSBoxed : public AOSParameterPack<Var_t, Fitness_t, Arg_t>,
                  public AOSParameterPack<Var_t, Fitness_t, Arg_t>::template iFunBody<_iFun_>,
                  public AOSParameterPack<Var_t, Fitness_t, Arg_t>::template fFunBody<_fFun_>,
-                 public Box_t {
+                 public Box_t,
+                 public BatchFitnessBody<Var_t, Fitness_t, Arg_t> {
   using Base_t = AOSParameterPack<Var_t, Fitness_t, Arg_t>;
 
  public:
@@ -87,6 +88,10 @@ class AOSBoxed : public AOSParameterPack<Var_t, Fitness_t, Arg_t>,
 
   inline size_t earlyStopCounter() const noexcept { return _earlyStopCounter; }
 
+  inline size_t evaluationCount() const noexcept { return _termination.evaluations(); }
+
+  inline const SolverProfile& profile() const noexcept { return _profile; }
+
  protected:
   std::list<Electron_t> _electrons;
   std::vector<Layer> _layers;
@@ -96,9 +101,10 @@ class AOSBoxed : public AOSParameterPack<Var_t, Fitness_t, Arg_t>,
   AOSOption _option;
   size_t _generation;
   size_t _earlyStopCounter;
+  TerminationMonitor _termination;
+  SolverProfile _profile;
 
   void __impl_computeFitness() noexcept {
-#ifdef HEU_HAS_OPENMP
     std::vector<Electron_t*> tasks;
     tasks.resize(0);
     tasks.reserve(_electrons.size());
@@ -108,26 +114,32 @@ class AOSBoxed : public AOSParameterPack<Var_t, Fitness_t, Arg_t>,
       }
       tasks.emplace_back(&i);
     }
-    static const int32_t thN = threadNum();
-#pragma omp parallel for schedule(dynamic, tasks.size() / thN)
-    for (int i = 0; i < tasks.size(); i++) {
+    _termination.addEvaluations(tasks.size());
+    _profile.addFitnessCalls(tasks.size());
+
+    if (this->hasBatchfFun()) {
+      std::vector<const Var_t*> vars(tasks.size());
+      std::vector<Fitness_t*> fits(tasks.size());
+      for (size_t i = 0; i < tasks.size(); i++) {
+        vars[i] = &tasks[i]->state;
+        fits[i] = &tasks[i]->energy;
+      }
+      AOSExecutor<>::doBatchFitness(this, vars.data(), fits.data(), tasks.size());
+      for (Electron_t* ptr : tasks) {
+        ptr->isComputed = true;
+      }
+      return;
+    }
+
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(tasks.size()), [&](int i) {
+      RandStreamScope randScope(randRegion, i);
       Electron_t* ptr = tasks[i];
 
       AOSExecutor<>::doFitness(this, &ptr->state, &ptr->energy);
 
       ptr->isComputed = true;
-    }
-#else
-    for (Electron_t& i : _electrons) {
-      if (i.isComputed) {
-        continue;
-      }
-
-      AOSExecutor<>::doFitness(this, &i.self, &i._Fitness);
-
-      i.isComputed = true;
-    }
-#endif  //  HEU_HAS_OPENMP
+    });
   }
 
  protected:
@@ -147,6 +159,11 @@ class AOSBoxed : public AOSParameterPack<Var_t, Fitness_t, Arg_t>,
     static inline void doFitness(const AOSBoxed* solver, const Var_t* v, Fitness_t* f) noexcept {
       solver->runfFun(v, &solver->arg(), f);
     }
+
+    static inline void doBatchFitness(AOSBoxed* solver, const Var_t* const* v, Fitness_t* const* f,
+                                      size_t n) noexcept {
+      solver->runBatchfFun(v, f, n, &solver->arg());
+    }
   };
 
   template <typename unused>
@@ -165,6 +182,11 @@ class AOSBoxed : public AOSParameterPack<Var_t, Fitness_t, Arg_t>,
     static inline void doFitness(const AOSBoxed* solver, const Var_t* v, Fitness_t* f) noexcept {
       solver->runfFun(v, f);
     }
+
+    static inline void doBatchFitness(AOSBoxed* solver, const Var_t* const* v, Fitness_t* const* f,
+                                      size_t n) noexcept {
+      solver->runBatchfFun(v, f, n, nullptr);
+    }
   };
 
   template <FitnessOption fOpt>
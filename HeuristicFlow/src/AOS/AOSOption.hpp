@@ -24,6 +24,7 @@ This file is part of HeuristicFlow.
 #include <stddef.h>
 
 #include "InternalHeaderCheck.h"
+#include <HeuristicFlow/Global>
 
 namespace heu {
 
@@ -43,6 +44,8 @@ struct AOSOption {
   size_t maxEarlyStop;
   size_t maxLayerNum;
   double photonRate;
+  /// Evaluation budget, time limit, target fitness and cancellation. All disabled by default.
+  TerminationCriteria termination;
 };
 
 }  // namespace heu
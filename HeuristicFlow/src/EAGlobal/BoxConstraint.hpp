@@ -37,6 +37,29 @@ class BoxBase {
  public:
   inline void initialize(Var_t* v) const noexcept {
     static_cast<const Derived*>(this)->initializeSize(v);
+    if constexpr (std::is_same_v<Scalar_t, double>) {
+      // fill [0,1) in bulk, then scale into the box
+      randD(v->data(), int(v->size()));
+      if constexpr (array_traits<Var_t>::isEigenClass) {
+        if constexpr (hasVarBounds()) {
+          const auto& minV = static_cast<const Derived*>(this)->min().array();
+          const auto& maxV = static_cast<const Derived*>(this)->max().array();
+          v->array() = v->array() * (maxV - minV) + minV;
+        } else {
+          const Scalar_t minS = static_cast<const Derived*>(this)->min();
+          const Scalar_t maxS = static_cast<const Derived*>(this)->max();
+          v->array() = v->array() * (maxS - minS) + minS;
+        }
+      } else {
+        Scalar_t* const data = v->data();
+        for (int idx = 0; idx < int(v->size()); idx++) {
+          const Scalar_t minS = static_cast<const Derived*>(this)->min(idx);
+          data[idx] = data[idx] * (static_cast<const Derived*>(this)->max(idx) - minS) + minS;
+        }
+      }
+      return;
+    }
+
     for (int idx = 0; idx < v->size(); idx++) {
       if constexpr (std::is_same_v<Scalar_t, bool>) {
         at(*v, idx) = randIdx(2) == 0;
@@ -50,11 +73,32 @@ class BoxBase {
     }
   }
 
+  /**
+   * \brief Clamp the whole decision variable into the box.
+   *
+   * Eigen types are clamped by array expressions, and std containers by a plain loop over the
+   * underlying buffer, so both can be vectorized by the compiler. Booleans are always inside.
+   */
   inline void applyConstraint(Var_t* v) const noexcept {
     assert(v->size() == static_cast<const Derived*>(this)->dimensions());
-    for (int idx = 0; idx < v->size(); idx++) {
-      at(*v, idx) = std::min(at(*v, idx), static_cast<const Derived*>(this)->max(idx));
-      at(*v, idx) = std::max(at(*v, idx), static_cast<const Derived*>(this)->min(idx));
+    if constexpr (std::is_same_v<Scalar_t, bool>) {
+      return;
+    } else if constexpr (array_traits<Var_t>::isEigenClass) {
+      if constexpr (hasVarBounds()) {
+        v->array() = v->array()
+                         .min(static_cast<const Derived*>(this)->max().array())
+                         .max(static_cast<const Derived*>(this)->min().array());
+      } else {
+        v->array() = v->array()
+                         .min(Scalar_t(static_cast<const Derived*>(this)->max()))
+                         .max(Scalar_t(static_cast<const Derived*>(this)->min()));
+      }
+    } else {
+      Scalar_t* const data = v->data();
+      for (int idx = 0; idx < int(v->size()); idx++) {
+        data[idx] = std::max(std::min(data[idx], static_cast<const Derived*>(this)->max(idx)),
+                             static_cast<const Derived*>(this)->min(idx));
+      }
     }
   }
 
@@ -83,6 +127,11 @@ class BoxBase {
   inline void assert4Size([[maybe_unused]] const int idx) const noexcept {
     assert(idx >= 0 && idx < static_cast<const Derived*>(this)->dimensions());
   }
+
+  /// Whether boundaries are stored in decision variables (rectangle boxes) instead of scalars.
+  static constexpr bool hasVarBounds() noexcept {
+    return std::is_same_v<std::decay_t<decltype(std::declval<const Derived&>().min())>, Var_t>;
+  }
 };
 
 ////////////////
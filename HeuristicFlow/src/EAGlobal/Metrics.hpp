@@ -0,0 +1,439 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_METRICS_HPP
+#define HEU_METRICS_HPP
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "InternalHeaderCheck.h"
+#include <HeuristicFlow/Global>
+
+namespace heu {
+
+/**
+ * \ingroup HEU_EAGLOBAL
+ * \class ParetoMetrics
+ * \brief Quality indicators of an approximated Pareto front.
+ *
+ * A front is stored in an `Eigen::Array<double, ObjNum, Eigen::Dynamic>`, one column for each
+ * point. The front doesn't need to be non-dominated, dominated points are ignored by hypervolume.
+ * All indicators are parallelized with `parallel_for`, so they are cheap enough to be computed
+ * every generation in an observer. See `MOGAAbstract::paretoFront` to get the front of a solver.
+ *
+ * Provided indicators:
+ * - Hypervolume: the volume dominated by the front and bounded by a reference point. It's
+ * computed exactly with the WFG algorithm for up to `maxExactObjNum` objectives, and estimated by
+ * Monte Carlo sampling for more.
+ * - IGD and IGD+: average distance from points of a reference front to the front.
+ * - Spread: the generalized spread (Δ) of the front compared with a reference front.
+ *
+ * \tparam ObjNum Number of objectives, Eigen::Dynamic for runtime objs
+ * \tparam fOpt Whether greater or less fitness means better.
+ */
+template <int ObjNum, FitnessOption fOpt = FITNESS_LESS_BETTER>
+class ParetoMetrics {
+  static_assert(ObjNum > 0 || ObjNum == Eigen::Dynamic, "ObjNum should be positive or dynamic(-1)");
+  static_assert(ObjNum != 1, "You assigned 1 objective for multi-objective problem");
+
+ public:
+  /// Type of a point
+  using Fitness_t = Eigen::Array<double, ObjNum, 1>;
+  /// Type of a front, one column for each point
+  using Front_t = Eigen::Array<double, ObjNum, Eigen::Dynamic>;
+
+  /// Hypervolume is computed exactly if there are no more objectives than it.
+  static constexpr int maxExactObjNum = 6;
+
+  /// Default number of samples to estimate hypervolume.
+  static constexpr size_t defaultSampleNum = 1000000;
+
+  /**
+   * \brief Hypervolume of `front` with respect to `refPoint`.
+   *
+   * Exact for up to `maxExactObjNum` objectives, otherwise estimated with `sampleNum` samples.
+   * Points that are not better than `refPoint` on all objectives contribute nothing.
+   */
+  static double hypervolume(const Front_t &front, const Fitness_t &refPoint,
+                            size_t sampleNum = defaultSampleNum) noexcept {
+    if (front.rows() <= maxExactObjNum) {
+      return exactHypervolume(front, refPoint);
+    }
+    return estimateHypervolume(front, refPoint, sampleNum);
+  }
+
+  /**
+   * \brief Exact hypervolume computed by the WFG algorithm.
+   *
+   * Points are sorted by the last objective, so that the exclusive volume of each point is its own
+   * box minus the hypervolume of a limited set of later points. Exclusive volumes of the top level
+   * are computed in parallel. It's exponential to the number of objectives in the worst case, so
+   * prefer `hypervolume` if the number of objectives is large.
+   */
+  static double exactHypervolume(const Front_t &front, const Fitness_t &refPoint) noexcept {
+    const int M = int(front.rows());
+    std::vector<double> boxes;
+    const size_t n = makeBoxes(front, refPoint, &boxes);
+    if (n <= 0) {
+      return 0;
+    }
+    if (M == 2 || n == 1) {
+      std::vector<std::vector<double>> buffers;
+      return wfg(boxes.data(), n, M, 0, &buffers);
+    }
+
+    std::vector<double> exclusive(n);
+    parallel_for(0, int(n), [&](int k) {
+      std::vector<std::vector<double>> buffers(1);
+      const double *box = boxes.data() + size_t(k) * M;
+      const size_t limitNum = limitSet(boxes.data(), n, M, size_t(k), &buffers[0]);
+      exclusive[k] = boxVolume(box, M) - wfg(buffers[0].data(), limitNum, M, 1, &buffers);
+    });
+
+    double volume = 0;
+    for (double v : exclusive) {
+      volume += v;
+    }
+    return volume;
+  }
+
+  /**
+   * \brief Estimate hypervolume by uniform sampling in the bounding box of the front and
+   * `refPoint`.
+   *
+   * Samples are split into chunks, and each chunk draws from its own random stream. So the result
+   * only depends on the random seed, but not on the number of threads.
+   */
+  static double estimateHypervolume(const Front_t &front, const Fitness_t &refPoint,
+                                    size_t sampleNum = defaultSampleNum) noexcept {
+    const int M = int(front.rows());
+    std::vector<double> boxes;
+    const size_t n = makeBoxes(front, refPoint, &boxes);
+    if (n <= 0 || sampleNum <= 0) {
+      return 0;
+    }
+
+    std::vector<double> upper(M, 0.0);
+    for (size_t i = 0; i < n; i++) {
+      for (int o = 0; o < M; o++) {
+        upper[o] = std::max(upper[o], boxes[i * M + o]);
+      }
+    }
+
+    constexpr size_t chunkSize = 4096;
+    const size_t chunkNum = (sampleNum + chunkSize - 1) / chunkSize;
+    std::vector<size_t> hits(chunkNum, 0);
+    const uint64_t randRegion = internal::newRandStreamRegion();
+    parallel_for(0, int(chunkNum), [&](int c) {
+      internal::RandStreamScope randScope(randRegion, c);
+      const size_t begin = size_t(c) * chunkSize;
+      const size_t end = std::min(sampleNum, begin + chunkSize);
+      std::vector<double> sample(M);
+      for (size_t s = begin; s < end; s++) {
+        for (int o = 0; o < M; o++) {
+          sample[o] = randD() * upper[o];
+        }
+        for (size_t i = 0; i < n; i++) {
+          if (isWeakDominate(boxes.data() + i * M, sample.data(), M)) {
+            hits[c]++;
+            break;
+          }
+        }
+      }
+    });
+
+    size_t hitNum = 0;
+    for (size_t h : hits) {
+      hitNum += h;
+    }
+    return boxVolume(upper.data(), M) * double(hitNum) / double(sampleNum);
+  }
+
+  /**
+   * \brief Inverted generational distance: the average Euclidean distance from each point of
+   * `refFront` to its nearest point in `front`.
+   */
+  static double IGD(const Front_t &front, const Front_t &refFront) noexcept {
+    return averageDistance<false>(front, refFront);
+  }
+
+  /**
+   * \brief IGD+: like IGD, but only objectives on which a point of `front` is worse than the
+   * reference point are counted. It's weakly Pareto compliant, unlike IGD.
+   */
+  static double IGDPlus(const Front_t &front, const Front_t &refFront) noexcept {
+    return averageDistance<true>(front, refFront);
+  }
+
+  /**
+   * \brief Generalized spread (Δ) of `front`.
+   *
+   * It's `(Σd(e_m) + Σ|d_i - d̄|) / (Σd(e_m) + N*d̄)`, where `d(e_m)` is the distance from the
+   * extreme point of `refFront` on objective `m` to `front`, and `d_i` is the distance from the
+   * i-th point to its nearest neighbor in `front`. 0 means the front is evenly distributed and
+   * reaches all extremes. It's 1 if there are less than 2 points in `front`.
+   */
+  static double spread(const Front_t &front, const Front_t &refFront) noexcept {
+    const size_t N = front.cols();
+    if (N < 2 || refFront.cols() <= 0) {
+      return 1;
+    }
+    const int M = int(front.rows());
+
+    std::vector<double> nearest(N);
+    parallel_for(0, int(N), [&](int i) {
+      double minDist = internal::pinfD;
+      for (size_t j = 0; j < N; j++) {
+        if (size_t(i) != j) {
+          minDist = std::min(minDist, (front.col(i) - front.col(j)).matrix().norm());
+        }
+      }
+      nearest[i] = minDist;
+    });
+
+    double extremeDist = 0;
+    for (int o = 0; o < M; o++) {
+      // the extreme point is the worst point on objective o, which is the best on the others
+      Eigen::Index extremeIdx = 0;
+      if constexpr (fOpt == FITNESS_LESS_BETTER) {
+        refFront.row(o).maxCoeff(&extremeIdx);
+      } else {
+        refFront.row(o).minCoeff(&extremeIdx);
+      }
+      extremeDist +=
+          (front.colwise() - refFront.col(extremeIdx)).matrix().colwise().norm().minCoeff();
+    }
+
+    double mean = 0;
+    for (double d : nearest) {
+      mean += d;
+    }
+    mean /= N;
+
+    double deviation = 0;
+    for (double d : nearest) {
+      deviation += std::abs(d - mean);
+    }
+
+    const double denominator = extremeDist + N * mean;
+    if (denominator <= 0) {
+      return 0;
+    }
+    return (extremeDist + deviation) / denominator;
+  }
+
+ private:
+  /**
+   * \brief Transform points into boxes anchored at the origin in a space where greater is better,
+   * drop points that don't dominate `refPoint` and points that are dominated by others, and sort
+   * them by the last objective in descending order.
+   *
+   * \return Number of boxes. Each box takes M doubles in `boxes`.
+   */
+  static size_t makeBoxes(const Front_t &front, const Fitness_t &refPoint,
+                          std::vector<double> *boxes) noexcept {
+    const int M = int(front.rows());
+    assert(refPoint.size() == M);
+    std::vector<double> candidates;
+    candidates.reserve(front.size());
+    size_t n = 0;
+    for (Eigen::Index c = 0; c < front.cols(); c++) {
+      bool isInside = true;
+      for (int o = 0; o < M; o++) {
+        const double x = (fOpt == FITNESS_LESS_BETTER) ? (refPoint[o] - front(o, c))
+                                                        : (front(o, c) - refPoint[o]);
+        isInside = isInside && (x > 0);
+        candidates.emplace_back(x);
+      }
+      if (isInside) {
+        n++;
+      } else {
+        candidates.resize(candidates.size() - M);
+      }
+    }
+
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      for (int o = M - 1; o >= 0; o--) {
+        if (candidates[a * M + o] != candidates[b * M + o]) {
+          return candidates[a * M + o] > candidates[b * M + o];
+        }
+      }
+      return false;
+    });
+
+    boxes->clear();
+    boxes->reserve(n * M);
+    size_t kept = 0;
+    for (size_t i : order) {
+      appendNonDominated(candidates.data() + i * M, M, boxes, &kept);
+    }
+    return kept;
+  }
+
+  static inline double boxVolume(const double *box, const int M) noexcept {
+    double v = 1;
+    for (int o = 0; o < M; o++) {
+      v *= box[o];
+    }
+    return v;
+  }
+
+  /// Whether box a contains box b
+  static inline bool isWeakDominate(const double *a, const double *b, const int M) noexcept {
+    for (int o = 0; o < M; o++) {
+      if (a[o] < b[o]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * \brief Append a box to a non-dominated set that is sorted by the last objective in descending
+   * order. Boxes in the set that are contained by the new one are removed.
+   */
+  static void appendNonDominated(const double *box, const int M, std::vector<double> *set,
+                                 size_t *n) noexcept {
+    for (size_t i = 0; i < *n; i++) {
+      if (isWeakDominate(set->data() + i * M, box, M)) {
+        return;
+      }
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < *n; i++) {
+      if (!isWeakDominate(box, set->data() + i * M, M)) {
+        std::copy_n(set->data() + i * M, M, set->data() + kept * M);
+        kept++;
+      }
+    }
+    set->resize(kept * M);
+    set->insert(set->end(), box, box + M);
+    *n = kept + 1;
+  }
+
+  /**
+   * \brief Boxes after the k-th one, limited by the k-th box and reduced to a non-dominated set.
+   *
+   * \return Number of boxes in `dst`.
+   */
+  static size_t limitSet(const double *boxes, const size_t n, const int M, const size_t k,
+                         std::vector<double> *dst) noexcept {
+    dst->clear();
+    size_t num = 0;
+    Fitness_t limited(M);
+    for (size_t i = k + 1; i < n; i++) {
+      for (int o = 0; o < M; o++) {
+        limited[o] = std::min(boxes[k * M + o], boxes[i * M + o]);
+      }
+      appendNonDominated(limited.data(), M, dst, &num);
+    }
+    return num;
+  }
+
+  /// Area of a non-dominated set of 2d boxes sorted by objective 1 in descending order.
+  static double sweep2D(const double *boxes, const size_t n) noexcept {
+    double area = 0;
+    double prevX0 = 0;
+    // objective 0 increases while objective 1 decreases along the set
+    for (size_t i = 0; i < n; i++) {
+      area += (boxes[i * 2] - prevX0) * boxes[i * 2 + 1];
+      prevX0 = boxes[i * 2];
+    }
+    return area;
+  }
+
+  /**
+   * \brief Hypervolume of a non-dominated set of boxes sorted by the last objective in descending
+   * order.
+   *
+   * \param buffers Buffers of limit sets, one for each depth of recursion.
+   */
+  static double wfg(const double *boxes, const size_t n, const int M, const size_t depth,
+                    std::vector<std::vector<double>> *buffers) noexcept {
+    if (n <= 0) {
+      return 0;
+    }
+    if (n == 1) {
+      return boxVolume(boxes, M);
+    }
+    if (M == 2) {
+      return sweep2D(boxes, n);
+    }
+    if (buffers->size() <= depth) {
+      buffers->resize(depth + 1);
+    }
+
+    double volume = 0;
+    for (size_t k = 0; k < n; k++) {
+      const size_t limitNum = limitSet(boxes, n, M, k, &(*buffers)[depth]);
+      // the buffer of this depth is reused by the next k, so it's consumed before that
+      volume += boxVolume(boxes + k * M, M) -
+                wfg((*buffers)[depth].data(), limitNum, M, depth + 1, buffers);
+    }
+    return volume;
+  }
+
+  template <bool isPlus>
+  static double averageDistance(const Front_t &front, const Front_t &refFront) noexcept {
+    const size_t R = refFront.cols();
+    if (R <= 0) {
+      return 0;
+    }
+    if (front.cols() <= 0) {
+      return internal::pinfD;
+    }
+
+    std::vector<double> distance(R);
+    parallel_for(0, int(R), [&](int r) {
+      double minSquared = internal::pinfD;
+      for (Eigen::Index c = 0; c < front.cols(); c++) {
+        double squared;
+        if constexpr (isPlus) {
+          // only objectives on which the point is worse than the reference point are counted
+          if constexpr (fOpt == FITNESS_LESS_BETTER) {
+            squared = (front.col(c) - refFront.col(r)).max(0.0).square().sum();
+          } else {
+            squared = (refFront.col(r) - front.col(c)).max(0.0).square().sum();
+          }
+        } else {
+          squared = (front.col(c) - refFront.col(r)).square().sum();
+        }
+        minSquared = std::min(minSquared, squared);
+      }
+      distance[r] = std::sqrt(minSquared);
+    });
+
+    double sum = 0;
+    for (double d : distance) {
+      sum += d;
+    }
+    return sum / R;
+  }
+};
+
+}  //  namespace heu
+
+#endif  //  HEU_METRICS_HPP
@@ -0,0 +1,430 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_NONDOMINATEDSORTING_HPP
+#define HEU_NONDOMINATEDSORTING_HPP
+
+#include <stdint.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "InternalHeaderCheck.h"
+#include <HeuristicFlow/Global>
+
+namespace heu {
+
+/**
+ * \ingroup HEU_EAGLOBAL
+ * \brief Algorithms to divide a set of points into non-dominated layers (Pareto ranks).
+ *
+ */
+enum NDSortMethod {
+  /// Deb's fast non-dominated sorting with domination lists. O(MN^2) comparisons, parallelized.
+  FAST_NONDOMINATED_SORT,
+  /// Sweep line algorithm for 2 objectives. O(NlogN).
+  SWEEP_2D,
+  /// Divide and conquer algorithm by Jensen, generalized by Fortin and Buzdalov. O(Nlog^{M-1}N).
+  DIVIDE_AND_CONQUER
+};
+
+namespace internal {
+
+/**
+ * \ingroup HEU_EAGLOBAL
+ * \brief The default NDSortMethod for a number of objectives. `SWEEP_2D` is used for 2
+ * objectives and `DIVIDE_AND_CONQUER` for others.
+ *
+ * \tparam ObjNum Number of objectives, Eigen::Dynamic for runtime objs
+ */
+template <int ObjNum>
+constexpr NDSortMethod defaultNDSortMethod =
+    (ObjNum == 2) ? (NDSortMethod::SWEEP_2D) : (NDSortMethod::DIVIDE_AND_CONQUER);
+
+/**
+ * \ingroup HEU_EAGLOBAL
+ * \class NDSorter
+ * \brief Non-dominated sorting engine.
+ *
+ * It computes the Pareto rank of each point : points that are not dominated by any other point
+ * have rank 0, and points that are only dominated by points with rank less than or equal to `r`
+ * have rank `r+1`. Identical points always have the same rank.
+ *
+ * The engine keeps its buffers as members, so reusing the same object across generations avoids
+ * reallocating memory.
+ *
+ * \tparam ObjNum Number of objectives, Eigen::Dynamic for runtime objs
+ * \tparam fOpt Whether greater or less fitness means better.
+ * \tparam method The sorting algorithm.
+ */
+template <int ObjNum, FitnessOption fOpt, NDSortMethod method = defaultNDSortMethod<ObjNum>>
+class NDSorter {
+  static_assert(ObjNum > 0 || ObjNum == Eigen::Dynamic, "ObjNum should be positive or dynamic(-1)");
+  static_assert(ObjNum != 1, "You assigned 1 objective for multi-objective problem");
+  static_assert(method != NDSortMethod::SWEEP_2D || ObjNum == 2,
+                "SWEEP_2D is only applicable for 2 objectives");
+
+ public:
+  using Fitness_t = Eigen::Array<double, ObjNum, 1>;
+
+  /**
+   * \brief Compute the Pareto rank of each fitness value.
+   *
+   * \param fitnesses Pointers to `N` fitness values
+   * \param N Number of fitness values
+   * \param ranks Output. `ranks[i]` is the rank of `*fitnesses[i]`
+   * \return size_t Number of non-dominated layers
+   */
+  size_t sort(const Fitness_t *const *fitnesses, const size_t N, size_t *ranks) noexcept {
+    if (N <= 0) {
+      return 0;
+    }
+    loadPoints(fitnesses, N);
+
+    if constexpr (method == NDSortMethod::FAST_NONDOMINATED_SORT) {
+      return fastNDSort(ranks);
+    } else {
+      sortAndMergeDuplicates();
+      if constexpr (method == NDSortMethod::SWEEP_2D) {
+        sweep2D();
+      } else {
+        std::vector<uint32_t> all(_rank.size());
+        for (size_t i = 0; i < all.size(); i++) {
+          all[i] = i;
+        }
+        helperA(all, _objNum - 1);
+      }
+
+      size_t layerNum = 0;
+      for (size_t i = 0; i < N; i++) {
+        ranks[i] = _rank[_uniqueOf[i]];
+        layerNum = std::max(layerNum, ranks[i] + 1);
+      }
+      return layerNum;
+    }
+  }
+
+ private:
+  using Points_t = Eigen::Array<double, ObjNum, Eigen::Dynamic>;
+
+  int _objNum;       ///< Number of objectives
+  Points_t _points;  ///< Each col is a point. Objectives are negated if greater is better.
+  Points_t _sorted;  ///< Unique points in lexicographic order
+  std::vector<uint32_t> _order;     ///< Indexes of points in lexicographic order
+  std::vector<uint32_t> _uniqueOf;  ///< The index in `_sorted` for each point
+  std::vector<size_t> _rank;        ///< Rank of each unique point
+  std::vector<double> _medianSpace;
+  std::map<double, size_t> _stairs;  ///< Staircase used by sweeps, maps objective 1 to rank
+
+  void loadPoints(const Fitness_t *const *fitnesses, const size_t N) noexcept {
+    _objNum = fitnesses[0]->size();
+    _points.resize(_objNum, N);
+    for (size_t i = 0; i < N; i++) {
+      if constexpr (fOpt == FITNESS_GREATER_BETTER) {
+        _points.col(i) = -*fitnesses[i];
+      } else {
+        _points.col(i) = *fitnesses[i];
+      }
+    }
+  }
+
+  /// Weakly dominate on objectives in range [0,k]
+  template <class A_t, class B_t>
+  inline bool isWeakDominate(const A_t &a, const B_t &b, const int k) const noexcept {
+    for (int o = 0; o <= k; o++) {
+      if (a[o] > b[o]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t fastNDSort(size_t *ranks) noexcept {
+    const size_t N = _points.cols();
+    std::vector<std::vector<uint32_t>> dominateList(N);
+    std::vector<size_t> dominatedNum(N, 0);
+
+    parallel_for(0, int(N), [&](int i) {
+      for (size_t j = 0; j < N; j++) {
+        if (size_t(i) == j) {
+          continue;
+        }
+        const bool iNotWorse = (_points.col(i) <= _points.col(j)).all();
+        const bool jNotWorse = (_points.col(j) <= _points.col(i)).all();
+        if (iNotWorse && !jNotWorse) {
+          dominateList[i].emplace_back(j);
+        } else if (jNotWorse && !iNotWorse) {
+          dominatedNum[i]++;
+        }
+      }
+    });
+
+    std::vector<uint32_t> curLayer, nextLayer;
+    curLayer.reserve(N);
+    nextLayer.reserve(N);
+    for (size_t i = 0; i < N; i++) {
+      if (dominatedNum[i] <= 0) {
+        curLayer.emplace_back(i);
+      }
+    }
+
+    size_t layerNum = 0;
+    while (!curLayer.empty()) {
+      for (uint32_t i : curLayer) {
+        ranks[i] = layerNum;
+        for (uint32_t j : dominateList[i]) {
+          dominatedNum[j]--;
+          if (dominatedNum[j] <= 0) {
+            nextLayer.emplace_back(j);
+          }
+        }
+      }
+      layerNum++;
+      std::swap(curLayer, nextLayer);
+      nextLayer.clear();
+    }
+    return layerNum;
+  }
+
+  /// Sort points lexicographically and merge identical points, since they always share a rank.
+  void sortAndMergeDuplicates() noexcept {
+    const size_t N = _points.cols();
+    _order.resize(N);
+    for (size_t i = 0; i < N; i++) {
+      _order[i] = i;
+    }
+    std::sort(_order.begin(), _order.end(), [this](uint32_t a, uint32_t b) {
+      for (int o = 0; o < _objNum; o++) {
+        if (_points(o, a) != _points(o, b)) {
+          return _points(o, a) < _points(o, b);
+        }
+      }
+      return false;
+    });
+
+    _sorted.resize(_objNum, N);
+    _uniqueOf.resize(N);
+    size_t uniqueNum = 0;
+    for (size_t i = 0; i < N; i++) {
+      if (i <= 0 || (_points.col(_order[i]) != _sorted.col(uniqueNum - 1)).any()) {
+        _sorted.col(uniqueNum) = _points.col(_order[i]);
+        uniqueNum++;
+      }
+      _uniqueOf[_order[i]] = uniqueNum - 1;
+    }
+    _sorted.conservativeResize(_objNum, uniqueNum);
+    _rank.assign(uniqueNum, 0);
+  }
+
+  void sweep2D() noexcept {
+    // minObj1[r] is the minimum value of objective 1 among points in layer r.
+    std::vector<double> &minObj1 = _medianSpace;
+    minObj1.clear();
+    for (size_t p = 0; p < _rank.size(); p++) {
+      const double f1 = _sorted(1, p);
+      auto it = std::upper_bound(minObj1.begin(), minObj1.end(), f1);
+      _rank[p] = it - minObj1.begin();
+      if (it == minObj1.end()) {
+        minObj1.emplace_back(f1);
+      } else {
+        *it = f1;
+      }
+    }
+  }
+
+  /// The maximum rank among points in staircase whose objective 1 is not greater than `f1`, plus 1
+  inline size_t stairsQuery(const double f1) const noexcept {
+    auto it = _stairs.upper_bound(f1);
+    if (it == _stairs.begin()) {
+      return 0;
+    }
+    return std::prev(it)->second + 1;
+  }
+
+  inline void stairsInsert(const double f1, const size_t rank) noexcept {
+    if (stairsQuery(f1) > rank) {
+      return;
+    }
+    auto it = _stairs.lower_bound(f1);
+    while (it != _stairs.end() && it->second <= rank) {
+      it = _stairs.erase(it);
+    }
+    _stairs.emplace_hint(it, f1, rank);
+  }
+
+  /// Compute ranks inside S, considering objectives in range [0,1].
+  void sweepA(const std::vector<uint32_t> &S) noexcept {
+    _stairs.clear();
+    for (uint32_t p : S) {
+      _rank[p] = std::max(_rank[p], stairsQuery(_sorted(1, p)));
+      stairsInsert(_sorted(1, p), _rank[p]);
+    }
+  }
+
+  /// Update ranks of H with L, considering objectives in range [0,1].
+  void sweepB(const std::vector<uint32_t> &L, const std::vector<uint32_t> &H) noexcept {
+    _stairs.clear();
+    size_t li = 0;
+    for (uint32_t h : H) {
+      for (; li < L.size() && L[li] < h; li++) {
+        stairsInsert(_sorted(1, L[li]), _rank[L[li]]);
+      }
+      _rank[h] = std::max(_rank[h], stairsQuery(_sorted(1, h)));
+    }
+  }
+
+  double median(const std::vector<uint32_t> &A, const std::vector<uint32_t> &B,
+                const int k) noexcept {
+    _medianSpace.clear();
+    for (uint32_t p : A) {
+      _medianSpace.emplace_back(_sorted(k, p));
+    }
+    for (uint32_t p : B) {
+      _medianSpace.emplace_back(_sorted(k, p));
+    }
+    auto mid = _medianSpace.begin() + _medianSpace.size() / 2;
+    std::nth_element(_medianSpace.begin(), mid, _medianSpace.end());
+    return *mid;
+  }
+
+  /// Split S into points less than, equal to and greater than m on objective k. Order is kept.
+  void split(const std::vector<uint32_t> &S, const double m, const int k, std::vector<uint32_t> *L,
+             std::vector<uint32_t> *M, std::vector<uint32_t> *H) const noexcept {
+    for (uint32_t p : S) {
+      if (_sorted(k, p) < m) {
+        L->emplace_back(p);
+      } else if (_sorted(k, p) > m) {
+        H->emplace_back(p);
+      } else {
+        M->emplace_back(p);
+      }
+    }
+  }
+
+  static std::vector<uint32_t> merge(const std::vector<uint32_t> &A,
+                                     const std::vector<uint32_t> &B) noexcept {
+    std::vector<uint32_t> result(A.size() + B.size());
+    std::merge(A.begin(), A.end(), B.begin(), B.end(), result.begin());
+    return result;
+  }
+
+  /**
+   * \brief Compute ranks inside S, considering objectives in range [0,k]. All points in S are equal
+   * on objectives greater than k.
+   */
+  void helperA(const std::vector<uint32_t> &S, const int k) noexcept {
+    if (S.size() < 2) {
+      return;
+    }
+    if (S.size() == 2) {
+      if (isWeakDominate(_sorted.col(S[0]), _sorted.col(S[1]), k)) {
+        _rank[S[1]] = std::max(_rank[S[1]], _rank[S[0]] + 1);
+      }
+      return;
+    }
+    if (k == 1) {
+      sweepA(S);
+      return;
+    }
+
+    bool isAllSame = true;
+    for (uint32_t p : S) {
+      if (_sorted(k, p) != _sorted(k, S.front())) {
+        isAllSame = false;
+        break;
+      }
+    }
+    if (isAllSame) {
+      helperA(S, k - 1);
+      return;
+    }
+
+    const double m = median(S, {}, k);
+    std::vector<uint32_t> L, M, H;
+    split(S, m, k, &L, &M, &H);
+
+    helperA(L, k);
+    helperB(L, M, k - 1);
+    helperA(M, k - 1);
+    helperB(merge(L, M), H, k - 1);
+    helperA(H, k);
+  }
+
+  /**
+   * \brief Update ranks of H with L, considering objectives in range [0,k]. Ranks of L must have
+   * been computed, and every point in L is not worse than any point in H on objectives greater than
+   * k.
+   */
+  void helperB(const std::vector<uint32_t> &L, const std::vector<uint32_t> &H,
+               const int k) noexcept {
+    if (L.empty() || H.empty()) {
+      return;
+    }
+    if (L.size() == 1 || H.size() == 1) {
+      for (uint32_t h : H) {
+        for (uint32_t l : L) {
+          if (isWeakDominate(_sorted.col(l), _sorted.col(h), k)) {
+            _rank[h] = std::max(_rank[h], _rank[l] + 1);
+          }
+        }
+      }
+      return;
+    }
+    if (k == 1) {
+      sweepB(L, H);
+      return;
+    }
+
+    double minL = _sorted(k, L.front()), maxL = minL;
+    for (uint32_t l : L) {
+      minL = std::min(minL, _sorted(k, l));
+      maxL = std::max(maxL, _sorted(k, l));
+    }
+    double minH = _sorted(k, H.front()), maxH = minH;
+    for (uint32_t h : H) {
+      minH = std::min(minH, _sorted(k, h));
+      maxH = std::max(maxH, _sorted(k, h));
+    }
+
+    if (maxL <= minH) {
+      helperB(L, H, k - 1);
+      return;
+    }
+    if (minL > maxH) {
+      return;
+    }
+
+    const double m = median(L, H, k);
+    std::vector<uint32_t> L1, M1, H1, L2, M2, H2;
+    split(L, m, k, &L1, &M1, &H1);
+    split(H, m, k, &L2, &M2, &H2);
+
+    helperB(L1, L2, k);
+    helperB(L1, M2, k - 1);
+    helperB(M1, M2, k - 1);
+    helperB(merge(L1, M1), H2, k - 1);
+    helperB(H1, H2, k);
+  }
+};
+
+}  //  namespace internal
+
+}  //  namespace heu
+
+#endif  //  HEU_NONDOMINATEDSORTING_HPP
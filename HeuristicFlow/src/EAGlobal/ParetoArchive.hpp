@@ -0,0 +1,538 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_PARETOARCHIVE_HPP
+#define HEU_PARETOARCHIVE_HPP
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include "InternalHeaderCheck.h"
+#include <HeuristicFlow/Global>
+
+namespace heu {
+
+/**
+ * \ingroup HEU_EAGLOBAL
+ * \class ParetoArchive
+ * \brief An external archive of non-dominated solutions.
+ *
+ * Each accepted solution is copied into the archive, and it stays there until a new solution
+ * dominates it, or it's pruned to keep the size within `capacity()`. So unlike the PF of a solver,
+ * good trade-offs found in early generations are not lost when they are selected out.
+ *
+ * Solutions are indexed by an ND-tree. Each node of the tree keeps an approximated ideal and nadir
+ * point of the solutions below it, so that the dominance check of an insertion skips every
+ * subtree that can neither dominate nor be dominated by the new point. For a front of N points,
+ * an insertion usually visits O(log N) nodes.
+ *
+ * When the archive is full, the solution with the least crowding distance is removed, so the
+ * archive keeps the extreme points and spreads the rest evenly. A bounded archive keeps its
+ * solutions sorted on each objective, so the crowding distance is computed without sorting.
+ *
+ * Solutions are stored contiguously, `entries()` exposes them without copying. The order of
+ * entries changes when a solution is removed.
+ *
+ * \tparam Var_t Type of decision variable
+ * \tparam ObjNum Number of objectives, Eigen::Dynamic for runtime objs
+ * \tparam fOpt Whether greater or less fitness means better.
+ */
+template <typename Var_t, int ObjNum, FitnessOption fOpt = FITNESS_LESS_BETTER>
+class ParetoArchive {
+  static_assert(ObjNum > 0 || ObjNum == Eigen::Dynamic, "ObjNum should be positive or dynamic(-1)");
+  static_assert(ObjNum != 1, "You assigned 1 objective for multi-objective problem");
+
+ public:
+  /// Type of fitness
+  using Fitness_t = Eigen::Array<double, ObjNum, 1>;
+  /// Type of a front, one column for each point
+  using Front_t = Eigen::Array<double, ObjNum, Eigen::Dynamic>;
+
+  /**
+   * \brief A solution in the archive
+   */
+  struct Entry {
+    Var_t decision_variable;  ///< Decision variable
+    Fitness_t fitness;        ///< Fitness value
+  };
+
+  /// Default maximum number of solutions in a leaf of the ND-tree
+  static constexpr size_t defaultLeafSize = 20;
+
+  /**
+   * \brief Construct an empty archive.
+   *
+   * \param capacity Maximum number of solutions. 0 means unbounded.
+   * \param leafSize Maximum number of solutions in a leaf, a leaf is split when it's exceeded.
+   */
+  explicit ParetoArchive(size_t capacity = 0, size_t leafSize = defaultLeafSize) noexcept
+      : _capacity(capacity), _leafSize(std::max<size_t>(leafSize, 2)) {}
+
+  /// Number of solutions in the archive
+  inline size_t size() const noexcept { return _entries.size(); }
+
+  /// Whether the archive is empty
+  inline bool empty() const noexcept { return _entries.empty(); }
+
+  /// Maximum number of solutions, 0 means unbounded
+  inline size_t capacity() const noexcept { return _capacity; }
+
+  /**
+   * \brief Set the maximum number of solutions. Solutions with least crowding distance are
+   * removed if there are more.
+   *
+   * \param capacity The new capacity, 0 means unbounded.
+   */
+  inline void setCapacity(size_t capacity) noexcept {
+    _capacity = capacity;
+    _sortedByObj.clear();
+    for (size_t idx = 0; idx < _entries.size(); idx++) {
+      addToSorted(idx);
+    }
+    truncate();
+  }
+
+  /// Maximum number of solutions in a leaf of the ND-tree
+  inline size_t leafSize() const noexcept { return _leafSize; }
+
+  /// Set the maximum number of solutions in a leaf. It takes effect when leaves are split.
+  inline void setLeafSize(size_t leafSize) noexcept { _leafSize = std::max<size_t>(leafSize, 2); }
+
+  /// Remove all solutions.
+  inline void clear() noexcept {
+    _entries.clear();
+    _keys.clear();
+    _leafOf.clear();
+    _nodes.clear();
+    _freeNodes.clear();
+    _sortedByObj.clear();
+    _root = npos;
+  }
+
+  /// All solutions in the archive
+  inline const std::vector<Entry>& entries() const noexcept { return _entries; }
+
+  /// The i-th solution in the archive
+  inline const Entry& operator[](size_t i) const noexcept {
+    assert(i < _entries.size());
+    return _entries[i];
+  }
+
+  /**
+   * \brief Get fitness values of all solutions as a matrix, one column for each solution. It's the
+   * layout used by ParetoMetrics.
+   */
+  inline void paretoFront(Front_t& front) const noexcept {
+    if (_entries.empty()) {
+      front.resize(ObjNum == Eigen::Dynamic ? front.rows() : ObjNum, 0);
+      return;
+    }
+    front.resize(_entries.front().fitness.rows(), _entries.size());
+    for (size_t i = 0; i < _entries.size(); i++) {
+      front.col(i) = _entries[i].fitness;
+    }
+  }
+
+  /**
+   * \brief Whether `f` is weakly dominated by any solution in the archive, i.e. whether `insert`
+   * would reject it.
+   */
+  inline bool isDominated(const Fitness_t& f) const noexcept {
+    if (_root == npos) {
+      return false;
+    }
+    return !checkNode(_root, toKey(f), nullptr);
+  }
+
+  /**
+   * \brief Try to insert a solution.
+   *
+   * The solution is rejected if it's weakly dominated by any solution in the archive. Otherwise
+   * solutions dominated by it are removed, and it's copied into the archive. Then the solution with
+   * least crowding distance is removed if the capacity is exceeded, which may be the new one.
+   *
+   * \return true The solution is non-dominated and was added.
+   * \return false The solution is rejected.
+   */
+  bool insert(const Var_t& v, const Fitness_t& f) noexcept {
+    const Fitness_t key = toKey(f);
+    if (_root != npos) {
+      std::vector<size_t> dominated;
+      if (!checkNode(_root, key, &dominated)) {
+        return false;
+      }
+      // removing from back to front, so that indices of the rest are not changed by swapping
+      std::sort(dominated.begin(), dominated.end(), std::greater<size_t>());
+      for (size_t idx : dominated) {
+        removeEntry(idx);
+      }
+    }
+
+    _entries.emplace_back(Entry{v, f});
+    _keys.emplace_back(key);
+    _leafOf.emplace_back(npos);
+    addToSorted(_entries.size() - 1);
+    if (_root == npos) {
+      _root = newNode(npos, true);
+      _nodes[_root].ideal = key;
+      _nodes[_root].nadir = key;
+    }
+    insertToNode(_root, _entries.size() - 1);
+
+    truncate();
+    return true;
+  }
+
+ protected:
+  static constexpr size_t npos = SIZE_MAX;
+
+  /**
+   * \brief A node of the ND-tree.
+   *
+   * `items` are indices of children for internal nodes, or indices of entries for leaves.
+   */
+  struct Node {
+    Fitness_t ideal;
+    Fitness_t nadir;
+    size_t parent;
+    bool isLeaf;
+    std::vector<size_t> items;
+  };
+
+  size_t _capacity;
+  size_t _leafSize;
+  std::vector<Entry> _entries;
+  /// Fitness of each entry, negated if greater is better so that less is always better.
+  std::vector<Fitness_t> _keys;
+  /// The leaf that holds each entry
+  std::vector<size_t> _leafOf;
+  std::vector<Node> _nodes;
+  std::vector<size_t> _freeNodes;
+  /// Indices of entries sorted on each objective. It's maintained only if the archive is bounded.
+  std::vector<std::vector<size_t>> _sortedByObj;
+  size_t _root{npos};
+
+  static inline Fitness_t toKey(const Fitness_t& f) noexcept {
+    if (fOpt == FITNESS_GREATER_BETTER) {
+      return -f;
+    }
+    return f;
+  }
+
+  static inline bool isWeakDominate(const Fitness_t& a, const Fitness_t& b) noexcept {
+    return (a <= b).all();
+  }
+
+  static inline bool isStrongDominate(const Fitness_t& a, const Fitness_t& b) noexcept {
+    return (a <= b).all() && (a < b).any();
+  }
+
+  /**
+   * \brief Check `key` against the subtree of `n`.
+   *
+   * \param dominated Indices of entries dominated by `key` are appended to it. Ignored if null.
+   * \return false if `key` is weakly dominated by an entry in the subtree.
+   */
+  bool checkNode(size_t n, const Fitness_t& key, std::vector<size_t>* dominated) const noexcept {
+    const Node& node = _nodes[n];
+    if (isWeakDominate(node.nadir, key)) {
+      return false;
+    }
+    if (isStrongDominate(key, node.ideal)) {
+      if (dominated != nullptr) {
+        collectEntries(n, dominated);
+      }
+      return true;
+    }
+    if (!isWeakDominate(node.ideal, key) && !isWeakDominate(key, node.nadir)) {
+      // no entry in this subtree can dominate or be dominated by key
+      return true;
+    }
+
+    if (!node.isLeaf) {
+      for (size_t c : node.items) {
+        if (!checkNode(c, key, dominated)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    for (size_t idx : node.items) {
+      if (isWeakDominate(_keys[idx], key)) {
+        return false;
+      }
+      if (dominated != nullptr && isWeakDominate(key, _keys[idx])) {
+        dominated->emplace_back(idx);
+      }
+    }
+    return true;
+  }
+
+  void collectEntries(size_t n, std::vector<size_t>* dst) const noexcept {
+    const Node& node = _nodes[n];
+    if (node.isLeaf) {
+      dst->insert(dst->end(), node.items.begin(), node.items.end());
+      return;
+    }
+    for (size_t c : node.items) {
+      collectEntries(c, dst);
+    }
+  }
+
+  size_t newNode(size_t parent, bool isLeaf) noexcept {
+    size_t n;
+    if (_freeNodes.empty()) {
+      n = _nodes.size();
+      _nodes.emplace_back();
+    } else {
+      n = _freeNodes.back();
+      _freeNodes.pop_back();
+    }
+    _nodes[n].parent = parent;
+    _nodes[n].isLeaf = isLeaf;
+    _nodes[n].items.clear();
+    return n;
+  }
+
+  inline void freeNode(size_t n) noexcept {
+    _nodes[n].items.clear();
+    _freeNodes.emplace_back(n);
+  }
+
+  void addToSorted(size_t idx) noexcept {
+    if (_capacity <= 0) {
+      return;
+    }
+    const Fitness_t& key = _keys[idx];
+    _sortedByObj.resize(key.rows());
+    for (int o = 0; o < int(key.rows()); o++) {
+      std::vector<size_t>& sorted = _sortedByObj[o];
+      auto it = std::upper_bound(sorted.begin(), sorted.end(), key[o],
+                                 [this, o](double v, size_t i) { return v < _keys[i][o]; });
+      sorted.insert(it, idx);
+    }
+  }
+
+  /// Position of entry `idx` in the sorted indices of objective `o`
+  std::vector<size_t>::iterator findSorted(int o, size_t idx) noexcept {
+    std::vector<size_t>& sorted = _sortedByObj[o];
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), _keys[idx][o],
+                               [this, o](size_t i, double v) { return _keys[i][o] < v; });
+    it = std::find(it, sorted.end(), idx);
+    assert(it != sorted.end());
+    return it;
+  }
+
+  /// Descend to the leaf whose middle point is closest to the new entry, and add it there.
+  void insertToNode(size_t n, size_t idx) noexcept {
+    const Fitness_t& key = _keys[idx];
+    while (true) {
+      Node& node = _nodes[n];
+      node.ideal = node.ideal.min(key);
+      node.nadir = node.nadir.max(key);
+      if (node.isLeaf) {
+        break;
+      }
+      size_t best = node.items.front();
+      double bestDist = internal::pinfD;
+      for (size_t c : node.items) {
+        const double dist = ((_nodes[c].ideal + _nodes[c].nadir) / 2 - key).square().sum();
+        if (dist < bestDist) {
+          bestDist = dist;
+          best = c;
+        }
+      }
+      n = best;
+    }
+
+    _nodes[n].items.emplace_back(idx);
+    _leafOf[idx] = n;
+    if (_nodes[n].items.size() > _leafSize) {
+      split(n);
+    }
+  }
+
+  /**
+   * \brief Split a leaf into (ObjNum+1) children.
+   *
+   * Seeds of the children are selected one by one, each time the entry farthest in average from
+   * the selected seeds (or from all others for the first one). Other entries join the child of
+   * the closest seed.
+   */
+  void split(size_t n) noexcept {
+    std::vector<size_t> pts = std::move(_nodes[n].items);
+    const size_t ptNum = pts.size();
+    const size_t childNum = std::min<size_t>(_keys[pts.front()].rows() + 1, ptNum);
+
+    std::vector<double> distSum(ptNum, 0);
+    for (size_t i = 0; i < ptNum; i++) {
+      for (size_t j = i + 1; j < ptNum; j++) {
+        const double d = std::sqrt((_keys[pts[i]] - _keys[pts[j]]).square().sum());
+        distSum[i] += d;
+        distSum[j] += d;
+      }
+    }
+
+    std::vector<size_t> seeds;
+    seeds.reserve(childNum);
+    std::vector<bool> isSeed(ptNum, false);
+    seeds.emplace_back(std::max_element(distSum.begin(), distSum.end()) - distSum.begin());
+    isSeed[seeds.back()] = true;
+    std::fill(distSum.begin(), distSum.end(), 0);
+    while (seeds.size() < childNum) {
+      size_t next = npos;
+      for (size_t i = 0; i < ptNum; i++) {
+        if (isSeed[i]) {
+          continue;
+        }
+        distSum[i] += std::sqrt((_keys[pts[i]] - _keys[pts[seeds.back()]]).square().sum());
+        if (next == npos || distSum[i] > distSum[next]) {
+          next = i;
+        }
+      }
+      seeds.emplace_back(next);
+      isSeed[next] = true;
+    }
+
+    std::vector<size_t> children(childNum);
+    for (size_t s = 0; s < childNum; s++) {
+      const size_t idx = pts[seeds[s]];
+      children[s] = newNode(n, true);
+      Node& child = _nodes[children[s]];
+      child.ideal = _keys[idx];
+      child.nadir = _keys[idx];
+      child.items.emplace_back(idx);
+      _leafOf[idx] = children[s];
+    }
+
+    for (size_t i = 0; i < ptNum; i++) {
+      if (isSeed[i]) {
+        continue;
+      }
+      const size_t idx = pts[i];
+      size_t best = 0;
+      double bestDist = internal::pinfD;
+      for (size_t s = 0; s < childNum; s++) {
+        const double dist = (_keys[pts[seeds[s]]] - _keys[idx]).square().sum();
+        if (dist < bestDist) {
+          bestDist = dist;
+          best = s;
+        }
+      }
+      Node& child = _nodes[children[best]];
+      child.ideal = child.ideal.min(_keys[idx]);
+      child.nadir = child.nadir.max(_keys[idx]);
+      child.items.emplace_back(idx);
+      _leafOf[idx] = children[best];
+    }
+
+    _nodes[n].isLeaf = false;
+    _nodes[n].items = std::move(children);
+  }
+
+  /**
+   * \brief Remove the entry `idx` from the tree and the storage.
+   *
+   * Empty nodes are removed, and an internal node left with a single child is replaced by the
+   * child. Bounds of the remaining nodes are not tightened, they're still valid bounds.
+   */
+  void removeEntry(size_t idx) noexcept {
+    size_t n = _leafOf[idx];
+    {
+      std::vector<size_t>& items = _nodes[n].items;
+      *std::find(items.begin(), items.end(), idx) = items.back();
+      items.pop_back();
+    }
+
+    while (_nodes[n].items.empty()) {
+      const size_t parent = _nodes[n].parent;
+      freeNode(n);
+      if (parent == npos) {
+        _root = npos;
+        break;
+      }
+      std::vector<size_t>& siblings = _nodes[parent].items;
+      *std::find(siblings.begin(), siblings.end(), n) = siblings.back();
+      siblings.pop_back();
+      n = parent;
+    }
+
+    if (_root != npos && !_nodes[n].isLeaf && _nodes[n].items.size() == 1) {
+      const size_t child = _nodes[n].items.front();
+      const size_t parent = _nodes[n].parent;
+      _nodes[child].parent = parent;
+      if (parent == npos) {
+        _root = child;
+      } else {
+        std::vector<size_t>& siblings = _nodes[parent].items;
+        *std::find(siblings.begin(), siblings.end(), n) = child;
+      }
+      freeNode(n);
+    }
+
+    const size_t last = _entries.size() - 1;
+    for (int o = 0; o < int(_sortedByObj.size()); o++) {
+      _sortedByObj[o].erase(findSorted(o, idx));
+      if (idx != last) {
+        *findSorted(o, last) = idx;
+      }
+    }
+    if (idx != last) {
+      _entries[idx] = std::move(_entries[last]);
+      _keys[idx] = _keys[last];
+      _leafOf[idx] = _leafOf[last];
+      std::vector<size_t>& items = _nodes[_leafOf[idx]].items;
+      *std::find(items.begin(), items.end(), last) = idx;
+    }
+    _entries.pop_back();
+    _keys.pop_back();
+    _leafOf.pop_back();
+  }
+
+  /// Remove entries with least crowding distance until the capacity is satisfied.
+  void truncate() noexcept {
+    if (_capacity <= 0) {
+      return;
+    }
+    std::vector<double> crowding;
+    while (_entries.size() > _capacity) {
+      const size_t num = _entries.size();
+      crowding.assign(num, 0);
+      for (int o = 0; o < int(_sortedByObj.size()); o++) {
+        const std::vector<size_t>& sorted = _sortedByObj[o];
+        crowding[sorted.front()] = internal::pinfD;
+        crowding[sorted.back()] = internal::pinfD;
+        const double range = _keys[sorted.back()][o] - _keys[sorted.front()][o];
+        if (range <= 0) {
+          continue;
+        }
+        for (size_t i = 1; i + 1 < num; i++) {
+          crowding[sorted[i]] += (_keys[sorted[i + 1]][o] - _keys[sorted[i - 1]][o]) / range;
+        }
+      }
+      removeEntry(std::min_element(crowding.begin(), crowding.end()) - crowding.begin());
+    }
+  }
+};
+
+}  //  namespace heu
+
+#endif  //  HEU_PARETOARCHIVE_HPP
@@ -0,0 +1,328 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_BINARYGENE_HPP
+#define HEU_BINARYGENE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+
+#include <HeuristicFlow/Global>
+#include "../../SimpleMatrix"
+#include "InternalHeaderCheck.h"
+
+namespace heu {
+
+/**
+ * \ingroup HEU_GENETIC
+ * \brief Packed binary decision variable, one bit for each dimension.
+ *
+ * Compared with arrays of bool, it takes 1/8 of the memory, and `BinaryGADefaults` processes it a
+ * whole block (64 bits) at a time. Bits are stored from the most significant bit of each block.
+ *
+ * \sa BinaryGADefaults popcount hammingDistance
+ */
+using binaryGene_t = multiBitSet<1>;
+
+namespace internal {
+
+/// Number of 1 bits in a block
+template <typename block_t>
+inline int popcountBlock(block_t x) noexcept {
+#if __cplusplus >= 202002L
+  return std::popcount(x);
+#elif defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(x);
+#else
+  int count = 0;
+  for (; x != 0; x &= x - 1) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+}  // namespace internal
+
+/**
+ * \ingroup HEU_GENETIC
+ * \brief Number of 1 bits in a binary gene.
+ */
+inline size_t popcount(const binaryGene_t& v) noexcept {
+  const size_t blockNum = v.usedBlocks();
+  if (blockNum <= 0) {
+    return 0;
+  }
+  size_t count = 0;
+  for (size_t b = 0; b + 1 < blockNum; b++) {
+    count += internal::popcountBlock(v.data()[b]);
+  }
+  return count + internal::popcountBlock(v.data()[blockNum - 1] & v.tailMask());
+}
+
+/**
+ * \ingroup HEU_GENETIC
+ * \brief Number of different bits between two binary genes of the same size.
+ */
+inline size_t hammingDistance(const binaryGene_t& a, const binaryGene_t& b) noexcept {
+  assert(a.size() == b.size());
+  const size_t blockNum = a.usedBlocks();
+  if (blockNum <= 0) {
+    return 0;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i + 1 < blockNum; i++) {
+    count += internal::popcountBlock(a.data()[i] ^ b.data()[i]);
+  }
+  return count +
+         internal::popcountBlock((a.data()[blockNum - 1] ^ b.data()[blockNum - 1]) & a.tailMask());
+}
+
+/**
+ * \ingroup HEU_GENETIC
+ * \struct BinaryGADefaults
+ * \brief Candidate operations of GA for `binaryGene_t`.
+ *
+ * Crossovers build a mask for each block and exchange the masked bits between parents with XOR, so
+ * 64 bits are processed at a time. Mutation samples the positions to flip with geometric gaps, so
+ * its cost is proportional to the number of flipped bits rather than the number of dimensions.
+ *
+ * Names follow GADefaults, where b means binary encoding. Each function has an overload with an
+ * extra `const Args_t*` parameter, which is ignored except by `iFunXb`, so that they can be used
+ * by solvers with or without parameters.
+ *
+ * \sa GADefaults
+ */
+struct BinaryGADefaults {
+  using Var_t = binaryGene_t;
+  using block_t = binaryGene_t::block_t;
+  static constexpr size_t blockBits = binaryGene_t::blockBits;
+
+  /**
+   * \brief A random block whose each bit is 1 with probability `p`.
+   *
+   * The block is combined from several uniform random blocks by AND and OR according to the binary
+   * digits of `p`, so `p` is rounded to a multiple of 2^-16. It takes a single random number if `p`
+   * is 0.5.
+   */
+  static inline block_t randomMask(const double p) noexcept {
+    constexpr int precision = 16;
+    uint32_t q = uint32_t(std::lround(std::min(1.0, std::max(0.0, p)) * (1 << precision)));
+    if (q <= 0) {
+      return 0;
+    }
+    if (q >= (1U << precision)) {
+      return ~block_t(0);
+    }
+    int digits = precision;
+    while ((q & 1) == 0) {
+      q >>= 1;
+      digits--;
+    }
+    // from the least significant digit, P(bit)=(digit+P(bit))/2
+    block_t mask = 0;
+    for (int d = 0; d < digits; d++) {
+      const block_t r = block_t(internal::thread_engine()());
+      mask = ((q >> d) & 1) ? (mask | r) : (mask & r);
+    }
+    return mask;
+  }
+
+  /**
+   * \brief Resize `v` to `dim` bits, and set each bit to 0 or 1 with equal probability.
+   */
+  static inline void initialize(Var_t* v, const size_t dim) noexcept {
+    v->resize(dim);
+    const size_t blockNum = v->usedBlocks();
+    for (size_t b = 0; b < blockNum; b++) {
+      v->data()[b] = block_t(internal::thread_engine()());
+    }
+    if (blockNum > 0) {
+      v->data()[blockNum - 1] &= v->tailMask();
+    }
+  }
+
+  /**
+   * \brief Flip each bit of `v` with probability `rate`.
+   *
+   * \return size_t Number of flipped bits
+   */
+  static inline size_t flipBits(Var_t* v, const double rate) noexcept {
+    const size_t N = v->size();
+    if (rate <= 0 || N <= 0) {
+      return 0;
+    }
+    if (rate >= 1) {
+      for (size_t b = 0; b < v->usedBlocks(); b++) {
+        v->data()[b] = ~v->data()[b];
+      }
+      v->data()[v->usedBlocks() - 1] &= v->tailMask();
+      return N;
+    }
+
+    // gaps between flipped bits follow the geometric distribution
+    const double logQ = std::log1p(-rate);
+    size_t flipped = 0;
+    double pos = std::floor(std::log1p(-randD()) / logQ);
+    while (pos < double(N)) {
+      const size_t idx = size_t(pos);
+      v->data()[idx / blockBits] ^= block_t(1) << (blockBits - 1 - idx % blockBits);
+      flipped++;
+      pos += 1 + std::floor(std::log1p(-randD()) / logQ);
+    }
+    return flipped;
+  }
+
+  /**
+   * \brief Flip a random bit of `v`.
+   */
+  static inline void flipOneBit(Var_t* v) noexcept {
+    assert(v->size() > 0);
+    const size_t idx = randIdx(v->size());
+    v->data()[idx / blockBits] ^= block_t(1) << (blockBits - 1 - idx % blockBits);
+  }
+
+  /**
+   * \brief Initialization function with `dim` bits
+   */
+  template <size_t dim>
+  inline static void iFunNb(Var_t* v) noexcept {
+    initialize(v, dim);
+  }
+
+  template <size_t dim, class Args_t>
+  inline static void iFunNb(Var_t* v, const Args_t*) noexcept {
+    initialize(v, dim);
+  }
+
+  /**
+   * \brief Initialization function whose size is `args->dimensions()`.
+   */
+  template <class Args_t>
+  inline static void iFunXb(Var_t* v, const Args_t* args) noexcept {
+    initialize(v, size_t(args->dimensions()));
+  }
+
+  /**
+   * \brief Uniform crossover. Each bit is swapped between the two children with probability `p`.
+   *
+   * \tparam p Swap probability, encoded as DivCode. Default value is 0.5.
+   */
+  template <DivCode p = DivCode::DivCode_Half>
+  inline static void cFunRandb(const Var_t* p1, const Var_t* p2, Var_t* c1, Var_t* c2) noexcept {
+    static constexpr double r = DivDecode<p>::real;
+    static_assert(r > 0, "A probability shoule be greater than 0");
+    static_assert(r < 1, "A probability shoule be less than 1");
+    assert(p1->size() == p2->size());
+    prepareChildren(p1, c1, c2);
+    for (size_t b = 0; b < p1->usedBlocks(); b++) {
+      exchange(p1, p2, c1, c2, b, randomMask(r));
+    }
+  }
+
+  template <DivCode p = DivCode::DivCode_Half, class Args_t>
+  inline static void cFunRandb(const Var_t* p1, const Var_t* p2, Var_t* c1, Var_t* c2,
+                               const Args_t*) noexcept {
+    cFunRandb<p>(p1, p2, c1, c2);
+  }
+
+  /**
+   * \brief N-point crossover. Children exchange bits between every two adjacent cut points.
+   *
+   * \tparam n Number of cut points, they are selected randomly and independently.
+   */
+  template <int n = 2>
+  inline static void cFunNPointb(const Var_t* p1, const Var_t* p2, Var_t* c1, Var_t* c2) noexcept {
+    static_assert(n > 0, "There should be at least 1 cut point");
+    assert(p1->size() == p2->size());
+    prepareChildren(p1, c1, c2);
+    const size_t N = p1->size();
+    if (N < 2) {
+      return;
+    }
+
+    std::array<size_t, n> cuts;
+    for (size_t& c : cuts) {
+      c = randIdx<size_t>(1, N);
+    }
+    std::sort(cuts.begin(), cuts.end());
+
+    // bits after an odd number of cuts are exchanged
+    block_t carry = 0;
+    size_t cutIdx = 0;
+    for (size_t b = 0; b < p1->usedBlocks(); b++) {
+      block_t mask = carry;
+      while (cutIdx < cuts.size() && cuts[cutIdx] / blockBits == b) {
+        mask ^= (~block_t(0)) >> (cuts[cutIdx] % blockBits);
+        cutIdx++;
+      }
+      carry = (mask & 1) ? (~block_t(0)) : block_t(0);
+      exchange(p1, p2, c1, c2, b, mask);
+    }
+  }
+
+  template <int n = 2, class Args_t>
+  inline static void cFunNPointb(const Var_t* p1, const Var_t* p2, Var_t* c1, Var_t* c2,
+                                 const Args_t*) noexcept {
+    cFunNPointb<n>(p1, p2, c1, c2);
+  }
+
+  /**
+   * \brief Bit-flip mutation. Each bit is flipped with probability `rate`, and a random bit is
+   * flipped if none is, so that the mutant always differs from `src`.
+   *
+   * \tparam rate Flip probability of each bit, encoded as DivCode. Default value is 0.01.
+   */
+  template <DivCode rate = DivEncode<1, 100>::code>
+  inline static void mFunb(const Var_t* src, Var_t* v) noexcept {
+    *v = *src;
+    if (flipBits(v, DivDecode<rate>::real) <= 0) {
+      flipOneBit(v);
+    }
+  }
+
+  template <DivCode rate = DivEncode<1, 100>::code, class Args_t>
+  inline static void mFunb(const Var_t* src, Var_t* v, const Args_t*) noexcept {
+    mFunb<rate>(src, v);
+  }
+
+ private:
+  static inline void prepareChildren(const Var_t* p, Var_t* c1, Var_t* c2) noexcept {
+    c1->resize(p->size());
+    c2->resize(p->size());
+  }
+
+  /// c1 and c2 take bits of p2 and p1 respectively where `mask` is 1
+  static inline void exchange(const Var_t* p1, const Var_t* p2, Var_t* c1, Var_t* c2,
+                              const size_t b, const block_t mask) noexcept {
+    const block_t a = p1->data()[b], c = p2->data()[b];
+    const block_t diff = (a ^ c) & mask;
+    c1->data()[b] = a ^ diff;
+    c2->data()[b] = c ^ diff;
+  }
+};
+
+}  //  namespace heu
+
+#endif  //  HEU_BINARYGENE_HPP
@@ -77,11 +77,11 @@ template <typename Var_t, int N>
 class NSGAGene_t : public MOGene_t<Var_t, N> {
  public:
   using Fitness_t = Eigen::Array<double, N, 1>;
-  NSGAGene_t() : dominated_by_num(0) {
+  NSGAGene_t() : pareto_rank(0) {
     static_assert(is_NSGA_gene_v<std::decay_t<decltype(*this)>>);
   }
-  /// The number of genes that dominate a gene
-  size_t dominated_by_num;
+  /// Index of the non-dominated layer that a gene belongs to. 0 means the gene is on the PF.
+  size_t pareto_rank;
 };
 
 /**
@@ -0,0 +1,332 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_FITNESSCACHE_HPP
+#define HEU_FITNESSCACHE_HPP
+
+#include <assert.h>
+#include <stdint.h>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <HeuristicFlow/Global>
+#include "InternalHeaderCheck.h"
+
+namespace heu {
+
+namespace internal {
+
+/**
+ * \ingroup HEU_GENETIC
+ * \brief Decide whether a decision variable type can be used as the key of fitness cache.
+ *
+ * A type is cacheable if it's an arithmetic type, or it stores arithmetic elements contiguously and
+ * exposes them through `data()` and `size()`, i.e. std::vector, std::array and Eigen classes.
+ */
+template <class Var_t, bool isVec = isVector_v<Var_t>>
+struct fitnessCacheTraits {
+  static constexpr bool value = std::is_arithmetic_v<Var_t>;
+};
+
+template <class Var_t>
+struct fitnessCacheTraits<Var_t, true> {
+  static constexpr bool value = std::is_arithmetic_v<typename array_traits<Var_t>::Scalar_t>;
+};
+
+/**
+ * \ingroup HEU_GENETIC
+ * \class FitnessCacheBody
+ * \brief Maintains an optional bounded cache that maps decision variables to their fitness.
+ *
+ * Crossover and mutation often produce children that are identical to genes evaluated before,
+ * especially with discrete or binary boxes. When the cache is enabled by a positive capacity,
+ * `GABase::__impl_computeAllFitness` looks up every uncomputed gene in the cache, and only genes
+ * that miss are evaluated. Genes that miss but repeat a decision variable of another miss are not
+ * evaluated either, they copy the fitness of that gene. Fitness values of evaluated genes are then
+ * stored into the cache.
+ *
+ * Decision variables are compared element by element. Since NaN never equals itself, decision
+ * variables with non-finite elements are never cached. Once the cache is full, entries are evicted
+ * with the clock (second chance) algorithm, an approximation of LRU that doesn't reorder entries
+ * on every hit.
+ *
+ * The cache is disabled by default. It only pays off when the fitness function is much more
+ * expensive than hashing a decision variable. Only use it when the fitness function is
+ * deterministic.
+ *
+ * If `Var_t` is not cacheable, this class is empty and `isFitnessCacheEnabled()` always returns
+ * false.
+ *
+ * \tparam Var_t Type of decision variable
+ * \tparam Fitness_t Type of fitness
+ */
+template <class Var_t, class Fitness_t, bool cacheable = fitnessCacheTraits<Var_t>::value>
+class FitnessCacheBody {
+ public:
+  static constexpr bool isCacheable = false;
+
+  inline constexpr bool isFitnessCacheEnabled() const noexcept { return false; }
+
+ protected:
+  inline bool findCachedFitness(const Var_t &, Fitness_t *) noexcept { return false; }
+
+  inline void cacheFitness(const Var_t &, const Fitness_t &) noexcept {}
+
+  template <class Gene_t>
+  inline void removeDuplicatedTasks(std::vector<Gene_t *> *,
+                                    std::vector<std::pair<Gene_t *, const Gene_t *>> *) noexcept {}
+};
+
+template <class Var_t, class Fitness_t>
+class FitnessCacheBody<Var_t, Fitness_t, true> {
+ private:
+  struct hasher {
+    inline size_t operator()(const Var_t &v) const noexcept {
+      if constexpr (std::is_arithmetic_v<Var_t>) {
+        return std::hash<Var_t>()(v);
+      } else {
+        using Scalar_t = typename array_traits<Var_t>::Scalar_t;
+        size_t h = size_t(v.size());
+        for (size_t i = 0; i < size_t(v.size()); i++) {
+          h ^= std::hash<Scalar_t>()(v.data()[i]) + size_t(0x9e3779b97f4a7c15ULL) + (h << 6) +
+               (h >> 2);
+        }
+        return h;
+      }
+    }
+  };
+
+  struct equal {
+    inline bool operator()(const Var_t &a, const Var_t &b) const noexcept {
+      if constexpr (std::is_arithmetic_v<Var_t>) {
+        return a == b;
+      } else {
+        if (a.size() != b.size()) {
+          return false;
+        }
+        for (size_t i = 0; i < size_t(a.size()); i++) {
+          if (!(a.data()[i] == b.data()[i])) {
+            return false;
+          }
+        }
+        return true;
+      }
+    }
+  };
+
+  struct ptrHasher {
+    inline size_t operator()(const Var_t *v) const noexcept { return hasher()(*v); }
+  };
+
+  struct ptrEqual {
+    inline bool operator()(const Var_t *a, const Var_t *b) const noexcept {
+      return equal()(*a, *b);
+    }
+  };
+
+  using map_t = std::unordered_map<Var_t, uint32_t, hasher, equal>;
+
+  struct slot_t {
+    const Var_t *key;  ///< Points to the key stored in map, nullptr if this slot is empty
+    Fitness_t fitness;
+    bool referenced;  ///< Whether this entry is used after the clock hand passed it last time
+  };
+
+ public:
+  static constexpr bool isCacheable = true;
+
+  FitnessCacheBody() : _hand(0), _hits(0), _misses(0) {}
+
+  /// Only the capacity is copied, since slots refer to keys stored in the map.
+  FitnessCacheBody(const FitnessCacheBody &another) : FitnessCacheBody() {
+    setFitnessCacheCapacity(another.fitnessCacheCapacity());
+  }
+
+  /// Only the capacity is copied, since slots refer to keys stored in the map.
+  FitnessCacheBody &operator=(const FitnessCacheBody &another) {
+    if (this != &another) {
+      clearFitnessCache();
+      setFitnessCacheCapacity(another.fitnessCacheCapacity());
+    }
+    return *this;
+  }
+
+  /**
+   * \brief Set the maximum number of entries in the fitness cache. All cached entries are dropped.
+   *
+   * \param capacity Maximum number of entries. 0 disables the cache.
+   */
+  void setFitnessCacheCapacity(size_t capacity) noexcept {
+    HEU_ASSERT(capacity < size_t(UINT32_MAX));
+    _map.clear();
+    _slots.clear();
+    _slots.shrink_to_fit();
+    _slots.resize(capacity, slot_t{nullptr, Fitness_t(), false});
+    _map.reserve(capacity);
+    _hand = 0;
+  }
+
+  /// Maximum number of entries in the fitness cache
+  inline size_t fitnessCacheCapacity() const noexcept { return _slots.size(); }
+
+  /// Whether the fitness cache is enabled
+  inline bool isFitnessCacheEnabled() const noexcept { return !_slots.empty(); }
+
+  /// Number of entries in the fitness cache
+  inline size_t fitnessCacheSize() const noexcept { return _map.size(); }
+
+  /// Number of genes whose fitness is found in cache
+  inline size_t fitnessCacheHits() const noexcept { return _hits; }
+
+  /// Number of genes whose fitness is not found in cache and thus evaluated
+  inline size_t fitnessCacheMisses() const noexcept { return _misses; }
+
+  /// Drop all cached entries and reset the hit/miss counters.
+  void clearFitnessCache() noexcept {
+    setFitnessCacheCapacity(fitnessCacheCapacity());
+    _hits = 0;
+    _misses = 0;
+  }
+
+ protected:
+  /**
+   * \brief Look up the fitness of `v` and count a hit or miss.
+   *
+   * \return true if `v` is found and its fitness is written to `*f`.
+   */
+  bool findCachedFitness(const Var_t &v, Fitness_t *f) noexcept {
+    if (!isValidKey(v)) {
+      _misses++;
+      return false;
+    }
+    auto it = _map.find(v);
+    if (it == _map.end()) {
+      _misses++;
+      return false;
+    }
+    slot_t &s = _slots[it->second];
+    s.referenced = true;
+    *f = s.fitness;
+    _hits++;
+    return true;
+  }
+
+  /**
+   * \brief Store the fitness of `v`. An entry will be evicted if the cache is full.
+   */
+  void cacheFitness(const Var_t &v, const Fitness_t &f) noexcept {
+    if (_slots.empty() || !isValidKey(v)) {
+      return;
+    }
+    auto it = _map.find(v);
+    if (it != _map.end()) {
+      _slots[it->second].fitness = f;
+      return;
+    }
+
+    // clock sweep: skip and clear referenced slots until an evictable slot is found
+    while (_slots[_hand].key != nullptr && _slots[_hand].referenced) {
+      _slots[_hand].referenced = false;
+      _hand = (_hand + 1) % _slots.size();
+    }
+
+    slot_t &s = _slots[_hand];
+    if (s.key != nullptr) {
+      auto evicted = _map.find(*s.key);
+      assert(evicted != _map.end());
+      if (evicted != _map.end()) {
+        _map.erase(evicted);
+      }
+    }
+    it = _map.emplace(v, uint32_t(_hand)).first;
+    s.key = &it->first;
+    s.fitness = f;
+    s.referenced = false;
+    _hand = (_hand + 1) % _slots.size();
+  }
+
+  /**
+   * \brief Remove genes that repeat the decision variable of an earlier gene in `tasks`, so that
+   * each distinct decision variable is evaluated once.
+   *
+   * All genes in `tasks` should have missed the cache. Removed genes are counted as hits instead.
+   *
+   * \param duplicates Pairs of a removed gene and the gene in `tasks` whose fitness it should copy
+   */
+  template <class Gene_t>
+  void removeDuplicatedTasks(
+      std::vector<Gene_t *> *tasks,
+      std::vector<std::pair<Gene_t *, const Gene_t *>> *duplicates) noexcept {
+    if (tasks->size() < 2) {
+      return;
+    }
+    std::unordered_map<const Var_t *, const Gene_t *, ptrHasher, ptrEqual> firstOf;
+    firstOf.reserve(tasks->size());
+    size_t kept = 0;
+    for (Gene_t *g : *tasks) {
+      if (isValidKey(g->decision_variable)) {
+        auto it = firstOf.emplace(&g->decision_variable, g).first;
+        if (it->second != g) {
+          duplicates->emplace_back(g, it->second);
+          _misses--;
+          _hits++;
+          continue;
+        }
+      }
+      (*tasks)[kept++] = g;
+    }
+    tasks->resize(kept);
+  }
+
+ private:
+  /// Whether `v` can be a key, i.e. it equals itself.
+  static bool isValidKey(const Var_t &v) noexcept {
+    if constexpr (std::is_floating_point_v<Var_t>) {
+      return std::isfinite(v);
+    } else if constexpr (std::is_arithmetic_v<Var_t>) {
+      return true;
+    } else if constexpr (std::is_floating_point_v<typename array_traits<Var_t>::Scalar_t>) {
+      for (size_t i = 0; i < size_t(v.size()); i++) {
+        if (!std::isfinite(v.data()[i])) {
+          return false;
+        }
+      }
+      return true;
+    } else {
+      return true;
+    }
+  }
+
+  map_t _map;                  ///< Decision variable to index of slot
+  std::vector<slot_t> _slots;  ///< Slots of cached fitness, scanned by the clock hand
+  size_t _hand;                ///< Clock hand
+  size_t _hits;
+  size_t _misses;
+};
+
+}  //  namespace internal
+
+}  //  namespace heu
+
+#endif  //  HEU_FITNESSCACHE_HPP
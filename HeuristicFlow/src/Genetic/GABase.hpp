@@ -22,6 +22,7 @@ This file is part of HeuristicFlow.
 
 #include <vector>
 #include <list>
+#include <mutex>
 #include <cmath>
 #include <random>
 #include <algorithm>
@@ -35,6 +36,8 @@ This file is part of HeuristicFlow.
 #include "InternalHeaderCheck.h"
 #include "GAOption.hpp"
 #include "GAAbstract.hpp"
+#include "GenePool.hpp"
+#include "FitnessCache.hpp"
 
 #include "IsGene.hpp"
 
@@ -82,7 +85,9 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
                public GAAbstract<Var_t, Fitness_t, Args_t>::template iFunBody<_iFun_>,
                public GAAbstract<Var_t, Fitness_t, Args_t>::template fFunBody<_fFun_>,
                public GAAbstract<Var_t, Fitness_t, Args_t>::template cFunBody<_cFun_>,
-               public GAAbstract<Var_t, Fitness_t, Args_t>::template mFunBody<_mFun_> {
+               public GAAbstract<Var_t, Fitness_t, Args_t>::template mFunBody<_mFun_>,
+               public BatchFitnessBody<Var_t, Fitness_t, Args_t>,
+               public FitnessCacheBody<Var_t, Fitness_t> {
  private:
   using Base_t = GAAbstract<Var_t, Fitness_t, Args_t>;
 
@@ -92,12 +97,13 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
   ~GABase() = default;
 
  protected:
-  using poplist_t = std::list<Gene>;
+  using poplist_t = typename GAPopulationContainer<Gene>::type;
+  using BatchBuffer_t = typename BatchFitnessBody<Var_t, Fitness_t, Args_t>::BatchBuffer;
 
  public:
   /// Type of gene
   using Gene_t = Gene;
-  /// list iterator to Gene
+  /// Iterator to Gene
   using GeneIt_t = typename poplist_t::iterator;
   /**
    * \brief Set the option object
@@ -129,7 +135,8 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
   /**
    * \brief Get the whole population
    *
-   * \return const std::list<Gene>& Const reference the the population
+   * \return const poplist_t& Const reference the the population. It's `std::list<Gene>` by default,
+   * see GAPopulationContainer.
    */
   inline const poplist_t &population() const noexcept { return _population; }
 
@@ -147,13 +154,39 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
    */
   inline size_t failTimes() const noexcept { return _failTimes; }
 
+  /**
+   * \brief Whether the solver should stop according to the termination criteria in its option.
+   *
+   * \return true if `step()` will return false without doing anything.
+   */
+  inline bool isTerminated() const noexcept {
+    return (_generation >= _option.maxGenerations) ||
+           (_option.maxFailTimes > 0 && _failTimes > _option.maxFailTimes) ||
+           _termination.shouldStop(_option.termination);
+  }
+
+  /**
+   * \brief Number of fitness evaluations in the current run. Genes found in the fitness cache are
+   * not counted.
+   */
+  inline size_t evaluationCount() const noexcept { return _termination.evaluations(); }
+
+  /**
+   * \brief Time spent in fitness, selection, crossover and mutation in the current run. It's empty
+   * unless `HEU_DO_PROFILING` is defined. In `runAsync`, breeding is counted as crossover.
+   */
+  inline const SolverProfile &profile() const noexcept { return _profile; }
+
  protected:
-  poplist_t _population;  ///< Population stored in list
+  poplist_t _population;  ///< Population stored in list or GenePool
   GAOption _option;       ///< Option of GA solver
 
   size_t _generation;  ///< Current generation
   size_t _failTimes;   ///< Current failtimes
 
+  TerminationMonitor _termination;  ///< Counters of extra termination criteria
+  SolverProfile _profile;           ///< Timers of phases
+
   inline void __impl_clearRecord() noexcept {
   }  ///< Nothing is need to do if the solver doesn't record fitnesses.
 
@@ -166,80 +199,424 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
    *
    * \tparam this_t Type of a solver. This type is added to record fitness through some template
    * tricks like CRTP.
+   * \param observer Called with the solver after the initial population and each generation. See
+   * `internal::notifyObserver`.
+   */
+  template <class this_t, class Observer_t>
+  void __impl_run(Observer_t &&observer) noexcept {
+    static_cast<this_t *>(this)->template __impl_startRun<this_t>();
+    if (!notifyObserver(observer, *static_cast<const this_t *>(this))) {
+      return;
+    }
+    while (static_cast<this_t *>(this)->template __impl_step<this_t>()) {
+      if (!notifyObserver(observer, *static_cast<const this_t *>(this))) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * \brief Reset counters and records, then evaluate and select the initial population.
+   *
+   * `__impl_run` is equivalent to calling `__impl_startRun` once and then `__impl_step` until it
+   * returns false. Drivers like IslandModel use them to pause a solver between generations.
+   * `__impl_runAsync` also starts with it.
    */
   template <class this_t>
-  void __impl_run() noexcept {
+  void __impl_startRun() noexcept {
     _generation = 0;
     _failTimes = 0;
+    _termination.start();
+    _profile.reset();
     static_cast<this_t *>(this)->__impl_clearRecord();
-    while (true) {
-      _generation++;
-      static_cast<this_t *>(this)->__impl_computeAllFitness();
-
-      static_cast<this_t *>(this)->__impl_select();
-
-      static_cast<this_t *>(this)->template __impl_recordFitness<this_t>();
+    static_cast<this_t *>(this)->template __impl_evaluateAndSelect<this_t>();
+  }
 
-      if (_generation > _option.maxGenerations) {
+  /**
+   * \brief Run one more generation unless the solver should terminate.
+   *
+   * \return false if the solver has terminated, and nothing is done.
+   */
+  template <class this_t>
+  bool __impl_step() noexcept {
+    if (isTerminated()) {
 #ifdef HEU_DO_OUTPUT
+      if (_generation >= _option.maxGenerations) {
         std::cout << "Terminated by max generation limitation" << std::endl;
-#endif
-        break;
-      }
-      if (_option.maxFailTimes > 0 && _failTimes > _option.maxFailTimes) {
-#ifdef HEU_DO_OUTPUT
+      } else if (_option.maxFailTimes > 0 && _failTimes > _option.maxFailTimes) {
         std::cout << "Terminated by max failTime limitation" << std::endl;
-#endif
-        break;
+      } else {
+        std::cout << "Terminated by termination criteria" << std::endl;
       }
-#ifdef HEU_DO_OUTPUT
-      std::cout << "Generation "
-                << _generation
-                //<<" , elite fitness="<<_eliteIt->fitness()
-                << std::endl;
 #endif
+      return false;
+    }
+
+    {
+      ProfileTimer timer(&_profile, PHASE_CROSSOVER);
       static_cast<this_t *>(this)->__impl_crossover();
+    }
+    {
+      ProfileTimer timer(&_profile, PHASE_MUTATE);
       static_cast<this_t *>(this)->__impl_mutate();
     }
-    _generation--;
+    _generation++;
+#ifdef HEU_DO_OUTPUT
+    std::cout << "Generation " << _generation << std::endl;
+#endif
+    static_cast<this_t *>(this)->template __impl_evaluateAndSelect<this_t>();
+    return true;
+  }
+
+  /// Compute fitness, apply selection and record fitness.
+  template <class this_t>
+  inline void __impl_evaluateAndSelect() noexcept {
+    static_cast<this_t *>(this)->__impl_computeAllFitness();
+
+    {
+      ProfileTimer timer(&_profile, PHASE_SELECT);
+      static_cast<this_t *>(this)->__impl_select();
+    }
+
+    static_cast<this_t *>(this)->template __impl_recordFitness<this_t>();
+  }
+
+  /**
+   * \brief Write the state of a paused run to a binary stream.
+   *
+   * The checkpoint contains the random state of the calling thread, counters, the population in
+   * order, records and solver-specific state (see `__impl_saveExtraState`). Options, functions
+   * and the fitness cache are not saved.
+   *
+   * \return Whether all bytes are written.
+   */
+  template <class this_t>
+  bool __impl_saveCheckpoint(std::ostream &os) const noexcept {
+    writeCheckpointHeader<this_t>(os);
+    writeBinary(os, uint64_t(_generation));
+    writeBinary(os, uint64_t(_failTimes));
+    writeBinary(os, uint64_t(_termination.evaluations()));
+    writeBinary(os, _termination.targetReached());
+    writeBinary(os, uint64_t(_population.size()));
+    for (const Gene &g : _population) {
+      writeBinary(os, g.decision_variable);
+      writeBinary(os, g.fitness);
+      writeBinary(os, g.is_fitness_computed);
+    }
+    static_cast<const this_t *>(this)->__impl_saveRecord(os);
+    static_cast<const this_t *>(this)->__impl_saveExtraState(os);
+    return bool(os);
+  }
+
+  /**
+   * \brief Restore a run written by `__impl_saveCheckpoint`.
+   *
+   * `initializePop` must be called before with the same options, so that derived classes have
+   * their members like reference points initialized. The time limit starts again from loading.
+   *
+   * \return false if the stream is truncated or belongs to another kind of solver. The solver must
+   * be initialized again in that case.
+   */
+  template <class this_t>
+  bool __impl_loadCheckpoint(std::istream &is) noexcept {
+    uint64_t generation = 0, failTimes = 0, evaluations = 0, popSize = 0;
+    bool targetReached = false;
+    if (!readCheckpointHeader<this_t>(is) || !readBinary(is, &generation) ||
+        !readBinary(is, &failTimes) || !readBinary(is, &evaluations) ||
+        !readBinary(is, &targetReached) || !readBinary(is, &popSize)) {
+      return false;
+    }
+    _population.resize(popSize);
+    for (Gene &g : _population) {
+      if (!readBinary(is, &g.decision_variable) || !readBinary(is, &g.fitness) ||
+          !readBinary(is, &g.is_fitness_computed)) {
+        return false;
+      }
+    }
+    if (!static_cast<this_t *>(this)->__impl_loadRecord(is) ||
+        !static_cast<this_t *>(this)->__impl_loadExtraState(is)) {
+      return false;
+    }
+    _generation = generation;
+    _failTimes = failTimes;
+    _termination.resume(evaluations, targetReached);
+    _profile.reset();
+    return true;
+  }
+
+  /**
+   * \brief Continue a run restored by `__impl_loadCheckpoint` until it terminates.
+   *
+   * Together with `__impl_loadCheckpoint`, it replays the same generations as the run that saved
+   * the checkpoint if it was paused between generations.
+   */
+  template <class this_t, class Observer_t>
+  void __impl_resume(Observer_t &&observer) noexcept {
+    while (static_cast<this_t *>(this)->template __impl_step<this_t>()) {
+      if (!notifyObserver(observer, *static_cast<const this_t *>(this))) {
+        return;
+      }
+    }
+  }
+
+  inline void __impl_saveRecord(std::ostream &) const noexcept {
+  }  ///< Nothing is need to do if the solver doesn't record fitnesses.
+
+  inline bool __impl_loadRecord(std::istream &) noexcept {
+    return true;
+  }  ///< Nothing is need to do if the solver doesn't record fitnesses.
+
+  inline void __impl_saveExtraState(std::ostream &) const noexcept {
+  }  ///< Derived solvers save members that are not recomputed by selection.
+
+  inline bool __impl_loadExtraState(std::istream &) noexcept {
+    return true;
+  }  ///< Derived solvers load members saved by `__impl_saveExtraState`.
+
+  /**
+   * \brief Run the genetic algorithm in asynchronous steady-state mode.
+   *
+   * The initial population is evaluated as usual, then `threadNum()` workers keep breeding and
+   * evaluating children without waiting for each other. A worker breeds one or two children from
+   * random parents, evaluates them without holding the lock, and inserts them into the population
+   * as soon as they are evaluated. Selection is applied every time `threadNum()` children have
+   * been inserted, so no worker idles waiting for the slowest gene of a generation.
+   *
+   * In this mode, a generation means `populationSize` inserted children, which is when the
+   * termination criteria are checked, fail times are updated and fitness is recorded. Children are
+   * made by crossover with probability `crossoverProb`, and mutated with probability `mutateProb`.
+   * A child that is not made by crossover is always mutated.
+   *
+   * Since children are inserted in the order they finish, results are not reproducible with more
+   * than one thread.
+   *
+   * Workers call the fitness function or the batch fitness function concurrently, so it must be
+   * thread-safe. Each worker packs its batches into its own buffer.
+   *
+   * The observer is called once per generation by one of the workers while it holds the lock, so
+   * it's never called concurrently.
+   */
+  template <class this_t, class Observer_t>
+  void __impl_runAsync(Observer_t &&observer) noexcept {
+    static_cast<this_t *>(this)->template __impl_startRun<this_t>();
+    if (!notifyObserver(observer, *static_cast<const this_t *>(this)) || isTerminated()) {
+      return;
+    }
+
+    std::mutex mtx;
+    const int workerNum = std::max(1, threadNum());
+    const size_t selectInterval = size_t(workerNum);
+    size_t insertedSinceSelect = 0;
+    size_t insertedSinceGeneration = 0;
+    size_t failTimesBefore = _failTimes;
+    bool improved = false;
+    bool stop = false;
+
+    std::vector<GeneIt_t> parents;
+    auto updateParents = [this, &parents]() {
+      parents.clear();
+      parents.reserve(_population.size());
+      for (GeneIt_t it = _population.begin(); it != _population.end(); ++it) {
+        parents.emplace_back(it);
+      }
+    };
+    updateParents();
+
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, workerNum, [&](int w) {
+      RandStreamScope randScope(randRegion, w);
+      // Workers evaluate concurrently, so each one packs its batches into its own buffer.
+      BatchBuffer_t batchBuffer;
+      std::vector<Gene> children;
+      std::vector<Gene *> tasks;
+      std::vector<std::pair<Gene *, const Gene *>> duplicates;
+      std::vector<uint8_t> isEvaluated;
+      while (true) {
+        {
+          std::lock_guard<std::mutex> lk(mtx);
+          for (size_t c = 0; c < children.size() && !stop; c++) {
+            if (isEvaluated[c] && this->isFitnessCacheEnabled()) {
+              this->cacheFitness(children[c].decision_variable, children[c].fitness);
+            }
+            _population.emplace_back();
+            _population.back() = std::move(children[c]);
+            insertedSinceSelect++;
+            insertedSinceGeneration++;
+          }
+
+          if (!stop && insertedSinceSelect >= selectInterval) {
+            // The selection may change fail times in its own way, so it's recovered and updated
+            // once per generation.
+            {
+              ProfileTimer timer(&_profile, PHASE_SELECT);
+              static_cast<this_t *>(this)->__impl_select();
+            }
+            improved = improved || (_failTimes == 0);
+            _failTimes = failTimesBefore;
+            insertedSinceSelect = 0;
+            updateParents();
+
+            if (insertedSinceGeneration >= _option.populationSize) {
+              insertedSinceGeneration -= _option.populationSize;
+              _generation++;
+              _failTimes = improved ? 0 : (_failTimes + 1);
+              failTimesBefore = _failTimes;
+              improved = false;
+              static_cast<this_t *>(this)->template __impl_recordFitness<this_t>();
+              stop = !notifyObserver(observer, *static_cast<const this_t *>(this));
+            }
+            stop = stop || isTerminated();
+          }
+          if (stop) {
+            break;
+          }
+
+          {
+            ProfileTimer timer(&_profile, PHASE_CROSSOVER);
+            breed(parents, &children);
+          }
+          tasks.clear();
+          isEvaluated.assign(children.size(), false);
+          for (size_t c = 0; c < children.size(); c++) {
+            if (this->isFitnessCacheEnabled() &&
+                this->findCachedFitness(children[c].decision_variable, &children[c].fitness)) {
+              children[c].is_fitness_computed = true;
+              continue;
+            }
+            tasks.emplace_back(&children[c]);
+          }
+          duplicates.clear();
+          if (this->isFitnessCacheEnabled()) {
+            this->removeDuplicatedTasks(&tasks, &duplicates);
+          }
+          for (const Gene *ptr : tasks) {
+            isEvaluated[ptr - children.data()] = true;
+          }
+        }
+
+        computeFitnessOf(tasks, &batchBuffer);
+        copyFitnessOfDuplicates(duplicates);
+      }
+    });
+  }
+
+  /**
+   * \brief Make one or two children from random parents for the asynchronous steady-state mode.
+   */
+  void breed(const std::vector<GeneIt_t> &parents, std::vector<Gene> *children) noexcept {
+    const GeneIt_t a = parents[randIdx(parents.size())];
+    const bool isCrossover = (randD() <= _option.crossoverProb) && (parents.size() >= 2);
+    if (isCrossover) {
+      GeneIt_t b = parents[randIdx(parents.size())];
+      while (b == a) {
+        b = parents[randIdx(parents.size())];
+      }
+      children->resize(2);
+      GAExecutor<Base_t::HasParameters>::doCrossover(
+          this, &a->decision_variable, &b->decision_variable, &children->front().decision_variable,
+          &children->back().decision_variable);
+    } else {
+      children->resize(1);
+      children->front().decision_variable = a->decision_variable;
+    }
+
+    for (Gene &child : *children) {
+      if (!isCrossover || randD() <= _option.mutateProb) {
+        const Var_t src = child.decision_variable;
+        GAExecutor<Base_t::HasParameters>::doMutation(this, &src, &child.decision_variable);
+      }
+      child.set_fitness_uncomputed();
+    }
   }
 
   /**
    * \brief Compute fitness for the whole population
    *
-   * If OpenMP is used, this process will be parallelized.
+   * If a batch fitness function is set, all uncomputed genes are evaluated with a single call to
+   * it. Otherwise genes are evaluated one by one, and this process will be parallelized if OpenMP
+   * is used.
+   *
+   * If the fitness cache is enabled, genes found in the cache are not evaluated again, genes that
+   * share a decision variable are evaluated once, and the fitness of evaluated genes is stored into
+   * the cache. See FitnessCacheBody.
    *
    */
   void __impl_computeAllFitness() noexcept {
-#ifdef HEU_HAS_OPENMP
     std::vector<Gene *> tasks;
     tasks.reserve(_population.size());
     for (Gene &i : _population) {
       if (i.is_fitness_computed) {
         continue;
       }
+      if (this->isFitnessCacheEnabled()) {
+        if (this->findCachedFitness(i.decision_variable, &i.fitness)) {
+          i.is_fitness_computed = true;
+          continue;
+        }
+      }
       tasks.emplace_back(&i);
     }
-    static const int32_t thN = threadNum();
-#pragma omp parallel for schedule(dynamic, tasks.size() / thN)
-    for (int i = 0; i < int(tasks.size()); i++) {
-      Gene *ptr = tasks[i];
 
-      GAExecutor<Base_t::HasParameters>::doFitness(this, &ptr->decision_variable, &ptr->fitness);
-
-      ptr->is_fitness_computed = true;
+    std::vector<std::pair<Gene *, const Gene *>> duplicates;
+    if (this->isFitnessCacheEnabled()) {
+      this->removeDuplicatedTasks(&tasks, &duplicates);
     }
-#else
-    for (Gene &i : _population) {
-      if (i.is_fitness_computed) {
-        continue;
+
+    computeFitnessOf(tasks);
+
+    if (this->isFitnessCacheEnabled()) {
+      for (const Gene *ptr : tasks) {
+        this->cacheFitness(ptr->decision_variable, ptr->fitness);
       }
+    }
+    copyFitnessOfDuplicates(duplicates);
+  }
 
-      GAExecutor<Base_t::HasParameters>::doFitness(this, &i.decision_variable, &i.fitness);
+  /**
+   * \brief Copy fitness to genes that are removed from tasks by `removeDuplicatedTasks`.
+   */
+  static void copyFitnessOfDuplicates(
+      const std::vector<std::pair<Gene *, const Gene *>> &duplicates) noexcept {
+    for (const auto &d : duplicates) {
+      d.first->fitness = d.second->fitness;
+      d.first->is_fitness_computed = true;
+    }
+  }
 
-      i.is_fitness_computed = true;
+  /**
+   * \brief Evaluate the given genes with batch fitness function or fitness function.
+   *
+   * \param batchBuffer Where batches are packed. The buffer of the solver is used if it's nullptr.
+   */
+  void computeFitnessOf(const std::vector<Gene *> &tasks,
+                        BatchBuffer_t *batchBuffer = nullptr) noexcept {
+    ProfileTimer timer(&_profile, PHASE_FITNESS);
+    _termination.addEvaluations(tasks.size());
+    _profile.addFitnessCalls(tasks.size());
+    if (this->hasBatchfFun()) {
+      std::vector<const Var_t *> vars(tasks.size());
+      std::vector<Fitness_t *> fits(tasks.size());
+      for (size_t i = 0; i < tasks.size(); i++) {
+        vars[i] = &tasks[i]->decision_variable;
+        fits[i] = &tasks[i]->fitness;
+      }
+      GAExecutor<Base_t::HasParameters>::doBatchFitness(this, vars.data(), fits.data(),
+                                                        tasks.size(), batchBuffer);
+      for (Gene *ptr : tasks) {
+        ptr->is_fitness_computed = true;
+      }
+      return;
     }
-#endif
+
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(tasks.size()), [&](int i) {
+      RandStreamScope randScope(randRegion, i);
+      Gene *ptr = tasks[i];
+
+      GAExecutor<Base_t::HasParameters>::doFitness(this, &ptr->decision_variable, &ptr->fitness);
+
+      ptr->is_fitness_computed = true;
+    });
   }
 
   /**
@@ -257,6 +634,9 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
    *
    * Apply crossover operation which let randomly 2 gene born 2 more new one. They will be added to
    * population.
+   *
+   * Parents are paired and children are allocated serially, then `doCrossover` is called for each
+   * pair in parallel. Each pair draws random numbers from its own stream.
    */
   void __impl_crossover() noexcept {
     std::vector<GeneIt_t> crossoverQueue;
@@ -269,35 +649,40 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
       }
     }
 
-    std::shuffle(crossoverQueue.begin(), crossoverQueue.end(), global_mt19937());
+    std::shuffle(crossoverQueue.begin(), crossoverQueue.end(), thread_engine());
 
     if (crossoverQueue.size() % 2 == 1) {
       crossoverQueue.pop_back();
     }
 
-    while (!crossoverQueue.empty()) {
-      GeneIt_t a, b;
-      a = crossoverQueue.back();
-      crossoverQueue.pop_back();
-      b = crossoverQueue.back();
-      crossoverQueue.pop_back();
-      _population.emplace_back();
-      Gene *childA = &_population.back();
+    // crossoverQueue[2i] and crossoverQueue[2i+1] make children[2i] and children[2i+1]
+    std::vector<Gene *> children(crossoverQueue.size());
+    for (Gene *&child : children) {
       _population.emplace_back();
-      Gene *childB = &_population.back();
+      child = &_population.back();
+    }
 
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(children.size() / 2), [&](int i) {
+      RandStreamScope randScope(randRegion, i);
+      Gene *childA = children[2 * i];
+      Gene *childB = children[2 * i + 1];
       GAExecutor<Base_t::HasParameters>::doCrossover(
-          this, &a->decision_variable, &b->decision_variable, &childA->decision_variable,
+          this, &crossoverQueue[2 * i]->decision_variable,
+          &crossoverQueue[2 * i + 1]->decision_variable, &childA->decision_variable,
           &childB->decision_variable);
 
       childA->set_fitness_uncomputed();
       childB->set_fitness_uncomputed();
-    }
+    });
   }
 
   /**
    * \brief Apply mutation operation which slightly modify gene. The modified gene will add to the
    * population.
+   *
+   * Genes to mutate are chosen and children are allocated serially, then `doMutation` is called
+   * for each of them in parallel with its own random stream.
    */
   void __impl_mutate() noexcept {
     std::vector<GeneIt_t> mutateList;
@@ -307,12 +692,20 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
         mutateList.emplace_back(it);
       }
     }
-    for (auto src : mutateList) {
+
+    std::vector<Gene *> children(mutateList.size());
+    for (Gene *&child : children) {
       this->_population.emplace_back();
-      GAExecutor<Base_t::HasParameters>::doMutation(this, &src->decision_variable,
-                                                    &this->_population.back().decision_variable);
-      this->_population.back().set_fitness_uncomputed();
+      child = &this->_population.back();
     }
+
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(children.size()), [&](int i) {
+      RandStreamScope randScope(randRegion, i);
+      GAExecutor<Base_t::HasParameters>::doMutation(this, &mutateList[i]->decision_variable,
+                                                    &children[i]->decision_variable);
+      children[i]->set_fitness_uncomputed();
+    });
   }
 
  protected:
@@ -325,6 +718,11 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
       s->runfFun(v, &s->_args, f);
     }
 
+    inline static void doBatchFitness(GABase *s, const Var_t *const *v, Fitness_t *const *f,
+                                      size_t n, BatchBuffer_t *buffer) noexcept {
+      s->runBatchfFun(v, f, n, &s->_args, buffer);
+    }
+
     inline static void doCrossover(GABase *s, const Var_t *p1, const Var_t *p2, Var_t *c1,
                                    Var_t *c2) noexcept {
       s->runcFun(p1, p2, c1, c2, &s->_args);
@@ -346,6 +744,11 @@ class GABase : public GAAbstract<Var_t, Fitness_t, Args_t>,
       s->runfFun(v, f);
     }
 
+    inline static void doBatchFitness(GABase *s, const Var_t *const *v, Fitness_t *const *f,
+                                      size_t n, BatchBuffer_t *buffer) noexcept {
+      s->runBatchfFun(v, f, n, nullptr, buffer);
+    }
+
     inline static void doCrossover(GABase *s, const Var_t *p1, const Var_t *p2, Var_t *c1,
                                    Var_t *c2) noexcept {
       s->runcFun(p1, p2, c1, c2);
@@ -428,6 +831,10 @@ class GABase<Var_t, Fitness_t, RECORD_FITNESS, Gene, Args_t, _iFun_, _fFun_, _cF
   inline void __impl_recordFitness() noexcept {
     _record.emplace_back(static_cast<this_t *>(this)->bestFitness());
   }
+
+  inline void __impl_saveRecord(std::ostream &os) const noexcept { writeBinary(os, _record); }
+
+  inline bool __impl_loadRecord(std::istream &is) noexcept { return readBinary(is, &_record); }
 };
 }  //  namespace internal
 }  //  namespace heu
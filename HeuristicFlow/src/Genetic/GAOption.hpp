@@ -22,6 +22,7 @@ This file is part of HeuristicFlow.
 
 #include <stdint.h>
 
+#include <HeuristicFlow/Global>
 #include "InternalHeaderCheck.h"
 
 namespace heu {
@@ -83,6 +84,13 @@ struct GAOption {
    *
    */
   double mutateProb;
+
+  /**
+   * \brief Extra criteria like evaluation budget, time limit, target fitness and cancellation.
+   * All of them are disabled by default.
+   *
+   */
+  TerminationCriteria termination;
 };
 
 }  //    namespace heu
@@ -0,0 +1,372 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_GENEPOOL_HPP
+#define HEU_GENEPOOL_HPP
+
+#include <assert.h>
+#include <stdint.h>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <HeuristicFlow/Global>
+#include "InternalHeaderCheck.h"
+
+namespace heu {
+
+/**
+ * \ingroup HEU_GENETIC
+ * \class GenePool
+ * \brief A list-like container that stores its elements in contiguous slabs.
+ *
+ * GenePool provides the subset of `std::list` interfaces that genetic solvers use (`begin`, `end`,
+ * `emplace_back`, `erase`, `resize` ...), so it can be used as the population container of
+ * `GABase` instead of `std::list`.
+ *
+ * Elements are stored in slabs of `slabSize` nodes. A slab is never reallocated or released before
+ * the pool is destroyed, so pointers, references and iterators to an element stay valid until that
+ * element is erased, just like `std::list`. Erased nodes are pushed onto a free list and reused by
+ * later insertions, thus a solver that erases and creates a similar number of genes each generation
+ * stops calling malloc once the pool has grown to its peak size.
+ *
+ * Each node is also identified by a stable integer handle, which is smaller than an iterator and
+ * can be used to index into the pool through `at(handle_t)`.
+ *
+ * \tparam T Type of element
+ * \tparam slabSize Number of nodes in each slab. Must be a power of 2.
+ */
+template <class T, size_t slabSize = 512>
+class GenePool {
+  static_assert(slabSize > 0 && (slabSize & (slabSize - 1)) == 0, "slabSize must be a power of 2");
+
+ public:
+  /// Type of handle to an element
+  using handle_t = uint32_t;
+  /// Handle that refers to no element
+  static constexpr handle_t nullHandle = ~handle_t(0);
+
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+
+ private:
+  struct node_t {
+    alignas(T) unsigned char storage[sizeof(T)];
+    handle_t prev;
+    handle_t next;
+  };
+
+  template <bool isConst>
+  class iteratorBase {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = std::conditional_t<isConst, const T *, T *>;
+    using reference = std::conditional_t<isConst, const T &, T &>;
+    using pool_ptr_t = std::conditional_t<isConst, const GenePool *, GenePool *>;
+
+    iteratorBase() : pool(nullptr), idx(nullHandle) {}
+
+    /// non-const iterator can be converted to const iterator implicitly
+    template <bool otherConst, class = std::enable_if_t<isConst && !otherConst>>
+    iteratorBase(const iteratorBase<otherConst> &it) : pool(it.pool), idx(it.idx) {}
+
+    inline reference operator*() const noexcept { return *pool->ptrAt(idx); }
+    inline pointer operator->() const noexcept { return pool->ptrAt(idx); }
+
+    inline iteratorBase &operator++() noexcept {
+      idx = pool->nodeAt(idx).next;
+      return *this;
+    }
+
+    inline iteratorBase operator++(int) noexcept {
+      iteratorBase copy = *this;
+      ++(*this);
+      return copy;
+    }
+
+    inline iteratorBase &operator--() noexcept {
+      idx = (idx == nullHandle) ? (pool->_tail) : (pool->nodeAt(idx).prev);
+      return *this;
+    }
+
+    inline iteratorBase operator--(int) noexcept {
+      iteratorBase copy = *this;
+      --(*this);
+      return copy;
+    }
+
+    template <bool otherConst>
+    inline bool operator==(const iteratorBase<otherConst> &it) const noexcept {
+      return idx == it.idx;
+    }
+
+    template <bool otherConst>
+    inline bool operator!=(const iteratorBase<otherConst> &it) const noexcept {
+      return idx != it.idx;
+    }
+
+    /// Get the handle of the element that this iterator points to
+    inline handle_t handle() const noexcept { return idx; }
+
+   private:
+    friend class GenePool;
+    template <bool>
+    friend class iteratorBase;
+
+    iteratorBase(pool_ptr_t _pool, handle_t _idx) : pool(_pool), idx(_idx) {}
+
+    pool_ptr_t pool;
+    handle_t idx;
+  };
+
+ public:
+  using iterator = iteratorBase<false>;
+  using const_iterator = iteratorBase<true>;
+
+  GenePool() noexcept
+      : _head(nullHandle), _tail(nullHandle), _free(nullHandle), _used(0), _size(0) {}
+
+  GenePool(const GenePool &another) : GenePool() { this->operator=(another); }
+
+  GenePool(GenePool &&another) noexcept : GenePool() { this->swap(another); }
+
+  ~GenePool() { clear(); }
+
+  GenePool &operator=(const GenePool &another) {
+    if (this == &another) {
+      return *this;
+    }
+    clear();
+    reserve(another.size());
+    for (const T &val : another) {
+      emplace_back(val);
+    }
+    return *this;
+  }
+
+  GenePool &operator=(GenePool &&another) noexcept {
+    GenePool temp(std::move(another));
+    this->swap(temp);
+    return *this;
+  }
+
+  inline void swap(GenePool &another) noexcept {
+    std::swap(_slabs, another._slabs);
+    std::swap(_head, another._head);
+    std::swap(_tail, another._tail);
+    std::swap(_free, another._free);
+    std::swap(_used, another._used);
+    std::swap(_size, another._size);
+  }
+
+  inline iterator begin() noexcept { return iterator(this, _head); }
+  inline iterator end() noexcept { return iterator(this, nullHandle); }
+  inline const_iterator begin() const noexcept { return const_iterator(this, _head); }
+  inline const_iterator end() const noexcept { return const_iterator(this, nullHandle); }
+  inline const_iterator cbegin() const noexcept { return begin(); }
+  inline const_iterator cend() const noexcept { return end(); }
+
+  inline size_t size() const noexcept { return _size; }
+  inline bool empty() const noexcept { return _size <= 0; }
+
+  /**
+   * \brief Number of nodes that have been allocated, including both used and free nodes.
+   */
+  inline size_t capacity() const noexcept { return _slabs.size() * slabSize; }
+
+  inline T &front() noexcept { return *ptrAt(_head); }
+  inline const T &front() const noexcept { return *ptrAt(_head); }
+  inline T &back() noexcept { return *ptrAt(_tail); }
+  inline const T &back() const noexcept { return *ptrAt(_tail); }
+
+  /**
+   * \brief Access element by its handle.
+   *
+   * \param h Handle of an element. It's acquired from `iterator::handle()` and remains valid until
+   * the element is erased.
+   */
+  inline T &at(handle_t h) noexcept { return *ptrAt(h); }
+  inline const T &at(handle_t h) const noexcept { return *ptrAt(h); }
+
+  /**
+   * \brief Allocate slabs in advance so that at least `n` elements can be stored without allocating
+   * more memory.
+   */
+  void reserve(size_t n) {
+    while (capacity() < n) {
+      appendSlab();
+    }
+  }
+
+  template <class... Args>
+  T &emplace_back(Args &&...args) {
+    const handle_t h = allocateNode();
+    new (ptrAt(h)) T(std::forward<Args>(args)...);
+    node_t &n = nodeAt(h);
+    n.prev = _tail;
+    n.next = nullHandle;
+    if (_tail != nullHandle) {
+      nodeAt(_tail).next = h;
+    } else {
+      _head = h;
+    }
+    _tail = h;
+    _size++;
+    return *ptrAt(h);
+  }
+
+  inline void push_back(const T &val) { emplace_back(val); }
+  inline void push_back(T &&val) { emplace_back(std::move(val)); }
+
+  inline void pop_back() noexcept { erase(const_iterator(this, _tail)); }
+
+  /**
+   * \brief Erase an element and return the iterator to the next one.
+   */
+  iterator erase(const_iterator it) noexcept {
+    const handle_t h = it.idx;
+    assert(h != nullHandle);
+    node_t &n = nodeAt(h);
+    const handle_t next = n.next;
+
+    if (n.prev != nullHandle) {
+      nodeAt(n.prev).next = n.next;
+    } else {
+      _head = n.next;
+    }
+    if (n.next != nullHandle) {
+      nodeAt(n.next).prev = n.prev;
+    } else {
+      _tail = n.prev;
+    }
+
+    ptrAt(h)->~T();
+    n.next = _free;
+    n.prev = nullHandle;
+    _free = h;
+    _size--;
+    return iterator(this, next);
+  }
+
+  void resize(size_t n) {
+    while (_size > n) {
+      pop_back();
+    }
+    reserve(n);
+    while (_size < n) {
+      emplace_back();
+    }
+  }
+
+  /**
+   * \brief Destroy all elements. Allocated slabs are kept for reuse.
+   */
+  void clear() noexcept {
+    for (handle_t h = _head; h != nullHandle;) {
+      const handle_t next = nodeAt(h).next;
+      ptrAt(h)->~T();
+      h = next;
+    }
+    _head = nullHandle;
+    _tail = nullHandle;
+    _free = nullHandle;
+    _used = 0;
+    _size = 0;
+  }
+
+ private:
+  std::vector<std::unique_ptr<node_t[]>> _slabs;  ///< Slabs of nodes
+  handle_t _head;                                 ///< Handle of the first element
+  handle_t _tail;                                 ///< Handle of the last element
+  handle_t _free;                                 ///< Head of free list
+  size_t _used;  ///< Nodes that have been touched. Nodes after it have never been used.
+  size_t _size;  ///< Number of elements
+
+  inline node_t &nodeAt(handle_t h) noexcept {
+    assert(h < _used);
+    return _slabs[h / slabSize][h % slabSize];
+  }
+
+  inline const node_t &nodeAt(handle_t h) const noexcept {
+    assert(h < _used);
+    return _slabs[h / slabSize][h % slabSize];
+  }
+
+  inline T *ptrAt(handle_t h) noexcept {
+    return std::launder(reinterpret_cast<T *>(nodeAt(h).storage));
+  }
+
+  inline const T *ptrAt(handle_t h) const noexcept {
+    return std::launder(reinterpret_cast<const T *>(nodeAt(h).storage));
+  }
+
+  inline void appendSlab() {
+    HEU_ASSERT(capacity() + slabSize <= size_t(nullHandle));
+    _slabs.emplace_back(new node_t[slabSize]);
+  }
+
+  inline handle_t allocateNode() {
+    if (_free != nullHandle) {
+      const handle_t h = _free;
+      _free = nodeAt(h).next;
+      return h;
+    }
+    if (_used >= capacity()) {
+      appendSlab();
+    }
+    return handle_t(_used++);
+  }
+};
+
+/**
+ * \ingroup HEU_GENETIC
+ * \struct GAPopulationContainer
+ * \brief Select the container type that genetic solvers use to store population of `Gene`.
+ *
+ * By default the population is stored in a `std::list<Gene>`. Define `HEU_GA_USE_GENEPOOL` before
+ * including HeuristicFlow to make every genetic solver use `GenePool<Gene>` instead, or specialize
+ * this struct for a certain gene type to select the container for solvers with that gene only. The
+ * container must provide the same interfaces as `GenePool`.
+ *
+ * \tparam Gene Type of gene
+ */
+template <class Gene>
+struct GAPopulationContainer {
+#ifdef HEU_GA_USE_GENEPOOL
+  using type = GenePool<Gene>;
+#else
+  using type = std::list<Gene>;
+#endif
+};
+
+}  // namespace heu
+
+#endif  //  HEU_GENEPOOL_HPP
@@ -52,7 +52,7 @@ constexpr bool is_GA_gene_v = std::is_same_v<decltype(__impl_fun_is_gene(G())),
 
 namespace {
 template <class G>
-static inline decltype(std::enable_if_t<is_GA_gene_v<G>>(), G().dominated_by_num, int())
+static inline decltype(std::enable_if_t<is_GA_gene_v<G>>(), G().pareto_rank, int())
 __impl_fun_is_NSGA_gene(const G &) {
   return 0;
 }
@@ -64,7 +64,7 @@ static inline void __impl_fun_is_NSGA_gene(...) { return; }
  * \ingroup HEU_GENETIC
  * \brief If class G fits the requirement of fundamental NSGA.
  * The gene must fit `is_GA_gene_v`, and have following members:
- * 1. `dominated_by_num`
+ * 1. `pareto_rank`
  *
  * \tparam G Type of gene
  * \sa is_GA_gene_v NSGABase
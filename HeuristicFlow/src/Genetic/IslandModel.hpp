@@ -0,0 +1,281 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_ISLANDMODEL_HPP
+#define HEU_ISLANDMODEL_HPP
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <HeuristicFlow/Global>
+#include "InternalHeaderCheck.h"
+
+namespace heu {
+
+/**
+ * \ingroup HEU_GENETIC
+ * \brief Topology of islands in IslandModel, which decides the destinations of migrants.
+ */
+enum class MigrationTopology : uint8_t {
+  /// Island i sends migrants to island (i+1)%K.
+  RING,
+  /// Islands are arranged in a grid whose edges wrap around. Each island sends migrants to its
+  /// right and lower neighbors.
+  TORUS,
+};
+
+/**
+ * \ingroup HEU_GENETIC
+ * \struct IslandOption
+ * \brief Options of IslandModel.
+ */
+struct IslandOption {
+ public:
+  /**
+   * \brief Construct and initialize all members to their default values.
+   */
+  IslandOption() {
+    islandNum = 4;
+    migrationInterval = 10;
+    migrantNum = 2;
+    topology = MigrationTopology::RING;
+    torusCols = 0;
+  }
+
+  /// Number of islands. Default value is 4.
+  size_t islandNum;
+
+  /// Islands exchange migrants every `migrationInterval` generations. Default value is 10.
+  size_t migrationInterval;
+
+  /// Number of genes that an island sends to each neighbor in a migration. Default value is 2.
+  size_t migrantNum;
+
+  /// Topology of islands. Default value is RING.
+  MigrationTopology topology;
+
+  /**
+   * \brief Number of columns of the grid for TORUS topology. It must divide `islandNum`. 0 means
+   * the grid is as square as possible. Default value is 0.
+   */
+  size_t torusCols;
+};
+
+/**
+ * \ingroup HEU_GENETIC
+ * \class IslandModel
+ * \brief Run several independent genetic solvers in parallel, and exchange genes among them
+ * periodically.
+ *
+ * Each island is a complete solver with its own population. Islands evolve on different threads
+ * for `migrationInterval` generations, then each island sends copies of `migrantNum` genes to its
+ * neighbors. For SOGA, emigrants are the best genes and they replace the worst genes of the
+ * destination. For NSGA2 and NSGA3, emigrants are random genes of the PF and they replace random
+ * genes out of the PF. Migration runs on the calling thread after all islands paused.
+ *
+ * Unlike parallel fitness evaluation, the selection, crossover and mutation steps are also run in
+ * parallel, so the island model scales with cores even if the fitness function is cheap. Parallel
+ * loops inside an island run serially.
+ *
+ * Each island draws random numbers from its own stream during each epoch, thus the result only
+ * depends on the master seed but not the number of threads (see `setRandomSeed`).
+ *
+ * \tparam Solver_t Type of genetic solver, i.e. SOGA, NSGA2 or NSGA3.
+ *
+ * Example:
+ * ```cpp
+ * solver_t prototype;
+ * prototype.setOption(gaOption);  // also set functions and args here
+ * heu::IslandModel<solver_t> islands(prototype, islandOption);
+ * islands.initializePop();
+ * islands.run();
+ * ```
+ */
+template <class Solver_t>
+class IslandModel {
+ public:
+  using Gene_t = typename Solver_t::Gene_t;
+
+  IslandModel() : _migrationTimes(0) {}
+
+  /**
+   * \brief Create islands as copies of `prototype`. They share its option, functions and args.
+   */
+  explicit IslandModel(const Solver_t& prototype, const IslandOption& opt = IslandOption())
+      : _option(opt), _migrationTimes(0) {
+    setIslands(prototype);
+  }
+
+  /// Set the option. Call `setIslands` to apply a new number of islands.
+  inline void setOption(const IslandOption& o) noexcept { _option = o; }
+
+  /// Get the option
+  inline const IslandOption& option() const noexcept { return _option; }
+
+  /**
+   * \brief Replace all islands with `option().islandNum` copies of `prototype`.
+   */
+  void setIslands(const Solver_t& prototype) noexcept {
+    HEU_ASSERT(_option.islandNum > 0);
+    _islands.assign(_option.islandNum, prototype);
+  }
+
+  /// Number of islands
+  inline size_t islandNum() const noexcept { return _islands.size(); }
+
+  /// Get an island. Islands can be configured separately through it.
+  inline Solver_t& island(size_t idx) noexcept { return _islands[idx]; }
+  inline const Solver_t& island(size_t idx) const noexcept { return _islands[idx]; }
+
+  /// Get all islands
+  inline const std::vector<Solver_t>& islands() const noexcept { return _islands; }
+
+  /// Number of migrations in the last run
+  inline size_t migrationTimes() const noexcept { return _migrationTimes; }
+
+  /**
+   * \brief Initialize the population of every island with its own random stream.
+   */
+  void initializePop() noexcept {
+    const uint64_t randRegion = internal::newRandStreamRegion();
+    parallel_for(0, int(_islands.size()), [&](int i) {
+      internal::RandStreamScope randScope(randRegion, i);
+      _islands[i].initializePop();
+    });
+  }
+
+  /**
+   * \brief Run all islands until every island terminates.
+   */
+  void run() noexcept {
+    const int K = int(_islands.size());
+    std::vector<uint8_t> running(K, true);
+    _migrationTimes = 0;
+
+    uint64_t randRegion = internal::newRandStreamRegion();
+    parallel_for(0, K, [&](int i) {
+      internal::RandStreamScope randScope(randRegion, i);
+      _islands[i].startRun();
+      running[i] = !_islands[i].isTerminated();
+    });
+
+    while (true) {
+      randRegion = internal::newRandStreamRegion();
+      parallel_for(0, K, [&](int i) {
+        internal::RandStreamScope randScope(randRegion, i);
+        for (size_t g = 0; running[i] && g < _option.migrationInterval; g++) {
+          running[i] = _islands[i].step() && !_islands[i].isTerminated();
+        }
+      });
+
+      if (std::find(running.begin(), running.end(), true) == running.end()) {
+        break;
+      }
+      migrate(running);
+    }
+  }
+
+  /**
+   * \brief Index of the island that has the best fitness. Only for single-objective solvers.
+   */
+  size_t bestIsland() const noexcept {
+    static_assert(std::is_same_v<decltype(std::declval<const Solver_t&>().bestFitness()), double>,
+                  "bestIsland is only available for single-objective solvers");
+    size_t best = 0;
+    for (size_t i = 1; i < _islands.size(); i++) {
+      const double a = _islands[i].bestFitness(), b = _islands[best].bestFitness();
+      if ((Solver_t::FitnessOpt == FITNESS_GREATER_BETTER) ? (a > b) : (a < b)) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * \brief Indices of islands that island `idx` sends migrants to.
+   */
+  std::vector<size_t> neighbors(size_t idx) const noexcept {
+    const size_t K = _islands.size();
+    std::vector<size_t> ret;
+    if (_option.topology == MigrationTopology::RING) {
+      ret.emplace_back((idx + 1) % K);
+    } else {
+      const size_t cols = torusCols();
+      const size_t rows = K / cols;
+      const size_t r = idx / cols, c = idx % cols;
+      ret.emplace_back(r * cols + (c + 1) % cols);
+      ret.emplace_back(((r + 1) % rows) * cols + c);
+    }
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    ret.erase(std::remove(ret.begin(), ret.end(), idx), ret.end());
+    return ret;
+  }
+
+ protected:
+  std::vector<Solver_t> _islands;
+  IslandOption _option;
+  size_t _migrationTimes;
+
+  size_t torusCols() const noexcept {
+    const size_t K = _islands.size();
+    if (_option.torusCols > 0) {
+      HEU_ASSERT(K % _option.torusCols == 0);
+      return _option.torusCols;
+    }
+    size_t cols = size_t(std::sqrt(double(K)));
+    while (K % cols != 0) {
+      cols--;
+    }
+    return cols;
+  }
+
+  /**
+   * \brief Send migrants along the topology. Islands that have terminated still send migrants but
+   * don't receive any.
+   */
+  void migrate(const std::vector<uint8_t>& running) noexcept {
+    const size_t K = _islands.size();
+    std::vector<std::vector<Gene_t>> emigrants(K), immigrants(K);
+    for (size_t i = 0; i < K; i++) {
+      _islands[i].selectEmigrants(_option.migrantNum, &emigrants[i]);
+    }
+    for (size_t i = 0; i < K; i++) {
+      for (size_t dst : neighbors(i)) {
+        immigrants[dst].insert(immigrants[dst].end(), emigrants[i].begin(), emigrants[i].end());
+      }
+    }
+    for (size_t i = 0; i < K; i++) {
+      if (running[i] && !immigrants[i].empty()) {
+        _islands[i].acceptImmigrants(immigrants[i]);
+      }
+    }
+    _migrationTimes++;
+  }
+};
+
+}  // namespace heu
+
+#endif  //  HEU_ISLANDMODEL_HPP
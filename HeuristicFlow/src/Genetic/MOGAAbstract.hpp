@@ -105,6 +105,24 @@ class MOGAAbstract : public GABase<Var_t, Eigen::Array<double, ObjNum, 1>, rOpt,
     }
   }
 
+  /**
+   * \brief Get Pareto front as a matrix, one column for each point. It's the layout used by
+   * ParetoMetrics.
+   *
+   * \param front Fitness values of the PF.
+   */
+  inline void paretoFront(Eigen::Array<double, ObjNum, Eigen::Dynamic>& front) const noexcept {
+    if (_pfGenes.empty()) {
+      front.resize(ObjNum == Eigen::Dynamic ? front.rows() : ObjNum, 0);
+      return;
+    }
+    front.resize((*_pfGenes.begin())->fitness.rows(), _pfGenes.size());
+    Eigen::Index c = 0;
+    for (const Gene* i : _pfGenes) {
+      front.col(c++) = i->fitness;
+    }
+  }
+
   /**
    * \brief Returns a const reference to member _pfGenes.
    *
@@ -112,12 +130,34 @@ class MOGAAbstract : public GABase<Var_t, Eigen::Array<double, ObjNum, 1>, rOpt,
    */
   inline const std::unordered_set<const Gene*>& pfGenes() const noexcept { return _pfGenes; }
 
+  /// Type of the external archive
+  using Archive_t = ParetoArchive<Var_t, ObjNum, fOpt>;
+
+  /**
+   * \brief Enable or disable the external archive. It's disabled by default.
+   *
+   * When enabled, the PF of each generation is inserted into `archive()`, so non-dominated
+   * solutions are kept even after they are selected out of the population. Set its capacity with
+   * `archive().setCapacity`. The archive is cleared by `initializePop`.
+   */
+  inline void setArchiveEnabled(bool enabled) noexcept { _isArchiveEnabled = enabled; }
+
+  /// Whether the external archive is enabled
+  inline bool isArchiveEnabled() const noexcept { return _isArchiveEnabled; }
+
+  /// The external archive of non-dominated solutions
+  inline const Archive_t& archive() const noexcept { return _archive; }
+
+  /// The external archive of non-dominated solutions
+  inline Archive_t& archive() noexcept { return _archive; }
+
   /**
    * \brief This function is reimplemented to resize the PF.
    *
    */
   inline void initializePop() noexcept {
     this->_pfGenes.clear();
+    this->_archive.clear();
     this->_pfGenes.reserve(this->_option.populationSize * 2);
     Base_t::initializePop();
   }
@@ -144,8 +184,115 @@ class MOGAAbstract : public GABase<Var_t, Eigen::Array<double, ObjNum, 1>, rOpt,
     return best;
   }
 
+  /**
+   * \brief Copy `n` random genes of the PF to `dst`. It's used by IslandModel to send migrants.
+   *
+   * \param n Number of emigrants. The whole PF is copied if it's smaller.
+   * \param dst Emigrants will be appended to it.
+   */
+  void selectEmigrants(size_t n, std::vector<Gene>* dst) const noexcept {
+    // go through the population instead of the hash set to make the order reproducible
+    std::vector<const Gene*> pf;
+    pf.reserve(_pfGenes.size());
+    for (const Gene& g : this->_population) {
+      if (_pfGenes.find(&g) != _pfGenes.end()) {
+        pf.emplace_back(&g);
+      }
+    }
+    n = std::min(n, pf.size());
+    for (size_t i = 0; i < n; i++) {
+      std::swap(pf[i], pf[randIdx(i, pf.size())]);
+      dst->emplace_back(*pf[i]);
+    }
+  }
+
+  /**
+   * \brief Replace random genes out of the PF with `immigrants`. It's used by IslandModel to
+   * receive migrants.
+   *
+   * The size of population is kept, thus immigrants are dropped if there aren't enough genes out of
+   * the PF. Immigrants must have their fitness computed.
+   */
+  void acceptImmigrants(const std::vector<Gene>& immigrants) noexcept {
+    std::vector<GeneIt_t> candidates;
+    candidates.reserve(this->_population.size());
+    for (GeneIt_t it = this->_population.begin(); it != this->_population.end(); ++it) {
+      if (_pfGenes.find(&*it) == _pfGenes.end()) {
+        candidates.emplace_back(it);
+      }
+    }
+    const size_t n = std::min(immigrants.size(), candidates.size());
+    for (size_t i = 0; i < n; i++) {
+      std::swap(candidates[i], candidates[randIdx(i, candidates.size())]);
+      this->_population.erase(candidates[i]);
+    }
+    for (size_t i = 0; i < n; i++) {
+      assert(immigrants[i].is_fitness_computed);
+      this->_population.emplace_back(immigrants[i]);
+    }
+  }
+
  protected:
   std::unordered_set<const Gene*> _pfGenes;  ///< A hash set to store the whole PF
+  Archive_t _archive;                        ///< External archive of non-dominated solutions
+  bool _isArchiveEnabled{false};             ///< Whether PF genes are inserted into _archive
+
+  /// Insert genes of the PF into the archive if it's enabled.
+  inline void updateArchive(const GeneIt_t* const pfs, const size_t curFrontSize) noexcept {
+    if (!_isArchiveEnabled) {
+      return;
+    }
+    for (size_t i = 0; i < curFrontSize; i++) {
+      _archive.insert(pfs[i]->decision_variable, pfs[i]->fitness);
+    }
+  }
+
+  /// Save which genes in the population belong to the PF, and solutions in the archive.
+  inline void __impl_saveExtraState(std::ostream& os) const noexcept {
+    std::vector<uint8_t> isPF;
+    isPF.reserve(this->_population.size());
+    for (const Gene& g : this->_population) {
+      isPF.emplace_back(_pfGenes.find(&g) != _pfGenes.end());
+    }
+    writeBinary(os, isPF);
+
+    writeBinary(os, uint64_t(_archive.size()));
+    for (const typename Archive_t::Entry& e : _archive.entries()) {
+      writeBinary(os, e.decision_variable);
+      writeBinary(os, e.fitness);
+    }
+  }
+
+  /// Rebuild the PF and the archive saved by `__impl_saveExtraState`.
+  inline bool __impl_loadExtraState(std::istream& is) noexcept {
+    std::vector<uint8_t> isPF;
+    if (!readBinary(is, &isPF) || isPF.size() != this->_population.size()) {
+      return false;
+    }
+    _pfGenes.clear();
+    size_t idx = 0;
+    for (const Gene& g : this->_population) {
+      if (isPF[idx++]) {
+        _pfGenes.emplace(&g);
+      }
+    }
+
+    // entries are mutually non-dominated and within the capacity, so they're inserted in order
+    uint64_t archiveSize;
+    if (!readBinary(is, &archiveSize)) {
+      return false;
+    }
+    _archive.clear();
+    for (uint64_t i = 0; i < archiveSize; i++) {
+      Var_t v;
+      Fitness_t f;
+      if (!readBinary(is, &v) || !readBinary(is, &f)) {
+        return false;
+      }
+      _archive.insert(v, f);
+    }
+    return true;
+  }
 
   /*
    * \brief Compute the hash checksum of current PF
@@ -89,11 +89,13 @@ class NSGA2
                                 _cFun_, _mFun_>;
 
   HEU_RELOAD_MEMBERFUCTION_RUN
+  HEU_RELOAD_MEMBERFUCTION_STEP
+  HEU_RELOAD_MEMBERFUCTION_RUNASYNC
+  HEU_RELOAD_MEMBERFUCTION_CHECKPOINT
 
  protected:
   /**
-   * \brief Sort according to infoUnitBase::dominated_by_num in an acsending order. This sorting
-   * step will seperate the whole population into several pareto layers.
+   * \brief Compare function used to sort by congestion in descending order.
    *
    * \param A
    * \param B
@@ -108,23 +110,47 @@ class NSGA2
   }
 
   /**
-   * \brief Template parameter objIdx is used to indicate how to compare 2 const infoUnit *.
+   * \brief Compute the congestion (crowding distance) of genes in a single layer.
    *
-   * \tparam objIdx Indicate which objective is compared when sorting.
-   * \param A
-   * \param B
-   * \return true objIdx's fitness of A is greater than B.
-   * \return false objIdx's fitness of A is not greater than B.
+   * Fitness values are copied into a matrix whose columns are genes, and each objective is
+   * argsorted on this matrix in parallel. Contributions of each objective are accumulated
+   * afterwards, thus objectives don't write to the same gene simultaneously.
    *
-   * \note This procedure actually has no relationship with template parameter fOpt, because sorting
-   * as fitness is simply used to compute congestion.
+   * \param layer Genes in the layer
+   * \param layerSize Number of genes in the layer
    */
-  template <int64_t objIdx>
-  inline static bool compareByFitness(const GeneIt_t &A, const GeneIt_t &B) noexcept {
-    static_assert(objIdx >= 0, "Invalid comparison flag");
-    // if (A == B) return false;
-    /// compare by fitness on single objective
-    return A->fitness[objIdx] < B->fitness[objIdx];
+  void computeCongestion(const GeneIt_t *layer, const size_t layerSize) noexcept {
+    const int objNum = int(this->objectiveNum());
+    Eigen::Array<double, ObjNum, Eigen::Dynamic> fitnessMat(objNum, layerSize);
+    Eigen::Array<double, ObjNum, Eigen::Dynamic> congestionMat(objNum, layerSize);
+    for (size_t i = 0; i < layerSize; i++) {
+      fitnessMat.col(i) = layer[i]->fitness;
+    }
+
+    parallel_for(0, objNum, [&](int objIdx) {
+      std::vector<uint32_t> order(layerSize);
+      for (size_t i = 0; i < layerSize; i++) {
+        order[i] = uint32_t(i);
+      }
+      std::sort(order.begin(), order.end(), [&fitnessMat, objIdx](uint32_t a, uint32_t b) {
+        return fitnessMat(objIdx, a) < fitnessMat(objIdx, b);
+      });
+
+      const double scale =
+          std::abs(fitnessMat(objIdx, order.front()) - fitnessMat(objIdx, order.back())) + 1e-10;
+
+      congestionMat(objIdx, order.front()) = internal::pinfD;
+      congestionMat(objIdx, order.back()) = internal::pinfD;
+      for (size_t idx = 1; idx + 1 < layerSize; idx++) {
+        congestionMat(objIdx, order[idx]) =
+            std::abs(fitnessMat(objIdx, order[idx - 1]) - fitnessMat(objIdx, order[idx + 1])) /
+            scale;
+      }
+    });
+
+    for (size_t i = 0; i < layerSize; i++) {
+      layer[i]->congestion = congestionMat.col(i).sum();
+    }
   }
 
   /**
@@ -147,30 +173,27 @@ class NSGA2
    * In detail, this function applies non-dominated sorting in following steps:
    * 1. Make a `std::vector` of `infoUnit2` named `pop` that each element corresponds to an element
    in
-   * population(`std::list<Gene>`).
+   * population(`std::list<Gene>` or `GenePool<Gene>`).
    * 2. Fill `this->sortSpace` (std::list<infoUnitBase*) with pointer to each member in `pop`.
-   * 3. Compute `infoUnit::dominated_by_num` for `pop`.
-   * 4. Sort elements in `this->sortSpace` according to `infoUnitBase::dominated_by_num`.
+   * 3. Compute the pareto rank (`Gene::pareto_rank`) for `pop` with `NSGABase::ndSorter`.
+   * 4. Group elements in `this->sortSpace` according to their pareto ranks.
    * 5. Divide the whole population into several nondominated layers. This function is implemented
    in `NSGABase`, and
-   * the result is stored in `this->pfLayers`. For better performance, each `std::vector<infoUnit
-   *>` will reserve space
-   * for the whole population. Here we use vector since sorting might happen in a single layer.
-   * 6. Make a `std::unordered_set` of `infoUnit2 *` named `selected` to store all selected genes.
-   Insert the Pareto
-   * frontier and each layers into `selected` until a layer can't be completedly inserted(I name
-   this layer *K*).
-   * Congestion are used to select several genes in *K*. Besides, there is a possible that a layer
-   is completed inserted
-   * and size of `selected` equals to user assigned population size. In that condition, jump
-   directly to step 10.
-   * 7. Sort the whole population according to every objective values to compute the congestion.
-   * 8. Sort elements in *K* by its congestion in descend order. Elements with greater congestion
-   have less index.
-   * 9. Inserts each element in *K* into `selected` (by index order) until size of `selected` equals
-   to user assigned
-   * population size(`GABase::_option.populationSize`).
-   * 10. Go through the whole population and erase if a gene doesn't exist in `selected`.
+   * the result is stored in `this->pfLayers`. Each `std::vector<GeneIt_t>` reserves space for
+   * exactly its layer. Here we use vector since sorting might happen in a single layer.
+   * 6. Accept layers in order until a layer can't be completedly accepted (I name this layer *K*).
+   * All genes whose pareto rank is less than K's are selected. Besides, there is a possible that a
+   * layer is completed accepted and the number of selected genes equals to user assigned population
+   * size. In that condition, jump directly to step 10.
+   * 7. Compute the congestion of genes in *K* (only *K*, because congestion of other layers is
+   * never used). See `computeCongestion`.
+   * 8. Partially sort elements in *K* by its congestion in descend order with `std::nth_element`,
+   * so that elements with greater congestion have less index.
+   * 9. The first elements in *K* are selected until the population size is reached. The pareto
+   * rank of the rest elements is increased by 1, so that a gene is selected if and only if its
+   * rank is not greater than K's.
+   * 10. Go through the whole population in a linear sweep and erase genes according to their rank.
+   * No hashing is needed.
 
 
    * Every sorting steps use `std::sort` and different comparision function are used to sort
@@ -179,11 +202,6 @@ class NSGA2
    *
    */
   void __impl_select() noexcept {
-    using cmpFun_t = bool (*)(const GeneIt_t &, const GeneIt_t &);
-    static constexpr size_t objCapacity =
-        (ObjNum == Eigen::Dynamic) ? (HEU_MAX_RUNTIME_OBJNUM) : ObjNum;
-    static const std::array<cmpFun_t, objCapacity> fitnessCmpFuns = expand<0, objCapacity - 1>();
-
     const size_t popSizeBefore = this->_population.size();
 
     this->sortSpace.clear();
@@ -194,113 +212,55 @@ class NSGA2
       this->sortSpace.back()->congestion = 0;
     }
 
-    this->calculateDominatedNum();
-
     this->divideLayers();
 
     const size_t PFSize = this->pfLayers.front().size();
     if (PFSize <= this->_option.populationSize)
       this->updatePF((this->pfLayers.front().data()), this->pfLayers.front().size());
 
-    std::unordered_set<Gene_t *> selected;
-    selected.reserve(this->_option.populationSize);
-    bool needCongestion = true;
-    while (true) {
-      // don't need to calculate congestion
-      if (selected.size() == this->_option.populationSize) {
-        needCongestion = false;
-        break;
-      }
-      // need to calculate congestion
-      if (selected.size() + this->pfLayers.front().size() > this->_option.populationSize) {
-        needCongestion = true;
-        break;
-      }
-      // emplace every element of this layer into selected
-      for (GeneIt_t i : this->pfLayers.front()) {
-        selected.emplace(&*i);
-      }
-      this->pfLayers.pop_front();
+    // Genes whose pareto rank is less than cutRank are selected
+    const size_t popSize = this->_option.populationSize;
+    size_t selectedNum = 0;
+    size_t cutRank = 0;
+    auto cutLayer = this->pfLayers.begin();
+    while (cutLayer != this->pfLayers.end() && selectedNum + cutLayer->size() <= popSize) {
+      selectedNum += cutLayer->size();
+      ++cutLayer;
+      ++cutRank;
     }
+    const bool needCongestion = (cutLayer != this->pfLayers.end()) && (selectedNum < popSize);
+
     // calculate congestion
     if (needCongestion) {
-      for (size_t objIdx = 0; objIdx < this->objectiveNum(); objIdx++) {
-        std::sort(this->sortSpace.data(), this->sortSpace.data() + this->sortSpace.size(),
-                  fitnessCmpFuns[objIdx]);
-
-        const double scale = std::abs(this->sortSpace.front()->fitness[objIdx] -
-                                      this->sortSpace.back()->fitness[objIdx]) +
-                             1e-10;
-
-        this->sortSpace.front()->congestion = internal::pinfD;
-        this->sortSpace.back()->congestion = internal::pinfD;
-
-        // calculate congestion on single object
-        for (size_t idx = 1; idx < popSizeBefore - 1; idx++) {
-          this->sortSpace[idx]->congestion +=
-
-              std::abs(this->sortSpace[idx - 1]->fitness[objIdx] -
-                       this->sortSpace[idx + 1]->fitness[objIdx]) /
-              scale;
-        }
-      }  // end sort on objIdx
-
-      // sort by congestion in the undetermined set
-      std::sort(this->pfLayers.front().data(),
-                this->pfLayers.front().data() + this->pfLayers.front().size(), compareByCongestion);
-
-      size_t idx = 0;
-      while (selected.size() < this->_option.populationSize) {
-        selected.emplace(&*this->pfLayers.front()[idx]);
-        idx++;
-      }
+      const size_t keepNum = popSize - selectedNum;
+      computeCongestion(cutLayer->data(), cutLayer->size());
+
+      // move genes with greatest congestion to the front of the layer
+      std::nth_element(cutLayer->data(), cutLayer->data() + keepNum,
+                       cutLayer->data() + cutLayer->size(), compareByCongestion);
 
+      // the first genes in the layer are selected, and the rest are moved to the next rank.
+      for (size_t idx = keepNum; idx < cutLayer->size(); idx++) {
+        (*cutLayer)[idx]->pareto_rank = cutRank + 1;
+      }
+      cutRank++;
     }  // end applying congestion
 
     // erase unselected
     for (GeneIt_t &i : this->sortSpace) {
-      if (selected.find(&*i) == selected.end()) {
+      if (i->pareto_rank >= cutRank) {
         this->_population.erase(i);
       }
     }
 
-    if (PFSize > this->_option.populationSize) {
-      std::vector<const Gene_t *> PF;
-      PF.reserve(selected.size());
-      for (auto i : selected) {
-        PF.emplace_back(i);
-      }
-      this->updatePF(PF.data(), PF.size());
+    // The PF is cut, and the selected part is at the front of the layer.
+    if (PFSize > popSize) {
+      this->updatePF(this->pfLayers.front().data(), popSize);
     }
 
     this->pfLayers.clear();
     this->sortSpace.clear();
   }
-
- private:
-  // some template metaprogramming to make a function pointer array as below:
-  // universialCompareFun<0>,universialCompareFun<1>,...,universialCompareFun<ObjNum-1>
-  using fun_t = bool (*)(const GeneIt_t &, const GeneIt_t &);
-
-  template <int64_t cur, int64_t max>
-  struct expandStruct {
-    inline static void expand(fun_t *dst) noexcept {
-      *dst = compareByFitness<cur>;
-      expandStruct<cur + 1, max>::expand(dst + 1);
-    }
-  };
-
-  template <int64_t max>
-  struct expandStruct<max, max> {
-    inline static void expand(fun_t *dst) noexcept { *dst = compareByFitness<max>; }
-  };
-
-  template <int64_t beg, int64_t end>
-  inline std::array<fun_t, end - beg + 1> expand() noexcept {
-    std::array<fun_t, end - beg + 1> funs;
-    expandStruct<beg, end>::expand(funs.data());
-    return funs;
-  }
 };
 
 }  // namespace heu
@@ -106,6 +106,9 @@ class NSGA3
   }
 
   HEU_RELOAD_MEMBERFUCTION_RUN
+  HEU_RELOAD_MEMBERFUCTION_STEP
+  HEU_RELOAD_MEMBERFUCTION_RUNASYNC
+  HEU_RELOAD_MEMBERFUCTION_CHECKPOINT
 };
 
 }  //  namespace heu
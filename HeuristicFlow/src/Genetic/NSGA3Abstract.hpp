@@ -19,8 +19,13 @@ This file is part of HeuristicFlow.
 #ifndef HEU_NSGA3ABSTRACT_HPP
 #define HEU_NSGA3ABSTRACT_HPP
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_set>
+#include <vector>
 
 #include "InternalHeaderCheck.h"
 #include "NSGABase.hpp"
@@ -29,6 +34,99 @@ namespace heu {
 
 namespace internal {
 
+/**
+ * \ingroup HEU_GENETIC
+ * \class ReferencePointCache
+ * \brief Process-wide cache of reference point matrices for NSGA3.
+ *
+ * RPs only depend on the number of objectives and the precisions, so solvers with the same
+ * settings share a single matrix, which is generated only once in the process. This class is
+ * thread-safe.
+ *
+ * RPs are generated with Das and Dennis’s method directly into a column-major matrix, and each
+ * column is the coordinate of a RP.
+ *
+ * \tparam ObjNum Number of objectives
+ */
+template <int ObjNum>
+class ReferencePointCache {
+ public:
+  /// Type of RP matrix. Each coloumn is the coordinate of a RP.
+  using RefMat_t = Eigen::Array<double, ObjNum, Eigen::Dynamic>;
+
+  /**
+   * \brief Get the RP matrix.
+   *
+   * \param dimN Number of objectives
+   * \param precision Precision of the outer layer (the only layer for single-layer RPs).
+   * \param innerPrecision Precision of the inner layer. 0 means single layer. Inner RPs come
+   * first in the matrix, and they are scaled by 1/sqrt(2).
+   * \return std::shared_ptr<const RefMat_t> Shared pointer to the matrix
+   */
+  static std::shared_ptr<const RefMat_t> get(const size_t dimN, const size_t precision,
+                                             const size_t innerPrecision = 0) noexcept {
+    static std::mutex mtx;
+    static std::map<std::array<size_t, 3>, std::shared_ptr<const RefMat_t>> cache;
+
+    std::lock_guard<std::mutex> lk(mtx);
+    std::shared_ptr<const RefMat_t>& ret = cache[{dimN, precision, innerPrecision}];
+    if (!ret) {
+      const size_t innerNum = (innerPrecision > 0) ? pointNum(dimN, innerPrecision) : 0;
+      std::shared_ptr<RefMat_t> rps = std::make_shared<RefMat_t>();
+      rps->resize(dimN, innerNum + pointNum(dimN, precision));
+      if (innerPrecision > 0) {
+        makeLayer(dimN, innerPrecision, 0.70710678118654752440, rps.get(), 0);
+      }
+      makeLayer(dimN, precision, 1.0, rps.get(), innerNum);
+      ret = rps;
+    }
+    return ret;
+  }
+
+  /// Number of RPs on a single layer
+  inline static size_t pointNum(const size_t dimN, const size_t precision) noexcept {
+    return NchooseK(dimN + precision - 1, precision);
+  }
+
+ private:
+  /**
+   * \brief Generate a layer of RPs with Das and Dennis’s method.
+   *
+   * Coordinates except the last one are enumerated like an odometer whose last digit changes
+   * fastest, and the last coordinate makes their sum equal to 1.
+   *
+   * \param dimN Number of objectives
+   * \param precision Precision of this layer
+   * \param scale All coordinates are multiplied by this value.
+   * \param dst Destination matrix
+   * \param col Index of the first column to fill
+   */
+  static void makeLayer(const size_t dimN, const size_t precision, const double scale,
+                        RefMat_t* dst, size_t col) noexcept {
+    std::vector<size_t> counts(dimN, 0);
+    size_t accum = 0;
+    while (true) {
+      for (size_t r = 0; r + 1 < dimN; r++) {
+        (*dst)(r, col) = double(counts[r]) / precision * scale;
+      }
+      (*dst)(dimN - 1, col) = (1.0 - double(accum) / precision) * scale;
+      col++;
+
+      int d = int(dimN) - 2;
+      while (d >= 0 && accum + 1 > precision) {
+        accum -= counts[d];
+        counts[d] = 0;
+        d--;
+      }
+      if (d < 0) {
+        break;
+      }
+      counts[d]++;
+      accum++;
+    }
+  }
+};
+
 /**
  * \ingroup HEU_GENETIC
  * \brief Internal base class for NSGA3.
@@ -77,19 +175,15 @@ class NSGA3Abstract : public NSGABase<Var_t, ObjNum, FITNESS_LESS_BETTER, rOpt,
   /// RP matrix. Each coloumn is the coordinate of a RP.
   RefMat_t referencePoses;
 
-  /**
-   * \brief Generate a series of reference points using Das and Dennis’s method.
-   *
-   * \param dimN Number of objectives
-   * \param precision Count of points, usually 3 to 5. Greater precision means much more RPs
-   * \param dst Where to put the PF points temporarly.
-   */
-  void computeReferencePointPoses(const size_t dimN, const size_t precision,
-                                  std::vector<Fitness_t>* dst) const noexcept {
-    dst->clear();
-    dst->reserve(NchooseK(dimN + precision - 1, precision));
+  /// Save the PF and RPs, since RPs are shuffled when they are made.
+  inline void __impl_saveExtraState(std::ostream& os) const noexcept {
+    Base_t::__impl_saveExtraState(os);
+    writeBinary(os, referencePoses);
+  }
 
-    pri_startRP(dimN, precision, dst);
+  /// Load the PF and RPs saved by `__impl_saveExtraState`.
+  inline bool __impl_loadExtraState(std::istream& is) noexcept {
+    return Base_t::__impl_loadExtraState(is) && readBinary(is, &referencePoses);
   }
 
   /**
@@ -103,8 +197,7 @@ class NSGA3Abstract : public NSGABase<Var_t, ObjNum, FITNESS_LESS_BETTER, rOpt,
    *
    * Detailed steps: (Steps same in NSGA2 won't be introduced again)
    * 1. Make a vector of `infoUnit3` and fill `this->sortSpace` (same as NSGA2)
-   * 2. Compute dominated number of the population. (same as NSGA2)
-   * 3. Divide the population into several layers. (same as NSGA2)
+   * 2. Compute pareto rank of the population and divide it into several layers. (same as NSGA2)
    * 4. Insert each layer into `selected` (`std::unordered_set<infoUnit3*>`) until a layer can't be
    * inserted entirely. (same as NSGA2).This undetermined layer is named `Fl`.
    * 5. Normalize procedure
@@ -143,7 +236,6 @@ class NSGA3Abstract : public NSGABase<Var_t, ObjNum, FITNESS_LESS_BETTER, rOpt,
     }
     */
 
-    this->calculateDominatedNum();
     this->divideLayers();
 
     const size_t PFSize = this->pfLayers.front().size();
@@ -184,23 +276,21 @@ class NSGA3Abstract : public NSGABase<Var_t, ObjNum, FITNESS_LESS_BETTER, rOpt,
 
     if (needRefPoint) {
       // Normalize procedure
-      std::unordered_multimap<RefPointIdx_t, Gene_t*>
-          Fl;  // Fl is stored in a multihash sothat we can find a gene by its related RP
-      Fl.reserve(FlPtr->size());
       normalize(selected, *FlPtr);
-      // use reference points' index(col idx) as key and genes related to this point as value.
-      std::unordered_map<RefPointIdx_t, size_t> refPoints;
-      refPoints.reserve(referencePoses.cols());
-      for (int i = 0; i < referencePoses.cols(); i++) {
-        refPoints.emplace(i, 0);
-      }
 
       // Associate procedure
-      associate(selected);
-      associate(*FlPtr, &Fl);
+      std::vector<Gene_t*> associateSpace;
+      associateSpace.reserve(selected.size() + FlPtr->size());
+      for (Gene_t* i : selected) {
+        associateSpace.emplace_back(i);
+      }
+      for (const GeneIt_t& i : *FlPtr) {
+        associateSpace.emplace_back(&*i);
+      }
+      associate(associateSpace.data(), associateSpace.size());
 
       // niche preservation procedure.
-      nichePreservation(&selected, &Fl, &refPoints);
+      nichePreservation(&selected, *FlPtr);
     }
 
     // erase all unselected genes
@@ -312,63 +402,54 @@ class NSGA3Abstract : public NSGABase<Var_t, ObjNum, FITNESS_LESS_BETTER, rOpt,
   }  //  normalize
 
   /**
-   * \brief Find the nearest RP of a gene.
+   * \brief Associate genes with their nearest RPs.
    *
-   * This word distance doesn't refer to euclidean distance but projection distance from the origin.
+   * This word distance doesn't refer to euclidean distance but the perpendicular distance from a
+   * gene's translated fitness `s` to the line that goes through the origin and a RP `w`, whose
+   * square is \f$ |s|^2-(\hat{w}^Ts)^2 \f$ where \f$ \hat{w}=w/|w| \f$. Thus the nearest RP of
+   * each gene is the one with maximum \f$ (\hat{w}^Ts)^2 \f$.
    *
-   * This step is relatively slow because of great amount of matrix computation.
+   * Genes are processed in blocks. For each block, their translated fitness are packed into a
+   * matrix `S` so that projections onto all RPs are computed by one matrix product
+   * \f$ \hat{W}^TS \f$ and then reduced by a per-column argmax. Blocks are computed in parallel.
    *
-   * \param s Gene's fitness value
-   * \param dist Pass distance through a double pointer.
-   * \return size_t The col-index of the nearest RP
+   * \param genes Genes to be associated. Their `closestRefPoint` and `distance` will be written.
+   * \param n Number of genes
    */
-  size_t findNearest(const Fitness_t& s, double* dist) const noexcept {
-    const auto& w = this->referencePoses;
-    // w.transpose times s
-    auto wT_s = w.matrix().transpose() * s.matrix();
-    // w.transpose times s times w
-    auto wT_s_w = w.rowwise() * (wT_s.array().transpose());
-    // w.transpose times s times w (colwise normalized)
-    Eigen::Array<double, ObjNum, Eigen::Dynamic> norm_wTsw =
-        wT_s_w.rowwise() / (w.colwise().squaredNorm());
-    auto s_sub_norm_wTsw = norm_wTsw.colwise() - s;
-    auto distance = s_sub_norm_wTsw.colwise().squaredNorm();
-
-    int minIdx;
-    *dist = distance.minCoeff(&minIdx);
-    return minIdx;
-  }
-
-  /**
-   * \brief Associate a selected ene with a reference point.
-   *
-   * \param selected hash set of selected genes
-   */
-  void associate(const std::unordered_set<Gene_t*>& selected) const noexcept {
-    for (auto i : selected) {
-      i->closestRefPoint = findNearest(i->translatedFitness, &i->distance);
+  void associate(Gene_t* const* genes, const size_t n) const noexcept {
+    if (n <= 0) {
+      return;
     }
-  }
+    static constexpr int blockSize = 64;
+    const int M = this->objectiveNum();
+    const int blockNum = int((n + blockSize - 1) / blockSize);
 
-  /**
-   * \brief Associate an unselected gene with a reference point.
-   *
-   * \note Fl_src is a vector of infoUnit3*, while Fl_dst uses index of reference point as its key
-   * while gene as value.\n A unordered_multimap is employed cause a RP may be associated by more
-   * than one genes, but further procedure requires to find genes by their RP.
-   *
-   * In this function Fl's associated RP will be found and stored in a unordered_multimap.
-   *
-   * \param Fl_src Source of Fl
-   * \param Fl_dst Destination of Fl
-   */
-  void associate(const std::vector<GeneIt_t>& Fl_src,
-                 std::unordered_multimap<RefPointIdx_t, Gene_t*>* Fl_dst) const noexcept {
-    for (auto i : Fl_src) {
-      RefPointIdx_t idx = findNearest(i->translatedFitness, &i->distance);
-      i->closestRefPoint = idx;
-      Fl_dst->emplace(idx, &*i);
-    }
+    // transposed RPs with unit length, so that each row is a direction
+    const Eigen::Matrix<double, Eigen::Dynamic, ObjNum> unitRP_T =
+        (referencePoses.rowwise() / referencePoses.colwise().norm()).matrix().transpose();
+
+    parallel_for(0, blockNum, [&](int b) {
+      const size_t begin = size_t(b) * blockSize;
+      const int cols = int(std::min<size_t>(blockSize, n - begin));
+
+      Eigen::Matrix<double, ObjNum, Eigen::Dynamic> S(M, cols);
+      for (int c = 0; c < cols; c++) {
+        S.col(c) = genes[begin + c]->translatedFitness.matrix();
+      }
+
+      // evaluate the product before squaring it, otherwise Eigen won't use GEMM
+      Eigen::MatrixXd projSquare;
+      projSquare.noalias() = unitRP_T * S;
+      projSquare.array() = projSquare.array().square();
+
+      for (int c = 0; c < cols; c++) {
+        Gene_t* g = genes[begin + c];
+        int maxIdx;
+        const double maxProjSquare = projSquare.col(c).maxCoeff(&maxIdx);
+        g->closestRefPoint = maxIdx;
+        g->distance = std::max(0.0, S.col(c).squaredNorm() - maxProjSquare);
+      }
+    });
   }  // associate
 
   /**
@@ -378,127 +459,97 @@ class NSGA3Abstract : public NSGABase<Var_t, ObjNum, FITNESS_LESS_BETTER, rOpt,
    * 1. The algorithm goes through all reference points, firstly trying to find a RP with least
    * nicheCount (if multiple RPs has the same nicheCount, choose one stochastically).
    * 2. After chooseing a RP, NSGA3 then tries to find its associated genes in Fl(Always remember we
-   * need to select part of Fl). If multiple genes are found, choose the closest gene. If no gene is
-   * found, erase this RP and find a new one.
+   * need to select part of Fl). If its nicheCount is 0, choose the closest gene, otherwise choose a
+   * random gene. RPs that are not associated by any gene in Fl are never chosen.
    * 3. The gene chosen in previous step is emplaced to selected, and its RP's nicheCount adds by
    * one.
    *
    * Run the previous steps until selected's size is equal to assigend population size.
    *
+   * RPs are kept in buckets indexed by their nicheCount, and the least non-empty bucket only moves
+   * forward since nicheCount never decreases. Genes of Fl are grouped by their RPs, and a picked
+   * gene is swapped to the back of its group and removed. So each pick costs O(1) amortized time
+   * instead of scanning all RPs.
+   *
    * \param selected Selected genes (refers to S_t/F_l in the paper)
    * \param Fl (F_l in the paper)
-   * \param refPoints hash map (RP as key and niche count as value)
    */
   void nichePreservation(std::unordered_set<Gene_t*>* selected,
-                         std::unordered_multimap<RefPointIdx_t, Gene_t*>* Fl,
-                         std::unordered_map<RefPointIdx_t, size_t>* refPoints) const noexcept {
-    for (auto i : *selected) {
-      refPoints->operator[](i->closestRefPoint)++;
+                         const std::vector<GeneIt_t>& Fl) const noexcept {
+    const size_t RPNum = referencePoses.cols();
+    std::vector<size_t> nicheCount(RPNum, 0);
+    for (const Gene_t* i : *selected) {
+      nicheCount[i->closestRefPoint]++;
     }
 
-    std::vector<std::unordered_map<RefPointIdx_t, size_t>::iterator> minNicheIterators;
-    minNicheIterators.reserve(refPoints->size());
+    // genes in Fl grouped by their RPs
+    std::vector<std::vector<Gene_t*>> candidates(RPNum);
+    for (const GeneIt_t& i : Fl) {
+      candidates[i->closestRefPoint].emplace_back(&*i);
+    }
 
-    std::pair<typename std::unordered_multimap<RefPointIdx_t, Gene_t*>::iterator,
-              typename std::unordered_multimap<RefPointIdx_t, Gene_t*>::iterator>
-        associatedGenesInFl;
+    // buckets[c] are RPs that have candidates and whose nicheCount is c. RP j is stored at
+    // buckets[nicheCount[j]][posInBucket[j]].
+    std::vector<std::vector<RefPointIdx_t>> buckets;
+    std::vector<size_t> posInBucket(RPNum);
+    auto pushToBucket = [&](RefPointIdx_t rp) {
+      const size_t c = nicheCount[rp];
+      if (buckets.size() <= c) {
+        buckets.resize(c + 1);
+      }
+      posInBucket[rp] = buckets[c].size();
+      buckets[c].emplace_back(rp);
+    };
+    auto removeFromBucket = [&](RefPointIdx_t rp) {
+      std::vector<RefPointIdx_t>& bucket = buckets[nicheCount[rp]];
+      const RefPointIdx_t moved = bucket.back();
+      bucket[posInBucket[rp]] = moved;
+      posInBucket[moved] = posInBucket[rp];
+      bucket.pop_back();
+    };
+
+    for (RefPointIdx_t rp = 0; rp < RPNum; rp++) {
+      if (!candidates[rp].empty()) {
+        pushToBucket(rp);
+      }
+    }
 
+    size_t minNiche = 0;
     while (selected->size() < this->_option.populationSize) {
-      findMinSet(*refPoints, &minNicheIterators);
-      auto curRefPoint = minNicheIterators[randIdx(minNicheIterators.size())];
-      size_t rhoJ = curRefPoint->second;
-
-      associatedGenesInFl = Fl->equal_range(curRefPoint->first);
-
-      if (associatedGenesInFl.first != associatedGenesInFl.second) {  //  not empty
-        typename std::unordered_multimap<RefPointIdx_t, Gene_t*>::iterator pickedGene;
-        if (rhoJ == 0) {
-          // find element in associatedGenesInFl with minimum distance
-          typename std::unordered_multimap<RefPointIdx_t, Gene_t*>::iterator minGene =
-              associatedGenesInFl.first;
-          for (auto it = associatedGenesInFl.first; it != associatedGenesInFl.second; ++it) {
-            if (it->second->distance < minGene->second->distance) {
-              minGene = it;
-            }
-          }
-          pickedGene = minGene;
-        } else {
-          // pick a random member in associatedGenesInFl
-          size_t N = 0;
-          for (auto it = associatedGenesInFl.first; it != associatedGenesInFl.second; ++it) {
-            N++;
-          }
-          for (auto it = associatedGenesInFl.first; it != associatedGenesInFl.second; ++it) {
-            if (randD() * N <= 1) {
-              pickedGene = it;
-              break;
-            }
-            N--;
+      while (minNiche < buckets.size() && buckets[minNiche].empty()) {
+        minNiche++;
+      }
+      assert(minNiche < buckets.size());
+
+      const RefPointIdx_t curRefPoint = buckets[minNiche][randIdx(buckets[minNiche].size())];
+      std::vector<Gene_t*>& genes = candidates[curRefPoint];
+
+      size_t pickedIdx;
+      if (nicheCount[curRefPoint] == 0) {
+        // find the gene with minimum distance
+        pickedIdx = 0;
+        for (size_t idx = 1; idx < genes.size(); idx++) {
+          if (genes[idx]->distance < genes[pickedIdx]->distance) {
+            pickedIdx = idx;
           }
         }
-
-        selected->emplace(pickedGene->second);
-        Fl->erase(pickedGene);
-        curRefPoint->second++;
       } else {
-        refPoints->erase(curRefPoint);
+        pickedIdx = randIdx(genes.size());
       }
-    }  //  end while
-  }
 
-  /**
-   * \brief Find a subset of Refpoints that has least nicheCount.
-   *
-   * \param refPoints Refpoints with their nicheCount
-   * \param minNicheIterators Destination vector to put the result.
-   */
-  inline static void findMinSet(std::unordered_map<RefPointIdx_t, size_t>& refPoints,
-                                std::vector<std::unordered_map<RefPointIdx_t, size_t>::iterator>*
-                                    minNicheIterators) noexcept {
-    minNicheIterators->clear();
-    size_t minNiche = 0xFFFFFFFF;
-    for (auto i : refPoints) {
-      minNiche = std::min(minNiche, i.second);
-    }
-    for (auto it = refPoints.begin(); it != refPoints.end(); ++it) {
-      if (it->second == minNiche) {
-        minNicheIterators->emplace_back(it);
+      selected->emplace(genes[pickedIdx]);
+      std::swap(genes[pickedIdx], genes.back());
+      genes.pop_back();
+
+      removeFromBucket(curRefPoint);
+      nicheCount[curRefPoint]++;
+      if (!genes.empty()) {
+        pushToBucket(curRefPoint);
       }
-    }
+    }  //  end while
   }
 
  private:
-  // make reference points with Das and Dennis’s method recrusively.
-  void pri_makeRP(const size_t dimN, const size_t precision, const size_t curDim, const size_t,
-                  const size_t accum, Fitness_t* rec, std::vector<Fitness_t>* dst) const noexcept {
-    if (curDim + 1 >= dimN) {
-      rec->operator[](dimN - 1) = 1.0 - double(accum) / precision;
-      dst->emplace_back(*rec);
-      return;
-    }
-
-    for (size_t p = 0; p + accum <= precision; p++) {
-      if (curDim >= 0) rec->operator[](curDim) = double(p) / precision;
-      pri_makeRP(dimN, precision, curDim + 1, p, accum + p, rec, dst);
-    }
-  }
-
-  void pri_startRP(const size_t dimN, const size_t precision,
-                   std::vector<Fitness_t>* dst) const noexcept {
-    Fitness_t rec;
-#if __cplusplus >= 201703L
-    if constexpr (ObjNum == Eigen::Dynamic) {
-      rec.resize(this->objectiveNum());
-    }
-#else
-    if (ObjNum == Eigen::Dynamic) {
-      rec.resize(this->objectiveNum());
-    }
-#endif
-
-    pri_makeRP(dimN, precision, 0, 0, 0, &rec, dst);
-  }
-
   inline static bool isSingular(const Eigen::Array<double, ObjNum, ObjNum>& mat) noexcept {
     return std::abs(mat.matrix().determinant()) <= 1e-10;
   }
@@ -106,7 +106,7 @@ class NSGA3Base
    * \return size_t Number of RPs
    */
   size_t referencePointCount() const noexcept {
-    return NchooseK(_precision + this->objectiveNum() - 1, _precision);
+    return ReferencePointCache<ObjNum>::pointNum(this->objectiveNum(), _precision);
   }
 
  protected:
@@ -118,14 +118,16 @@ class NSGA3Base
    * This function is reloaded with different rpOpt.
    */
   void makeReferencePoses() noexcept {
-    this->referencePoses.resize(this->objectiveNum(), referencePointCount());
-    std::vector<Fitness_t> rfP;
-    this->computeReferencePointPoses(this->objectiveNum(), _precision, &rfP);
-    std::shuffle(rfP.begin(), rfP.end(), global_mt19937());
+    const auto rfP = ReferencePointCache<ObjNum>::get(this->objectiveNum(), _precision);
+    // RPs are shuffled, so the cached matrix is copied in a random order of columns.
+    std::vector<int> order(rfP->cols());
+    for (int c = 0; c < int(order.size()); c++) {
+      order[c] = c;
+    }
+    std::shuffle(order.begin(), order.end(), thread_engine());
+    this->referencePoses.resize(this->objectiveNum(), rfP->cols());
     for (int c = 0; c < this->referencePoses.cols(); c++) {
-      for (int r = 0; r < this->referencePoses.rows(); r++) {
-        this->referencePoses(r, c) = rfP[c][r];
-      }
+      this->referencePoses.col(c) = rfP->col(order[c]);
     }
   }
 };
@@ -201,8 +203,8 @@ class NSGA3Base<Var_t, ObjNum, rOpt, DOUBLE_LAYER, Gene, Args_t, _iFun_, _fFun_,
   }
 
   inline size_t referencePointCount() const noexcept {
-    return NchooseK(_innerPrecision + this->objectiveNum() - 1, _innerPrecision) +
-           NchooseK(_outerPrecision + this->objectiveNum() - 1, _outerPrecision);
+    return ReferencePointCache<ObjNum>::pointNum(this->objectiveNum(), _innerPrecision) +
+           ReferencePointCache<ObjNum>::pointNum(this->objectiveNum(), _outerPrecision);
   }
 
  protected:
@@ -210,23 +212,8 @@ class NSGA3Base<Var_t, ObjNum, rOpt, DOUBLE_LAYER, Gene, Args_t, _iFun_, _fFun_,
   size_t _outerPrecision;  ///< Precision of outer layer
 
   void makeReferencePoses() noexcept {
-    this->referencePoses.resize(this->objectiveNum(), referencePointCount());
-    std::vector<Fitness_t> irfP, orfP;
-    std::shuffle(irfP.begin(), irfP.end(), global_mt19937());
-    std::shuffle(orfP.begin(), orfP.end(), global_mt19937());
-    this->computeReferencePointPoses(this->objectiveNum(), _innerPrecision, &irfP);
-    this->computeReferencePointPoses(this->objectiveNum(), _outerPrecision, &orfP);
-
-    for (size_t c = 0; c < (size_t)this->referencePoses.cols(); c++) {
-      for (size_t r = 0; r < this->objectiveNum(); r++) {
-        if (c < irfP.size()) {
-          this->referencePoses(r, c) = irfP[c][r] * 0.70710678118654752440;
-        } else {
-          this->referencePoses(r, c) = orfP[c - irfP.size()][r];
-        }
-      }
-    }
-
+    this->referencePoses = *ReferencePointCache<ObjNum>::get(this->objectiveNum(), _outerPrecision,
+                                                             _innerPrecision);
   }  //  makeReferencePoses()
 };
 
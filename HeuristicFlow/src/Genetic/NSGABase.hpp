@@ -85,67 +85,49 @@ class NSGABase
   std::list<std::vector<GeneIt_t>> pfLayers;
 
   /**
-   * \brief Compare function used to sort by dominatedNum in ascend.
+   * \brief Engine of non-dominated sorting. The algorithm is determined by ObjNum.
    *
-   * \param A The first input
-   * \param B The second input
-   * \return true A is dominated by less genes than B
-   * \return false A is dominated by more or equal genes than B
    */
-  inline static bool sortByDominatedNum(const GeneIt_t& A, const GeneIt_t& B) noexcept {
-    return (A->dominated_by_num) < (B->dominated_by_num);
-  }
-
-  // calculate dominated_by_num
+  NDSorter<ObjNum, fOpt> ndSorter;
 
   /**
-   * \brief Function to calculate infoUnitBase::dominated_by_num of a population.
+   * \brief Divide the population (in sortSpace) into non-dominated layers.
    *
+   * Pareto rank of each gene is computed by `ndSorter` and stored in `Gene::pareto_rank`, then
+   * genes are grouped into `pfLayers` by rank. The first layer is the PF, which is also inserted
+   * into the external archive if it's enabled.
    */
-  void calculateDominatedNum() noexcept {
-    const size_t popSizeBefore = sortSpace.size();
-#ifdef HEU_HAS_OPENMP
-    static const int32_t thN = threadNum();
-#pragma omp parallel for schedule(dynamic, popSizeBefore / thN)
-    for (int ed = 0; ed < popSizeBefore; ed++) {
-      sortSpace[ed]->dominated_by_num = 0;
-      for (int er = 0; er < int(popSizeBefore); er++) {
-        if (er == ed) continue;
-        sortSpace[ed]->dominated_by_num += Pareto<ObjNum, fOpt>::isStrongDominate(
-            &(sortSpace[er]->fitness), &(sortSpace[ed]->fitness));
-      }
+  void divideLayers() noexcept {
+    const size_t popSize = sortSpace.size();
+    pfLayers.clear();
+    if (popSize <= 0) {
+      return;
     }
 
-#else
-    for (size_t ed = 0; ed < popSizeBefore; ed++) {
-      sortSpace[ed]->dominated_by_num = 0;
-      for (size_t er = 0; er < popSizeBefore; er++) {
-        if (er == ed) continue;
-        sortSpace[ed]->dominated_by_num += Pareto<ObjNum, fOpt>::isStrongDominate(
-            &(sortSpace[er]->fitness), &(sortSpace[ed]->fitness));
-      }
+    std::vector<const Fitness_t*> fitnesses(popSize);
+    for (size_t i = 0; i < popSize; i++) {
+      fitnesses[i] = &sortSpace[i]->fitness;
     }
-#endif
+    std::vector<size_t> ranks(popSize);
+    const size_t layerNum = ndSorter.sort(fitnesses.data(), popSize, ranks.data());
 
-  }  // calculateDominatedNum
+    std::vector<size_t> layerSizes(layerNum, 0);
+    for (size_t i = 0; i < popSize; i++) {
+      sortSpace[i]->pareto_rank = ranks[i];
+      layerSizes[ranks[i]]++;
+    }
 
-  /**
-   * \brief Divide the sorted population (is sortSpace) into a few non-dominated layers.
-   *
-   */
-  void divideLayers() noexcept {
-    std::sort(sortSpace.begin(), sortSpace.end(), sortByDominatedNum);
-    pfLayers.clear();
-    const size_t popSizeBef = sortSpace.size();
-    size_t curDM = -1;
-    for (auto i : sortSpace) {
-      if (curDM != i->dominated_by_num) {
-        curDM = i->dominated_by_num;
-        pfLayers.emplace_back();
-        pfLayers.back().reserve(popSizeBef);
-      }
-      pfLayers.back().emplace_back(i);
+    std::vector<std::vector<GeneIt_t>*> layers(layerNum);
+    for (size_t r = 0; r < layerNum; r++) {
+      pfLayers.emplace_back();
+      pfLayers.back().reserve(layerSizes[r]);
+      layers[r] = &pfLayers.back();
+    }
+    for (size_t i = 0; i < popSize; i++) {
+      layers[ranks[i]]->emplace_back(sortSpace[i]);
     }
+
+    this->updateArchive(pfLayers.front().data(), pfLayers.front().size());
   }
 
   /**
@@ -72,10 +72,28 @@ namespace heu {
  * - `void setOption(const GAOption&)` sets the option of solver.
  * - `void initializePop()` that initialized the population.
  * - `void run()` runs the genetic algorithm.
+ * - `void run(Observer_t&&)` runs the genetic algorithm and calls the observer with a const
+ * reference to the solver after each generation. The run stops once the observer returns false.
+ * `runAsync` accepts an observer as well. See `internal::notifyObserver`.
+ * - `void startRun()` and `bool step()` run the genetic algorithm generation by generation.
+ * `run()` equals to calling `startRun()` once and then `step()` until it returns false.
+ * - `void runAsync()` runs the genetic algorithm in asynchronous steady-state mode, where children
+ * are evaluated and inserted into the population without generational barriers. It suits fitness
+ * functions whose cost varies a lot. Workers call the fitness function or the batch fitness
+ * function concurrently, so it must be thread-safe.
+ * - `void selectEmigrants(size_t, std::vector<Gene_t>*) const` and
+ * `void acceptImmigrants(const std::vector<Gene_t>&)` exchange genes with other solvers. See
+ * IslandModel.
  * - `Fitness_t bestFitness() const` returns the fitness of best solution in current population.
  * - `size_t generation() const` returns the generation that solvers has passed.
  * - `size_t failTimes() const` returns the fail times of current population.
- * - `const std::list<Gene_t> & population() const` returns a const-reference to the population.
+ * - `size_t evaluationCount() const` returns the number of fitness evaluations in current run.
+ * - `const SolverProfile& profile() const` returns time spent in each phase of current run if
+ * `HEU_DO_PROFILING` is defined.
+ * Evaluation budget, time limit, target fitness and cancellation are set in
+ * `GAOption::termination`. See TerminationCriteria.
+ * - `const poplist_t & population() const` returns a const-reference to the population, which is
+ * `std::list<Gene_t>` by default. See `GAPopulationContainer`.
  * - `const GAOption & option() const` returns a const-reference to the GAOption of solver.
  * - `typename solver_t::initializeFun` is the type of iFuns
  * - `typename solver_t::fitnessFun` is the type of fFuns
@@ -92,6 +110,18 @@ namespace heu {
  * - `const Arg_t & args() const` returns a const-reference of args.
  * - `void setArgs(const Arg_t &)` set the value of args.
  *
+ * ## APIs that all genetic solvers whose `Var_t` is a vector/matrix of numbers have:
+ * - `void setBatchfFun(batchFitnessFun)` sets a fitness function that evaluates all uncomputed
+ * genes in one call. See `internal::BatchFitnessBody`.
+ * - `bool hasBatchfFun() const` returns whether a batch fitness function is set.
+ *
+ * ## APIs that all genetic solvers whose `Var_t` is a number or a vector/matrix of numbers have:
+ * - `void setFitnessCacheCapacity(size_t)` enables a bounded cache that maps decision variables to
+ * fitness, so identical genes are not evaluated again. 0 disables it. See
+ * `internal::FitnessCacheBody`.
+ * - `size_t fitnessCacheHits() const` and `size_t fitnessCacheMisses() const` return the number of
+ * genes found and not found in the cache.
+ *
  * ## APIs that all genetic solvers with recording have:
  * - `const std::vector<Fitness_t> & record() const` returns a const reference to the recoding.
  *
@@ -131,6 +161,9 @@ class SOGA : public internal::GABase<Var_t, double, Record, internal::DefaultGen
   ~SOGA() = default;
 
   HEU_RELOAD_MEMBERFUCTION_RUN
+  HEU_RELOAD_MEMBERFUCTION_STEP
+  HEU_RELOAD_MEMBERFUCTION_RUNASYNC
+  HEU_RELOAD_MEMBERFUCTION_CHECKPOINT
 
   static constexpr FitnessOption FitnessOpt = fOpt;
 
@@ -164,8 +197,61 @@ class SOGA : public internal::GABase<Var_t, double, Record, internal::DefaultGen
     _bestGene = this->_population.begin();
   }
 
+  /**
+   * \brief Copy the best `n` genes to `dst`. It's used by IslandModel to send migrants.
+   *
+   * \param n Number of emigrants. All genes are copied if the population is smaller.
+   * \param dst Emigrants will be appended to it.
+   */
+  void selectEmigrants(size_t n, std::vector<Gene_t>* dst) const noexcept {
+    std::vector<const Gene_t*> sorted;
+    sorted.reserve(this->_population.size());
+    for (const Gene_t& g : this->_population) {
+      sorted.emplace_back(&g);
+    }
+    n = std::min(n, sorted.size());
+    std::partial_sort(
+        sorted.begin(), sorted.begin() + n, sorted.end(),
+        [](const Gene_t* a, const Gene_t* b) { return isBetter(a->fitness, b->fitness); });
+    for (size_t i = 0; i < n; i++) {
+      dst->emplace_back(*sorted[i]);
+    }
+  }
+
+  /**
+   * \brief Replace the worst genes with `immigrants`. It's used by IslandModel to receive migrants.
+   *
+   * The size of population is kept, and the best gene is never replaced. Immigrants must have their
+   * fitness computed.
+   */
+  void acceptImmigrants(const std::vector<Gene_t>& immigrants) noexcept {
+    std::vector<GeneIt_t> candidates;
+    candidates.reserve(this->_population.size());
+    for (GeneIt_t it = this->_population.begin(); it != this->_population.end(); ++it) {
+      if (it != _bestGene) {
+        candidates.emplace_back(it);
+      }
+    }
+    const size_t n = std::min(immigrants.size(), candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end(),
+                      [](const GeneIt_t& a, const GeneIt_t& b) { return GeneItCompareFun(b, a); });
+    for (size_t i = 0; i < n; i++) {
+      this->_population.erase(candidates[i]);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      assert(immigrants[i].is_fitness_computed);
+      this->_population.emplace_back(immigrants[i]);
+      if (isBetter(immigrants[i].fitness, _bestGene->fitness)) {
+        _bestGene = std::prev(this->_population.end());
+      }
+    }
+  }
+
  protected:
-  GeneIt_t _bestGene;  ///< Iterator the the elite
+  GeneIt_t _bestGene;                  ///< Iterator the the elite
+  internal::WeightedSampler _sampler;  ///< Sampler for roulette-like selections
+
   /**
    * \brief Returns whether A is better than B
    *
@@ -203,6 +289,27 @@ class SOGA : public internal::GABase<Var_t, double, Record, internal::DefaultGen
     }
   }
 
+  /**
+   * \brief Keep `keepNum` candidates and erase the others. Candidates to keep are drawn without
+   * replacement with probability proportional to their weights.
+   *
+   * Each draw costs O(log N) with `WeightedSampler`.
+   */
+  inline void applyErasementByWeights(const std::vector<GeneIt_t>& candidates,
+                                      const std::vector<double>& weights,
+                                      size_t keepNum) noexcept {
+    assert(candidates.size() == weights.size());
+    _sampler.reset(weights);
+    while (_sampler.size() > 0 && _sampler.capacity() - _sampler.size() < keepNum) {
+      _sampler.draw();
+    }
+    for (size_t idx = 0; idx < candidates.size(); idx++) {
+      if (!_sampler.isDrawn(idx)) {
+        this->_population.erase(candidates[idx]);
+      }
+    }
+  }
+
   inline void updateFailTimesAndBestGene(const GeneIt_t& newBestGeneIt,
                                          const double prevFitess) noexcept {
     if (!isBetter(newBestGeneIt->fitness, prevFitess)) {
@@ -212,6 +319,25 @@ class SOGA : public internal::GABase<Var_t, double, Record, internal::DefaultGen
       this->_failTimes = 0;
       _bestGene = newBestGeneIt;
     }
+    this->_termination.template reportBestFitness<fOpt>(this->_option.termination,
+                                                        _bestGene->fitness);
+  }
+
+  /// Save the position of the elite in the population.
+  inline void __impl_saveExtraState(std::ostream& os) const noexcept {
+    using ConstIt_t = typename Base_t::poplist_t::const_iterator;
+    internal::writeBinary(os,
+                          uint64_t(std::distance(this->_population.begin(), ConstIt_t(_bestGene))));
+  }
+
+  /// Load the position of the elite.
+  inline bool __impl_loadExtraState(std::istream& is) noexcept {
+    uint64_t bestIdx = 0;
+    if (!internal::readBinary(is, &bestIdx) || bestIdx >= this->_population.size()) {
+      return false;
+    }
+    _bestGene = std::next(this->_population.begin(), bestIdx);
+    return true;
   }
 
   /**
@@ -55,7 +55,7 @@ class SOGASelector<SelectMethod::Truncation> {
 
     using GeneIt_t = typename this_t::GeneIt_t;
 
-    std::list<Gene_t>& popRef = static_cast<this_t*>(this)->_population;
+    auto& popRef = static_cast<this_t*>(this)->_population;
     std::vector<GeneIt_t> sortSpace;
     sortSpace.clear();
     sortSpace.reserve((popRef.size()));
@@ -93,18 +93,11 @@ class SOGASelector<SelectMethod::RouletteWheel> {
     using GeneIt_t = typename this_t::GeneIt_t;
 
     /*
-     * In this function, the linked list `eliminateSpace` stores all candidates to be eliminated.
-     * At first it has all candidates, and as the loop running, we erase a candidate from
-     * `eliminateSpace` where stores candidates waiting to be eliminated, symbolizing this
-     * candidate is selected.
-     *
-     * When the size of `eliminateSpace` equals to eliminate num, all candidates inside
-     * this hashmap will be erased from the linked list `_population`
+     * In this function, `weights` stores the processed fitness of each candidate. Candidates are
+     * drawn from a WeightedSampler with probability proportional to their weights, and drawn
+     * candidates are selected. All the other candidates will be erased from `_population`.
      */
 
-    std::list<std::pair<GeneIt_t, double>>
-        eliminateSpace;  // Use the iterator as first and processed fitness as second
-
     // number of candidates that need to be eliminated.
     const int eliminateNum = int(static_cast<this_t*>(this)->_population.size() -
                                  static_cast<this_t*>(this)->_option.populationSize);
@@ -118,59 +111,32 @@ class SOGASelector<SelectMethod::RouletteWheel> {
           static_cast<this_t*>(this)->findCurrentBestGene(), previousBestFitness);
       return;
     }
-    // eliminateSpace.reserve(static_cast<this_t*>(this)->_population.size());
+
+    std::vector<GeneIt_t> candidates;
+    std::vector<double> weights;
+    candidates.reserve(static_cast<this_t*>(this)->_population.size());
+    weights.reserve(static_cast<this_t*>(this)->_population.size());
     double minFitness = pinfD;
-    // fill eliminateSpace and compute the min fitness
+    // fill candidates and compute the min fitness
     for (GeneIt_t it = static_cast<this_t*>(this)->_population.begin();
          it != static_cast<this_t*>(this)->_population.end(); ++it) {
+      candidates.emplace_back(it);
       // If fitness option is FITNESS_LESS_BETTER, take the inverse value
       if constexpr (this_t::FitnessOpt == FitnessOption::FITNESS_GREATER_BETTER) {
-        eliminateSpace.emplace_back(std::make_pair(it, it->fitness));
+        weights.emplace_back(it->fitness);
       } else {
-        eliminateSpace.emplace_back(std::make_pair(it, -it->fitness));
+        weights.emplace_back(-it->fitness);
       }
-      minFitness = std::min(minFitness, eliminateSpace.back().second);
+      minFitness = std::min(minFitness, weights.back());
     }
 
-    double processedFitnessSum = 0;
-    for (auto& pair : eliminateSpace) {
-      pair.second -= minFitness;
-      processedFitnessSum += pair.second;
-    }
-
-    // erase all selected candidates from eliminateSpace
-
-    while (int(eliminateSpace.size()) > eliminateNum) {
-      // erase a solution from eliminateSpace by its fitness
-      if (processedFitnessSum > 0) {
-        double r = randD(0, processedFitnessSum);
-        for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-          r -= it->second;
-          if (r <= 0) {
-            processedFitnessSum -= it->second;
-            eliminateSpace.erase(it);
-            break;
-          }
-        }
-
-        if (r > 0) {  // unlikely
-          processedFitnessSum -= eliminateSpace.back().second;
-          eliminateSpace.pop_back();
-        }
-
-      } else {
-        // select stochastically
-        const int sizeBeforeErasement = int(eliminateSpace.size());
-        for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-          if (randIdx(sizeBeforeErasement) == 0) {
-            eliminateSpace.erase(it);
-            break;
-          }
-        }
-      }
+    for (double& w : weights) {
+      w -= minFitness;
     }
 
-    static_cast<this_t*>(this)->applyErasement(eliminateSpace);
+    // If all weights are 0, candidates will be selected stochastically
+    static_cast<this_t*>(this)->applyErasementByWeights(
+        candidates, weights, static_cast<this_t*>(this)->_option.populationSize);
 
     static_cast<this_t*>(this)->updateFailTimesAndBestGene(
         static_cast<this_t*>(this)->findCurrentBestGene(), previousBestFitness);
@@ -235,7 +201,7 @@ class SOGASelector<SelectMethod::Tournament> {
       selectCounter.emplace(&it, 0);
     }
 
-    std::shuffle(tournamentSpace.begin(), tournamentSpace.end(), global_mt19937());
+    std::shuffle(tournamentSpace.begin(), tournamentSpace.end(), thread_engine());
 
     // apply tournament selection
     for (int playTimes = 0; playTimes < int(static_cast<this_t*>(this)->_option.populationSize);
@@ -282,11 +248,16 @@ class SOGASelector<SelectMethod::Tournament> {
       }
     }
 
-    for (auto& pair : selectCounter) {
-      while (pair.second > 0) {
-        // copy if a gene is selected for more than once
-        static_cast<this_t*>(this)->_population.emplace_back(*pair.first);
-        pair.second--;
+    // copy genes that are selected for more than once in the order of population, so that the
+    // population doesn't depend on addresses of genes
+    std::vector<Gene_t*> survivors;
+    survivors.reserve(static_cast<this_t*>(this)->_population.size());
+    for (Gene_t& g : static_cast<this_t*>(this)->_population) {
+      survivors.emplace_back(&g);
+    }
+    for (Gene_t* g : survivors) {
+      for (int& count = selectCounter[g]; count > 0; count--) {
+        static_cast<this_t*>(this)->_population.emplace_back(*g);
       }
     }
 
@@ -326,7 +297,7 @@ class SOGASelector<SelectMethod::MonteCarlo> {
       iterators.emplace_back(it);
     }
 
-    std::shuffle(iterators.begin(), iterators.end(), global_mt19937());
+    std::shuffle(iterators.begin(), iterators.end(), thread_engine());
 
     const int eliminateNum =
         popSizeBeforeSelection - int(static_cast<this_t*>(this)->_option.populationSize);
@@ -351,8 +322,8 @@ class SOGASelector<SelectMethod::Probability> {
   void __impl___impl_select() noexcept {
     using GeneIt_t = typename this_t::GeneIt_t;
 
-    std::list<std::pair<GeneIt_t, double>>
-        eliminateSpace;  // Use the iterator as first and processed fitness as second
+    std::vector<GeneIt_t> candidates;
+    std::vector<double> weights;  // processed fitness of each candidate
     const int prevPopSize = int(static_cast<this_t*>(this)->_population.size());
     const int K = int(static_cast<this_t*>(this)->_option.populationSize);
     // number of candidates that need to be eliminated.
@@ -373,33 +344,36 @@ class SOGASelector<SelectMethod::Probability> {
 
     {
       double minFitness = pinfD;
+      candidates.reserve(prevPopSize);
+      weights.reserve(prevPopSize);
       for (GeneIt_t it = static_cast<this_t*>(this)->_population.begin();
            it != static_cast<this_t*>(this)->_population.end(); ++it) {
+        candidates.emplace_back(it);
         // If fitness option is FITNESS_LESS_BETTER, take the inverse value
         if constexpr (this_t::FitnessOpt == FitnessOption::FITNESS_GREATER_BETTER) {
-          eliminateSpace.emplace_back(std::make_pair(it, it->fitness));
+          weights.emplace_back(it->fitness);
         } else {
-          eliminateSpace.emplace_back(std::make_pair(it, -it->fitness));
+          weights.emplace_back(-it->fitness);
         }
 
-        minFitness = std::min(eliminateSpace.back().second, minFitness);
+        minFitness = std::min(weights.back(), minFitness);
       }
 
       //
       double fitnessSum = 0;
-      for (auto& pair : eliminateSpace) {
-        pair.second -= minFitness;
-        fitnessSum += pair.second;
+      for (double& w : weights) {
+        w -= minFitness;
+        fitnessSum += w;
       }
 
       //
       if (fitnessSum <= 0) {
-        for (auto& pair : eliminateSpace) {
-          pair.second = 1.0 / prevPopSize;
+        for (double& w : weights) {
+          w = 1.0 / prevPopSize;
         }
       } else {
-        for (auto& pair : eliminateSpace) {
-          pair.second /= fitnessSum;
+        for (double& w : weights) {
+          w /= fitnessSum;
         }
       }
     }
@@ -408,32 +382,11 @@ class SOGASelector<SelectMethod::Probability> {
     // const double NChooseK = ::heu::NchooseK<double>(prevPopSize, K);
     //  assert(!std::isnan(NChooseK));
 
-    double newProbSum = 0;
-    for (auto& pair : eliminateSpace) {
-      pair.second =
-          NChooseK * std::pow(pair.second, K) * std::pow(1.0 - pair.second, prevPopSize - K);
-      newProbSum += pair.second;
-    }
-
-    // assert(false);
-    while (int(eliminateSpace.size()) > eliminateNum) {
-      double r = randD(0.0, newProbSum);
-      for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-        r -= it->second;
-        if (r <= 0) {
-          newProbSum -= it->second;
-          eliminateSpace.erase(it);
-          break;
-        }
-      }
-
-      if (r > 0) {
-        newProbSum -= eliminateSpace.back().second;
-        eliminateSpace.pop_back();
-      }
+    for (double& w : weights) {
+      w = NChooseK * std::pow(w, K) * std::pow(1.0 - w, prevPopSize - K);
     }
 
-    static_cast<this_t*>(this)->applyErasement(eliminateSpace);
+    static_cast<this_t*>(this)->applyErasementByWeights(candidates, weights, K);
 
     static_cast<this_t*>(this)->updateFailTimesAndBestGene(
         static_cast<this_t*>(this)->findCurrentBestGene(), previousBestFitness);
@@ -508,37 +461,15 @@ class SOGASelector<SelectMethod::LinearRank> {
     const double nNegitive = _linearSelectWrostProbability * popSizeBeforeSelect;
     const double nPositive = _linearSelectBestProbability * popSizeBeforeSelect;
 
-    std::list<std::pair<GeneIt_t, double>> eliminateSpace;
+    std::vector<double> weights(sortSpace.size());
     for (int idx = 0; idx < int(sortSpace.size()); idx++) {
-      eliminateSpace.emplace_back(std::make_pair(
-          sortSpace[idx],
-
+      weights[idx] =
           (nNegitive +
            (nPositive - nNegitive) * (popSizeBeforeSelect - idx - 1) / (popSizeBeforeSelect - 1)) /
-              popSizeBeforeSelect
-
-          ));
-    }
-
-    double rMax = 1.0;
-    while (int(eliminateSpace.size()) > (popSizeBeforeSelect - K)) {
-      double r = randD(0, rMax);
-      for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-        r -= it->second;
-        if (r <= 0) {
-          rMax -= it->second;
-          eliminateSpace.erase(it);
-          break;
-        }
-      }
-
-      if (r > 0) {
-        rMax -= eliminateSpace.back().second;
-        eliminateSpace.pop_back();
-      }
+          popSizeBeforeSelect;
     }
 
-    static_cast<this_t*>(this)->applyErasement(eliminateSpace);
+    static_cast<this_t*>(this)->applyErasementByWeights(sortSpace, weights, K);
 
     static_cast<this_t*>(this)->updateFailTimesAndBestGene(
         static_cast<this_t*>(this)->findCurrentBestGene(), previousBestFitness);
@@ -599,35 +530,12 @@ class SOGASelector<SelectMethod::ExponentialRank> {
     const double c_minus_1_div_c_pow_N_minus_1 =
         (_exponetialSelectBase - 1) / (std::pow(_exponetialSelectBase, popSizeBeforeSelect) - 1);
 
-    std::list<std::pair<GeneIt_t, double>> eliminateSpace;
+    std::vector<double> weights(sortSpace.size());
     for (int idx = 0; idx < int(sortSpace.size()); idx++) {
-      eliminateSpace.emplace_back(std::make_pair(
-          sortSpace[idx],
-
-          c_minus_1_div_c_pow_N_minus_1 * std::pow(_exponetialSelectBase, idx)
-
-              ));
+      weights[idx] = c_minus_1_div_c_pow_N_minus_1 * std::pow(_exponetialSelectBase, idx);
     }
 
-    double rMax = 1.0;
-    while (int(eliminateSpace.size()) > popSizeBeforeSelect - K) {
-      double r = randD(0, rMax);
-      for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-        r -= it->second;
-        if (r <= 0) {
-          rMax -= it->second;
-          eliminateSpace.erase(it);
-          break;
-        }
-      }
-
-      if (r > 0) {
-        rMax -= eliminateSpace.back().second;
-        eliminateSpace.pop_back();
-      }
-    }
-
-    static_cast<this_t*>(this)->applyErasement(eliminateSpace);
+    static_cast<this_t*>(this)->applyErasementByWeights(sortSpace, weights, K);
 
     static_cast<this_t*>(this)->updateFailTimesAndBestGene(
         static_cast<this_t*>(this)->findCurrentBestGene(), previousBestFitness);
@@ -667,39 +575,19 @@ class SOGASelector<SelectMethod::Boltzmann> {
       return;
     }
 
-    std::list<std::pair<GeneIt_t, double>> eliminateSpace;
-    // double Z = 0;    //Z is erased because probability normalization is not guaranteed.
+    std::vector<GeneIt_t> candidates;
+    std::vector<double> weights;
+    candidates.reserve(popSizeBeforeSelect);
+    weights.reserve(popSizeBeforeSelect);
+    // Z is not computed because probability normalization is not guaranteed.
     for (GeneIt_t it = static_cast<this_t*>(this)->_population.begin();
          it != static_cast<this_t*>(this)->_population.end(); ++it) {
-      eliminateSpace.emplace_back(it, it->fitness);
-      // Z += std::exp(it->fitness);
-    }
-
-    double rMax = 0;  // the sum of "probability"
-    for (auto& pair : eliminateSpace) {
-      pair.second = std::exp(_boltzmannSelectStrength * pair.second);
-      rMax += pair.second;  //  the sum of probability may not be 1.
-    }
-
-    while (int(eliminateSpace.size()) > eliminateNum) {
-      double r = randD(0, rMax);
-
-      for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-        r -= it->second;
-        if (r <= 0) {
-          rMax -= it->second;
-          eliminateSpace.erase(it);
-          break;
-        }
-      }
-
-      if (r > 0) {
-        rMax -= eliminateSpace.back().second;
-        eliminateSpace.pop_back();
-      }
+      candidates.emplace_back(it);
+      weights.emplace_back(std::exp(_boltzmannSelectStrength * it->fitness));
     }
 
-    static_cast<this_t*>(this)->applyErasement(eliminateSpace);
+    static_cast<this_t*>(this)->applyErasementByWeights(
+        candidates, weights, static_cast<this_t*>(this)->_option.populationSize);
 
     static_cast<this_t*>(this)->updateFailTimesAndBestGene(
         static_cast<this_t*>(this)->findCurrentBestGene(), previousBestFitness);
@@ -840,7 +728,8 @@ class SOGASelector<SelectMethod::EliteReserved> {
       return;
     }
 
-    std::list<std::pair<GeneIt_t, double>> eliminateSpace;
+    std::vector<GeneIt_t> candidates;
+    std::vector<double> weights;
     double minFitness = pinfD;
     {
       std::vector<GeneIt_t> sortSpace(0);
@@ -854,53 +743,27 @@ class SOGASelector<SelectMethod::EliteReserved> {
 
       std::sort(sortSpace.begin(), sortSpace.end(), this_t::GeneItCompareFun);
 
-      for (int idx = _eliteNum; idx < int(sortSpace.size()); idx++) {
+      // elites are not candidates to be eliminated
+      candidates.assign(sortSpace.begin() + std::min(_eliteNum, popSizeBeforeSelect),
+                        sortSpace.end());
+      weights.reserve(candidates.size());
+      for (GeneIt_t it : candidates) {
         if constexpr (this_t::FitnessOpt == FitnessOption::FITNESS_GREATER_BETTER)
-          eliminateSpace.emplace_back(sortSpace[idx], sortSpace[idx]->fitness);
+          weights.emplace_back(it->fitness);
         else
-          eliminateSpace.emplace_back(sortSpace[idx], -sortSpace[idx]->fitness);
+          weights.emplace_back(-it->fitness);
 
-        minFitness = std::min(minFitness, eliminateSpace.back().second);
+        minFitness = std::min(minFitness, weights.back());
       }
     }
 
-    double rMax = 0;
-
-    for (auto& pair : eliminateSpace) {
-      pair.second -= minFitness;
-      rMax += pair.second;
-    }
-
-    if (rMax <= 0) {  //  erase randomly
-      while (int(eliminateSpace.size()) > eliminateNum) {
-        const int curEliminateSpaceSize = int(eliminateSpace.size());
-        for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-          if (randD() * curEliminateSpaceSize <= 1) {
-            eliminateSpace.erase(it);
-            break;
-          }
-        }
-      }
-    } else {
-      while (int(eliminateSpace.size()) > eliminateNum) {
-        double r = randD(0, rMax);
-
-        for (auto it = eliminateSpace.begin(); it != eliminateSpace.end(); ++it) {
-          r -= it->second;
-          if (r <= 0) {
-            rMax -= it->second;
-            eliminateSpace.erase(it);
-            break;
-          }
-        }
-        if (r > 0) {  //  unlikely
-          rMax -= eliminateSpace.back().second;
-          eliminateSpace.pop_back();
-        }
-      }
+    for (double& w : weights) {
+      w -= minFitness;
     }
 
-    static_cast<this_t*>(this)->applyErasement(eliminateSpace);
+    //  If all weights are 0, candidates will be erased randomly
+    const int keepNum = std::max(int(candidates.size()) - eliminateNum, 0);
+    static_cast<this_t*>(this)->applyErasementByWeights(candidates, weights, keepNum);
     static_cast<this_t*>(this)->updateFailTimesAndBestGene(
         static_cast<this_t*>(this)->findCurrentBestGene());
   }
@@ -0,0 +1,227 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_BATCHFITNESS_HPP
+#define HEU_BATCHFITNESS_HPP
+
+#include <assert.h>
+#include <type_traits>
+
+#include <Eigen/Core>
+
+#include "InternalHeaderCheck.h"
+#include "Types.hpp"
+
+namespace heu {
+
+namespace internal {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Decide whether a decision variable type can be packed into a batch matrix.
+ *
+ * A type is batchable if it stores arithmetic (but not bool) elements contiguously and exposes them
+ * through `data()` and `size()`, i.e. std::vector, std::array and Eigen classes.
+ */
+template <class Var_t, bool isVec = isVector_v<Var_t>>
+struct batchVarTraits {
+  static constexpr bool value = false;
+};
+
+template <class Var_t>
+struct batchVarTraits<Var_t, true> {
+  using Scalar_t = typename array_traits<Var_t>::Scalar_t;
+  static constexpr bool value = std::is_arithmetic_v<Scalar_t> && !std::is_same_v<Scalar_t, bool>;
+  static constexpr int sizeCT = array_traits<Var_t>::sizeCT;
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Decide whether a fitness type can be stored as a column of a batch matrix.
+ *
+ * Scalar fitness values are stored in a row vector, while Eigen fitness vectors (multi-objective
+ * fitness) are stored column by column.
+ */
+template <class Fitness_t, class unused = void>
+struct batchFitnessTraits {
+  static constexpr bool value = false;
+};
+
+template <class Fitness_t>
+struct batchFitnessTraits<Fitness_t, std::enable_if_t<std::is_arithmetic_v<Fitness_t>>> {
+  static constexpr bool value = true;
+  using Scalar_t = Fitness_t;
+  static constexpr int rowsCT = 1;
+};
+
+template <class Fitness_t>
+struct batchFitnessTraits<Fitness_t, std::enable_if_t<isEigenClass<Fitness_t>::value>> {
+  static constexpr bool value = array_traits<Fitness_t>::isColVector;
+  using Scalar_t = typename array_traits<Fitness_t>::Scalar_t;
+  static constexpr int rowsCT = array_traits<Fitness_t>::rowsCT;
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class BatchFitnessBody
+ * \brief Maintains an optional fitness function that evaluates many individuals in one call.
+ *
+ * Solvers evaluate individuals one by one with `fFun` by default. When a batch fitness function is
+ * set through `setBatchfFun`, the solver packs all individuals that need evaluation into a
+ * `BatchVar_t` matrix (one column per individual, elements of each decision variable in storage
+ * order) and calls the batch function once. The batch function should write the fitness of the
+ * i-th column into the i-th column of `BatchFitness_t`, which has been resized before the call.
+ * This allows the objective to use vectorized or BLAS code and to amortize setup cost.
+ *
+ * The signature of batch fitness function is `void(const BatchVar_t*, const Args_t*,
+ * BatchFitness_t*)`, or `void(const BatchVar_t*, BatchFitness_t*)` when `Args_t` is void.
+ *
+ * `runAsync` of GA solvers calls the batch function from several workers at the same time with
+ * small batches, and each worker has its own `BatchBuffer`.
+ *
+ * Batch evaluation is only available when `Var_t` is a vector/matrix of arithmetic elements and
+ * `Fitness_t` is a number or an Eigen column vector. Otherwise this class is empty and
+ * `hasBatchfFun()` always returns false.
+ *
+ * \tparam Var_t Type of decision variable
+ * \tparam Fitness_t Type of fitness
+ * \tparam Args_t Type of other parameters
+ */
+template <class Var_t, class Fitness_t, class Args_t,
+          bool batchable = batchVarTraits<Var_t>::value && batchFitnessTraits<Fitness_t>::value>
+class BatchFitnessBody {
+ public:
+  static constexpr bool isBatchable = false;
+
+  inline constexpr bool hasBatchfFun() const noexcept { return false; }
+
+ protected:
+  struct BatchBuffer {};
+
+  inline bool runBatchfFun(const Var_t *const *, Fitness_t *const *, size_t, const Args_t *,
+                           BatchBuffer * = nullptr) noexcept {
+    return false;
+  }
+};
+
+template <class Var_t, class Fitness_t, class Args_t>
+class BatchFitnessBody<Var_t, Fitness_t, Args_t, true> {
+ private:
+  using VarScalar_t = typename batchVarTraits<Var_t>::Scalar_t;
+  using FitnessScalar_t = typename batchFitnessTraits<Fitness_t>::Scalar_t;
+  static constexpr int varSizeCT = batchVarTraits<Var_t>::sizeCT;
+
+ public:
+  static constexpr bool isBatchable = true;
+
+  /// Decision variables of a batch, one column per individual.
+  using BatchVar_t = Eigen::Array<VarScalar_t, varSizeCT, Eigen::Dynamic>;
+  /// Fitness values of a batch, one column per individual.
+  using BatchFitness_t =
+      Eigen::Array<FitnessScalar_t, batchFitnessTraits<Fitness_t>::rowsCT, Eigen::Dynamic>;
+  /// Type of batch fitness function
+  using batchFitnessFun =
+      std::conditional_t<std::is_void_v<Args_t>, void (*)(const BatchVar_t *, BatchFitness_t *),
+                         void (*)(const BatchVar_t *, const Args_t *, BatchFitness_t *)>;
+
+  BatchFitnessBody() : _batchfFunPtr(nullptr) {}
+
+  /**
+   * \brief Set the batch fitness function. Pass nullptr to evaluate individuals one by one again.
+   */
+  inline void setBatchfFun(batchFitnessFun fun) noexcept { _batchfFunPtr = fun; }
+
+  /// Get the batch fitness function
+  inline batchFitnessFun batchfFun() const noexcept { return _batchfFunPtr; }
+
+  /// Whether a batch fitness function is set.
+  inline bool hasBatchfFun() const noexcept { return _batchfFunPtr != nullptr; }
+
+ protected:
+  /// Matrices that pack a batch for the batch fitness function.
+  struct BatchBuffer {
+    BatchVar_t vars;
+    BatchFitness_t fitness;
+  };
+
+  /**
+   * \brief Evaluate `n` individuals with the batch fitness function.
+   *
+   * \param buffer Where the batch is packed. The buffer of this object is used if it's nullptr, so
+   * callers that may run concurrently must pass their own buffers.
+   *
+   * \return false if no batch fitness function is set, and nothing will be done.
+   */
+  bool runBatchfFun(const Var_t *const *vars, Fitness_t *const *fits, size_t n,
+                    [[maybe_unused]] const Args_t *args, BatchBuffer *buffer = nullptr) noexcept {
+    if (_batchfFunPtr == nullptr) {
+      return false;
+    }
+    if (n <= 0) {
+      return true;
+    }
+    if (buffer == nullptr) {
+      buffer = &_batchBuffer;
+    }
+    BatchVar_t &batchVars = buffer->vars;
+    BatchFitness_t &batchFitness = buffer->fitness;
+
+    const int varSize = int(vars[0]->size());
+    batchVars.resize(varSize, n);
+    for (size_t c = 0; c < n; c++) {
+      assert(int(vars[c]->size()) == varSize);
+      batchVars.col(c) =
+          Eigen::Map<const Eigen::Array<VarScalar_t, varSizeCT, 1>>(vars[c]->data(), varSize);
+    }
+
+    if constexpr (batchFitnessTraits<Fitness_t>::rowsCT == Eigen::Dynamic) {
+      // the batch function should resize it if the number of objectives is still unknown
+      batchFitness.resize(fits[0]->size(), n);
+    } else {
+      batchFitness.resize(batchFitnessTraits<Fitness_t>::rowsCT, n);
+    }
+
+    if constexpr (std::is_void_v<Args_t>) {
+      _batchfFunPtr(&batchVars, &batchFitness);
+    } else {
+      _batchfFunPtr(&batchVars, args, &batchFitness);
+    }
+
+    assert(size_t(batchFitness.cols()) == n);
+    for (size_t c = 0; c < n; c++) {
+      if constexpr (std::is_arithmetic_v<Fitness_t>) {
+        *fits[c] = batchFitness(0, c);
+      } else {
+        *fits[c] = batchFitness.col(c);
+      }
+    }
+    return true;
+  }
+
+ private:
+  batchFitnessFun _batchfFunPtr;
+  /// Buffers are kept among generations to avoid reallocating.
+  BatchBuffer _batchBuffer;
+};
+
+}  //  namespace internal
+
+}  //  namespace heu
+
+#endif  //  HEU_BATCHFITNESS_HPP
@@ -0,0 +1,296 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#ifndef HEU_CHECKPOINT_HPP
+#define HEU_CHECKPOINT_HPP
+
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "InternalHeaderCheck.h"
+#include "Randoms.hpp"
+
+namespace heu {
+
+namespace internal {
+
+template <class T>
+struct isStdVector : std::false_type {};
+
+template <class T, class Alloc>
+struct isStdVector<std::vector<T, Alloc>> : std::true_type {};
+
+template <class T>
+struct isStdArray : std::false_type {};
+
+template <class T, size_t N>
+struct isStdArray<std::array<T, N>> : std::true_type {};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Whether T is a dense matrix that can be resized and exposes contiguous storage, like
+ * Eigen::Array, Eigen::Matrix and heu::MatrixDynamicSize.
+ */
+template <class T, class = void>
+struct isResizableDense : std::false_type {};
+
+template <class T>
+struct isResizableDense<T, std::void_t<decltype(std::declval<T&>().resize(1, 1)),
+                                       decltype(std::declval<const T&>().rows()),
+                                       decltype(std::declval<const T&>().cols()),
+                                       decltype(std::declval<T&>().data())>> : std::true_type {};
+
+template <class>
+struct dependentFalse : std::false_type {};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Minimum number of bytes that `writeBinary` writes for a value of T, and at least 1.
+ */
+template <class T>
+constexpr size_t minBinarySize() noexcept {
+  if constexpr (isResizableDense<T>::value) {
+    return 2 * sizeof(int64_t);
+  } else if constexpr (isStdVector<T>::value) {
+    return sizeof(uint64_t);
+  } else if constexpr (isStdArray<T>::value) {
+    return std::max<size_t>(1, std::tuple_size_v<T> * minBinarySize<typename T::value_type>());
+  } else {
+    return sizeof(T);
+  }
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Largest number of bytes that a checkpoint read from a stream of unknown length (like a
+ * pipe) may claim for a single value.
+ */
+constexpr uint64_t maxCheckpointBytesOfUnknownStream = uint64_t(1) << 32;
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Whether `count` values of at least `bytesEach` bytes can be read from `is`.
+ *
+ * Sizes read from a corrupt or truncated checkpoint can be arbitrary, so they are checked before
+ * allocating anything. If the stream can tell its length, the values must fit in the remaining
+ * bytes. Otherwise they must fit in `maxCheckpointBytesOfUnknownStream`.
+ */
+inline bool canReadValues(std::istream& is, uint64_t count, size_t bytesEach) noexcept {
+  uint64_t bytesLeft = maxCheckpointBytesOfUnknownStream;
+  const std::streampos cur = is.tellg();
+  if (cur != std::streampos(-1)) {
+    if (is.seekg(0, std::ios::end)) {
+      const std::streampos end = is.tellg();
+      if (end != std::streampos(-1) && end >= cur) {
+        bytesLeft = uint64_t(end - cur);
+      }
+    }
+    is.clear();
+    is.seekg(cur);
+  }
+  return count <= bytesLeft / bytesEach;
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Write a value to a binary stream.
+ *
+ * Numbers, enums and other trivially copyable types are written as raw bytes. Dense matrices
+ * (Eigen classes and SimpleMatrix) write their shape and then the coefficients, std::vector writes
+ * its size and then the elements, and std::array writes its elements. Contiguous numbers are
+ * written in a single call. The format is native-endian, so checkpoints move between machines of
+ * the same architecture only.
+ */
+template <class T>
+inline void writeBinary(std::ostream& os, const T& v) noexcept {
+  if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+  } else if constexpr (isResizableDense<T>::value) {
+    using Scalar_t = std::remove_cv_t<std::remove_pointer_t<decltype(v.data())>>;
+    writeBinary(os, int64_t(v.rows()));
+    writeBinary(os, int64_t(v.cols()));
+    const size_t n = size_t(v.rows()) * size_t(v.cols());
+    if constexpr (std::is_arithmetic_v<Scalar_t>) {
+      os.write(reinterpret_cast<const char*>(v.data()), std::streamsize(n * sizeof(Scalar_t)));
+    } else {
+      for (size_t i = 0; i < n; i++) {
+        writeBinary(os, v.data()[i]);
+      }
+    }
+  } else if constexpr (isStdVector<T>::value) {
+    writeBinary(os, uint64_t(v.size()));
+    using Element_t = typename T::value_type;
+    if constexpr (std::is_arithmetic_v<Element_t> && !std::is_same_v<Element_t, bool>) {
+      os.write(reinterpret_cast<const char*>(v.data()),
+               std::streamsize(v.size() * sizeof(Element_t)));
+    } else {
+      for (const auto& e : v) {
+        writeBinary(os, Element_t(e));
+      }
+    }
+  } else if constexpr (isStdArray<T>::value) {
+    for (const auto& e : v) {
+      writeBinary(os, e);
+    }
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+  } else {
+    static_assert(dependentFalse<T>::value, "This type can't be written to checkpoints");
+  }
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Read a value written by `writeBinary`.
+ *
+ * \return Whether the value is read successfully. It fails if the stream ends too early, the
+ * shape of a fixed-size matrix doesn't match, or a size is larger than the rest of the stream (see
+ * `canReadValues`).
+ */
+template <class T>
+inline bool readBinary(std::istream& is, T* v) noexcept {
+  if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    is.read(reinterpret_cast<char*>(v), sizeof(T));
+  } else if constexpr (isResizableDense<T>::value) {
+    using Scalar_t = std::remove_cv_t<std::remove_pointer_t<decltype(v->data())>>;
+    int64_t rows = 0, cols = 0;
+    if (!readBinary(is, &rows) || !readBinary(is, &cols) || rows < 0 || cols < 0) {
+      return false;
+    }
+    {
+      // A dimension of a default-constructed matrix is non-zero only if it's fixed
+      const T probe;
+      if ((probe.rows() != 0 && int64_t(probe.rows()) != rows) ||
+          (probe.cols() != 0 && int64_t(probe.cols()) != cols)) {
+        return false;
+      }
+    }
+    if (cols != 0 && uint64_t(rows) > std::numeric_limits<uint64_t>::max() / uint64_t(cols)) {
+      return false;
+    }
+    const size_t n = size_t(rows) * size_t(cols);
+    if (!canReadValues(is, n, minBinarySize<Scalar_t>())) {
+      return false;
+    }
+    v->resize(rows, cols);
+    if constexpr (std::is_arithmetic_v<Scalar_t>) {
+      is.read(reinterpret_cast<char*>(v->data()), std::streamsize(n * sizeof(Scalar_t)));
+    } else {
+      for (size_t i = 0; i < n; i++) {
+        if (!readBinary(is, v->data() + i)) {
+          return false;
+        }
+      }
+    }
+  } else if constexpr (isStdVector<T>::value) {
+    uint64_t size = 0;
+    if (!readBinary(is, &size)) {
+      return false;
+    }
+    using Element_t = typename T::value_type;
+    if (!canReadValues(is, size, minBinarySize<Element_t>())) {
+      return false;
+    }
+    v->resize(size);
+    if constexpr (std::is_arithmetic_v<Element_t> && !std::is_same_v<Element_t, bool>) {
+      is.read(reinterpret_cast<char*>(v->data()), std::streamsize(size * sizeof(Element_t)));
+    } else {
+      for (size_t i = 0; i < size; i++) {
+        Element_t e;
+        if (!readBinary(is, &e)) {
+          return false;
+        }
+        (*v)[i] = std::move(e);
+      }
+    }
+  } else if constexpr (isStdArray<T>::value) {
+    for (auto& e : *v) {
+      if (!readBinary(is, &e)) {
+        return false;
+      }
+    }
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    is.read(reinterpret_cast<char*>(v), sizeof(T));
+  } else {
+    static_assert(dependentFalse<T>::value, "This type can't be read from checkpoints");
+  }
+  return bool(is);
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief A tag of the solver type, so that a checkpoint can't be loaded by another kind of solver.
+ *
+ * It's the FNV-1a hash of the mangled type name, which is the same for the same binary.
+ */
+template <class Solver_t>
+inline uint64_t checkpointTag() noexcept {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char* c = typeid(Solver_t).name(); *c != '\0'; c++) {
+    hash = (hash ^ uint64_t(uint8_t(*c))) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/// Magic number at the beginning of checkpoints, "HEUCKPT" followed by the format version.
+inline constexpr uint64_t checkpointMagic = 0x0154504b43554548ULL;
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Write the header of a checkpoint, including the random state of the calling thread.
+ */
+template <class Solver_t>
+inline void writeCheckpointHeader(std::ostream& os) noexcept {
+  writeBinary(os, checkpointMagic);
+  writeBinary(os, checkpointTag<Solver_t>());
+  writeBinary(os, randomState());
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Read and check the header of a checkpoint. The random state is restored only if the
+ * header matches.
+ */
+template <class Solver_t>
+inline bool readCheckpointHeader(std::istream& is) noexcept {
+  uint64_t magic = 0, tag = 0;
+  RandomState rs;
+  if (!readBinary(is, &magic) || !readBinary(is, &tag) || !readBinary(is, &rs)) {
+    return false;
+  }
+  if (magic != checkpointMagic || tag != checkpointTag<Solver_t>()) {
+    return false;
+  }
+  setRandomState(rs);
+  return true;
+}
+
+}  // namespace internal
+
+}  //  namespace heu
+
+#endif  //  HEU_CHECKPOINT_HPP
@@ -354,6 +354,53 @@ inline const char* Enum2String(const SelectMethod sm) noexcept {
   }
 }
 
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Phases of a solver that are timed by SolverProfile
+ *
+ * Not every solver has all phases. GA solvers have fitness, selection, crossover and mutation. PSO
+ * solvers have fitness, gBest/pBest update and population update. AOS solvers have fitness, layer
+ * building and population update.
+ */
+enum SolverPhase : uint8_t {
+  PHASE_FITNESS,            ///< Computing fitness
+  PHASE_SELECT,             ///< Selection of GA
+  PHASE_CROSSOVER,          ///< Crossover of GA
+  PHASE_MUTATE,             ///< Mutation of GA
+  PHASE_UPDATE_PGBEST,      ///< Updating pBest and gBest of PSO
+  PHASE_UPDATE_POPULATION,  ///< Moving particles of PSO or electrons of AOS
+  PHASE_MAKE_LAYERS,        ///< Finding the best electron and sorting electrons into layers of AOS
+  PHASE_NUM                 ///< Number of phases, not a phase
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Convert enumeration to string
+ *
+ * \param p The enum value
+ * \return const char* Name of the value.
+ */
+inline const char* Enum2String(const SolverPhase p) noexcept {
+  switch (p) {
+    case PHASE_FITNESS:
+      return "Fitness";
+    case PHASE_SELECT:
+      return "Select";
+    case PHASE_CROSSOVER:
+      return "Crossover";
+    case PHASE_MUTATE:
+      return "Mutate";
+    case PHASE_UPDATE_PGBEST:
+      return "UpdatePGBest";
+    case PHASE_UPDATE_POPULATION:
+      return "UpdatePopulation";
+    case PHASE_MAKE_LAYERS:
+      return "MakeLayers";
+    default:
+      return "PhaseNum";
+  }
+}
+
 }  //    namespace heu
 
 #endif  // HEU_ENUMERATIONS_HPP
@@ -23,9 +23,50 @@ This file is part of HeuristicFlow.
 #include <assert.h>
 #include <cstdlib>
 
-#define HEU_RELOAD_MEMBERFUCTION_RUN                                         \
-  inline void run() noexcept {                                               \
-    this->template __impl_run<typename std::decay<decltype(*this)>::type>(); \
+#define HEU_RELOAD_MEMBERFUCTION_RUN                                                 \
+  inline void run() noexcept {                                                       \
+    this->template __impl_run<typename std::decay<decltype(*this)>::type>(           \
+        ::heu::internal::NoObserver());                                              \
+  }                                                                                  \
+  template <class Observer_t>                                                        \
+  inline void run(Observer_t &&observer) noexcept {                                  \
+    this->template __impl_run<typename std::decay<decltype(*this)>::type>(observer); \
+  }
+
+#define HEU_RELOAD_MEMBERFUCTION_STEP                                                \
+  inline void startRun() noexcept {                                                  \
+    this->template __impl_startRun<typename std::decay<decltype(*this)>::type>();    \
+  }                                                                                  \
+  inline bool step() noexcept {                                                      \
+    return this->template __impl_step<typename std::decay<decltype(*this)>::type>(); \
+  }
+
+#define HEU_RELOAD_MEMBERFUCTION_RUNASYNC                                                 \
+  inline void runAsync() noexcept {                                                       \
+    this->template __impl_runAsync<typename std::decay<decltype(*this)>::type>(           \
+        ::heu::internal::NoObserver());                                                   \
+  }                                                                                       \
+  template <class Observer_t>                                                             \
+  inline void runAsync(Observer_t &&observer) noexcept {                                  \
+    this->template __impl_runAsync<typename std::decay<decltype(*this)>::type>(observer); \
+  }
+
+#define HEU_RELOAD_MEMBERFUCTION_CHECKPOINT                                                 \
+  inline bool saveCheckpoint(std::ostream &os) const noexcept {                             \
+    return this->template __impl_saveCheckpoint<typename std::decay<decltype(*this)>::type>( \
+        os);                                                                                \
+  }                                                                                         \
+  inline bool loadCheckpoint(std::istream &is) noexcept {                                   \
+    return this->template __impl_loadCheckpoint<typename std::decay<decltype(*this)>::type>( \
+        is);                                                                                \
+  }                                                                                         \
+  inline void resume() noexcept {                                                           \
+    this->template __impl_resume<typename std::decay<decltype(*this)>::type>(               \
+        ::heu::internal::NoObserver());                                                     \
+  }                                                                                         \
+  template <class Observer_t>                                                               \
+  inline void resume(Observer_t &&observer) noexcept {                                      \
+    this->template __impl_resume<typename std::decay<decltype(*this)>::type>(observer);     \
   }
 
 #define HEU_DISPLINE \
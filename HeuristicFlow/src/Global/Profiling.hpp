@@ -0,0 +1,151 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#ifndef HEU_PROFILING_HPP
+#define HEU_PROFILING_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+#include "InternalHeaderCheck.h"
+#include "Enumerations.hpp"
+
+namespace heu {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class SolverProfile
+ * \brief Time and count of each phase of a solver, and the number of fitness calls.
+ *
+ * Profiling is disabled by default and costs nothing. Define `HEU_DO_PROFILING` before including
+ * HeuristicFlow to enable it, then query `profile()` of a solver after `run()`. The profile is
+ * cleared at the beginning of every run.
+ *
+ * Phases that run on multiple threads at the same time (fitness in `runAsync` of GA solvers) are
+ * summed over threads, so they may take longer than the run itself.
+ *
+ * \sa SolverPhase
+ */
+class SolverProfile {
+ public:
+#ifdef HEU_DO_PROFILING
+  static constexpr bool isEnabled = true;  ///< Whether `HEU_DO_PROFILING` is defined
+#else
+  static constexpr bool isEnabled = false;  ///< Whether `HEU_DO_PROFILING` is defined
+#endif
+
+  SolverProfile() noexcept { reset(); }
+  SolverProfile(const SolverProfile& src) noexcept { *this = src; }
+  SolverProfile& operator=(const SolverProfile& src) noexcept {
+    for (int p = 0; p < PHASE_NUM; p++) {
+      _nanoseconds[p].store(src.nanoseconds(SolverPhase(p)), std::memory_order_relaxed);
+      _counts[p].store(src.count(SolverPhase(p)), std::memory_order_relaxed);
+    }
+    _fitnessCalls.store(src.fitnessCalls(), std::memory_order_relaxed);
+    return *this;
+  }
+
+  /// Total nanoseconds spent in a phase.
+  inline uint64_t nanoseconds(SolverPhase p) const noexcept {
+    return _nanoseconds[p].load(std::memory_order_relaxed);
+  }
+
+  /// Total seconds spent in a phase.
+  inline double seconds(SolverPhase p) const noexcept { return nanoseconds(p) * 1e-9; }
+
+  /// Number of times that a phase is entered.
+  inline size_t count(SolverPhase p) const noexcept {
+    return _counts[p].load(std::memory_order_relaxed);
+  }
+
+  /// Number of calls to the fitness function. A batch fitness call counts as many as its genes.
+  inline size_t fitnessCalls() const noexcept {
+    return _fitnessCalls.load(std::memory_order_relaxed);
+  }
+
+  /// Clear all timers and counters.
+  inline void reset() noexcept {
+    for (int p = 0; p < PHASE_NUM; p++) {
+      _nanoseconds[p].store(0, std::memory_order_relaxed);
+      _counts[p].store(0, std::memory_order_relaxed);
+    }
+    _fitnessCalls.store(0, std::memory_order_relaxed);
+  }
+
+  /// Add time to a phase. It does nothing if profiling is disabled.
+  inline void addPhase(SolverPhase p, uint64_t ns) noexcept {
+    if constexpr (isEnabled) {
+      _nanoseconds[p].fetch_add(ns, std::memory_order_relaxed);
+      _counts[p].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// Count calls to the fitness function. It does nothing if profiling is disabled.
+  inline void addFitnessCalls(size_t n) noexcept {
+    if constexpr (isEnabled) {
+      _fitnessCalls.fetch_add(n, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::atomic<uint64_t> _nanoseconds[PHASE_NUM];
+  std::atomic<size_t> _counts[PHASE_NUM];
+  std::atomic<size_t> _fitnessCalls;
+};
+
+namespace internal {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class ProfileTimer
+ * \brief Add the lifetime of this object to a phase of a SolverProfile.
+ *
+ * It's an empty object if profiling is disabled, so the clock is never read.
+ */
+class ProfileTimer {
+ public:
+  ProfileTimer(const ProfileTimer&) = delete;
+  ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+#ifdef HEU_DO_PROFILING
+  ProfileTimer(SolverProfile* profile, SolverPhase phase) noexcept
+      : _profile(profile), _phase(phase), _start(std::chrono::steady_clock::now()) {}
+
+  ~ProfileTimer() {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - _start)
+                        .count();
+    _profile->addPhase(_phase, uint64_t(ns));
+  }
+
+ private:
+  SolverProfile* const _profile;
+  const SolverPhase _phase;
+  const std::chrono::steady_clock::time_point _start;
+#else
+  ProfileTimer(SolverProfile*, SolverPhase) noexcept {}
+#endif
+};
+
+}  // namespace internal
+
+}  // namespace heu
+
+#endif  //  HEU_PROFILING_HPP
@@ -24,6 +24,7 @@ This file is part of HeuristicFlow.
 #include <random>
 #include <cmath>
 #include <chrono>
+#include <atomic>
 
 #include "InternalHeaderCheck.h"
 
@@ -52,7 +53,8 @@ inline std::random_device& global_random_device() noexcept { return rdv; }
 /**
  * \ingroup HEU_GLOBAL
  * \brief Internal global std::mt19937 used as a high-performance
- * random number generater.
+ * random number generater. It's not thread-safe and is only used to generate the default master
+ * seed. Use `thread_engine()` instead.
  *
  * \return std::mt19937& A reference to this instance.
  */
@@ -70,22 +72,290 @@ inline std::mt19937& global_mt19937() noexcept {
   return mt;
 }
 
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief SplitMix64 generator. It's used to derive seeds of random streams.
+ *
+ * \param state Pointer to the state, which will be updated.
+ * \return uint64_t A random number
+ */
+inline uint64_t splitMix64(uint64_t* state) noexcept {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class RandEngine
+ * \brief xoshiro256++ random number generator.
+ *
+ * It satisfies the requirements of UniformRandomBitGenerator, so it can be used with `std::shuffle`
+ * and distributions of `<random>`. Its state is 32 bytes, which is cheap to seed, copy and
+ * restore, and `jump()` advances the state by 2^128 steps to create non-overlapping streams.
+ */
+class RandEngine {
+ public:
+  using result_type = uint64_t;
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return ~result_type(0); }
+
+  explicit RandEngine(uint64_t _seed = 0) noexcept { seed(_seed); }
+
+  /// Initialize the state with SplitMix64
+  inline void seed(uint64_t _seed) noexcept {
+    for (uint64_t& w : state) {
+      w = splitMix64(&_seed);
+    }
+  }
+
+  inline result_type operator()() noexcept {
+    const uint64_t result = rotl(state[0] + state[3], 23) + state[0];
+    const uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+  }
+
+  /// Equivalent to 2^128 calls to operator()
+  inline void jump() noexcept {
+    static constexpr uint64_t jumpPoly[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                             0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint64_t poly : jumpPoly) {
+      for (int b = 0; b < 64; b++) {
+        if (poly & (uint64_t(1) << b)) {
+          for (int i = 0; i < 4; i++) {
+            s[i] ^= state[i];
+          }
+        }
+        this->operator()();
+      }
+    }
+    for (int i = 0; i < 4; i++) {
+      state[i] = s[i];
+    }
+  }
+
+  inline bool operator==(const RandEngine& another) const noexcept {
+    return state[0] == another.state[0] && state[1] == another.state[1] &&
+           state[2] == another.state[2] && state[3] == another.state[3];
+  }
+
+  inline bool operator!=(const RandEngine& another) const noexcept {
+    return !(this->operator==(another));
+  }
+
+  uint64_t state[4];  ///< State of the generator
+
+ private:
+  static inline uint64_t rotl(const uint64_t x, int k) noexcept {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Process-wide state of random streams.
+ *
+ */
+struct RandStreamGlobal {
+  uint64_t masterSeed;                ///< Seed that all streams are derived from
+  std::atomic<uint32_t> version;      ///< Changed each time the master seed is set
+  std::atomic<uint64_t> threadNum;    ///< Number of thread streams created since last seeding
+  std::atomic<uint64_t> regionNum;    ///< Number of parallel regions since last seeding
+};
+
+inline RandStreamGlobal& randStreamGlobal() noexcept {
+  static RandStreamGlobal g{global_mt19937()() | (uint64_t(global_mt19937()()) << 32), {0}, {0},
+                            {0}};
+  return g;
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief The random engine of the calling thread.
+ *
+ * Each thread owns an engine. The n-th thread that draws random numbers after the master seed is
+ * set gets the engine seeded with the master seed and jumped n times, so streams of different
+ * threads never overlap and there is no data race between threads.
+ *
+ * \return RandEngine& A reference to the thread local engine.
+ */
+inline RandEngine& thread_engine() noexcept {
+  struct threadStream {
+    RandEngine engine;
+    uint32_t version = ~uint32_t(0);
+  };
+  thread_local threadStream ts;
+
+  RandStreamGlobal& g = randStreamGlobal();
+  const uint32_t curVersion = g.version.load(std::memory_order_acquire);
+  if (ts.version != curVersion) {
+    ts.engine.seed(g.masterSeed);
+    const uint64_t jumps = g.threadNum.fetch_add(1);
+    for (uint64_t i = 0; i < jumps; i++) {
+      ts.engine.jump();
+    }
+    ts.version = curVersion;
+  }
+  return ts.engine;
+}
+
+/// Depth of RandStreamScope on the calling thread
+inline int& randStreamScopeDepth() noexcept {
+  thread_local int depth = 0;
+  return depth;
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Get an unique id for a parallel region. It must be called outside the parallel region.
+ *
+ * Inside a RandStreamScope, the id is drawn from the current stream instead of the global counter,
+ * so that nested solvers running on different threads (e.g. islands of IslandModel) still get
+ * reproducible regions.
+ *
+ * \return uint64_t Id of the region.
+ * \sa RandStreamScope
+ */
+inline uint64_t newRandStreamRegion() noexcept {
+  if (randStreamScopeDepth() > 0) {
+    return thread_engine()();
+  }
+  return randStreamGlobal().regionNum.fetch_add(1);
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class RandStreamScope
+ * \brief Switch the engine of the calling thread to a stream determined by the master seed, a
+ * region id and a task index, and restore it when the scope ends.
+ *
+ * Solvers create one scope for each task inside parallel loops, thus random numbers drawn in a
+ * task only depend on the master seed and the task, but not on the number of threads or which
+ * thread runs the task.
+ *
+ * \sa newRandStreamRegion
+ */
+class RandStreamScope {
+ public:
+  RandStreamScope(uint64_t region, uint64_t task) noexcept
+      : engine(thread_engine()), backup(engine) {
+    uint64_t key = randStreamGlobal().masterSeed ^ (region * 0xd1342543de82ef95ULL);
+    key = splitMix64(&key) ^ task;
+    engine.seed(splitMix64(&key));
+    randStreamScopeDepth()++;
+  }
+
+  ~RandStreamScope() {
+    engine = backup;
+    randStreamScopeDepth()--;
+  }
+
+  RandStreamScope(const RandStreamScope&) = delete;
+  RandStreamScope& operator=(const RandStreamScope&) = delete;
+
+ private:
+  RandEngine& engine;
+  const RandEngine backup;
+};
+
 }  // namespace internal
 
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Set the master seed of all random streams to make results reproducible.
+ *
+ * The calling thread takes the first stream immediately and other threads reseed their streams
+ * before they draw the next random number. Random numbers drawn inside parallel regions of solvers
+ * are determined by the master seed and the task, so the same seed gives the same result regardless
+ * of the number of threads. Don't call it while any solver is running.
+ *
+ * \param seed The master seed
+ */
+inline void setRandomSeed(uint64_t seed) noexcept {
+  internal::RandStreamGlobal& g = internal::randStreamGlobal();
+  g.masterSeed = seed;
+  g.threadNum.store(0);
+  g.regionNum.store(0);
+  g.version.fetch_add(1, std::memory_order_release);
+  internal::thread_engine();
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Get the master seed of random streams. It's generated by `std::random_device` if not
+ * assigned by `setRandomSeed`.
+ *
+ * \return uint64_t The master seed
+ */
+inline uint64_t randomSeed() noexcept { return internal::randStreamGlobal().masterSeed; }
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \struct RandomState
+ * \brief Snapshot of random streams seen by the calling thread.
+ *
+ * Since parallel regions of solvers draw from streams derived from the master seed, the master
+ * seed, the region counter and the engine of the calling thread are enough to replay the random
+ * numbers of a solver driven by this thread.
+ *
+ * \sa randomState setRandomState
+ */
+struct RandomState {
+  uint64_t masterSeed;  ///< The master seed
+  uint64_t regionNum;   ///< Number of parallel regions since seeding
+  uint64_t engine[4];   ///< State of the engine of the calling thread
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Take a snapshot of random streams of the calling thread.
+ */
+inline RandomState randomState() noexcept {
+  const internal::RandEngine& engine = internal::thread_engine();
+  const internal::RandStreamGlobal& g = internal::randStreamGlobal();
+  RandomState rs;
+  rs.masterSeed = g.masterSeed;
+  rs.regionNum = g.regionNum.load();
+  for (int i = 0; i < 4; i++) {
+    rs.engine[i] = engine.state[i];
+  }
+  return rs;
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Restore random streams of the calling thread from a snapshot. Other threads are reseeded
+ * like `setRandomSeed`. Don't call it while any solver is running.
+ */
+inline void setRandomState(const RandomState& rs) noexcept {
+  setRandomSeed(rs.masterSeed);
+  internal::randStreamGlobal().regionNum.store(rs.regionNum);
+  internal::RandEngine& engine = internal::thread_engine();
+  for (int i = 0; i < 4; i++) {
+    engine.state[i] = rs.engine[i];
+  }
+}
+
 /**
  * \ingroup HEU_GLOBAL
  * \brief Uniform random number (double) in range [0,1)
  *
  * \return double random number
  */
-inline double randD() noexcept {
-  static std::uniform_real_distribution<double> rnd(0, 1);
-  return rnd(internal::global_mt19937());
-}
+inline double randD() noexcept { return (internal::thread_engine()() >> 11) * 0x1.0p-53; }
 
 inline void randD(double* dst, const int num) noexcept {
+  internal::RandEngine& engine = internal::thread_engine();
   for (int i = 0; i < num; i++) {
-    dst[i] = randD();
+    dst[i] = (engine() >> 11) * 0x1.0p-53;
   }
 }
 
@@ -102,8 +372,9 @@ inline double randD(const double min, const double max) noexcept {
 }
 
 inline void randD(double* dst, const int num, const double min, const double max) noexcept {
+  randD(dst, num);
   for (int i = 0; i < num; i++) {
-    dst[i] = randD(min, max);
+    dst[i] = (max - min) * dst[i] + min;
   }
 }
 
@@ -113,10 +384,7 @@ inline void randD(double* dst, const int num, const double min, const double max
  *
  * \return double random number
  */
-inline float randF() noexcept {
-  static std::uniform_real_distribution<float> rnd(0, 1);
-  return rnd(internal::global_mt19937());
-}
+inline float randF() noexcept { return (internal::thread_engine()() >> 40) * 0x1.0p-24f; }
 
 /**
  * \ingroup HEU_GLOBAL
@@ -147,17 +415,25 @@ inline int_t randIdx(int_t min, int_t max_plus_1) noexcept {
   return int_t((max_plus_1 - min) * randF()) + min;
 }
 
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Standard normal random number, generated with Marsaglia polar method.
+ *
+ * \return double random number
+ */
 inline double normD() noexcept {
-  static std::normal_distribution<double> norm(0.0, 1.0);
-  return norm(internal::global_mt19937());
+  double u, v, s;
+  do {
+    u = 2 * randD() - 1;
+    v = 2 * randD() - 1;
+    s = u * u + v * v;
+  } while (s >= 1 || s <= 0);
+  return u * std::sqrt(-2 * std::log(s) / s);
 }
 
 inline double normD(double mu, double sigma) noexcept { return normD() * sigma + mu; }
 
-inline float normF() noexcept {
-  static std::normal_distribution<float> norm(0.0f, 1.0f);
-  return norm(internal::global_mt19937());
-}
+inline float normF() noexcept { return float(normD()); }
 
 }  // namespace heu
 
@@ -0,0 +1,219 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#ifndef HEU_TERMINATION_HPP
+#define HEU_TERMINATION_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "InternalHeaderCheck.h"
+#include "Enumerations.hpp"
+
+namespace heu {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class CancellationToken
+ * \brief A flag that lets another thread stop a running solver.
+ *
+ * Assign a pointer to the token to `TerminationCriteria::cancelToken`, then call `cancel()` from
+ * any thread. The solver stops at the end of its current generation, and the best-so-far result is
+ * kept.
+ */
+class CancellationToken {
+ public:
+  CancellationToken() : _cancelled(false) {}
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  /// Request the solvers that observe this token to stop.
+  inline void cancel() noexcept { _cancelled.store(true, std::memory_order_relaxed); }
+
+  /// Clear the request so that the token can be used again.
+  inline void reset() noexcept { _cancelled.store(false, std::memory_order_relaxed); }
+
+  /// Whether cancellation is requested.
+  inline bool isCancelled() const noexcept { return _cancelled.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<bool> _cancelled;
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \struct TerminationCriteria
+ * \brief Criteria to stop a solver besides the generation and fail times limits of its option.
+ *
+ * All criteria are disabled by default. They are checked once per generation, so a run may exceed
+ * the budget by at most one generation.
+ */
+struct TerminationCriteria {
+ public:
+  /**
+   * \brief Construct and initialize all members to their default values.
+   */
+  TerminationCriteria() {
+    maxEvaluations = 0;
+    maxSeconds = 0;
+    targetFitness = std::numeric_limits<double>::quiet_NaN();
+    cancelToken = nullptr;
+  }
+
+  /// Stop once the fitness function has been called so many times. 0 means no limit.
+  size_t maxEvaluations;
+
+  /// Stop once the run has lasted so many seconds (wall clock). 0 means no limit.
+  double maxSeconds;
+
+  /**
+   * \brief Stop once the best fitness reaches this value. NaN means no target.
+   *
+   * \note It only works for single-objective solvers.
+   */
+  double targetFitness;
+
+  /// Stop once this token is cancelled. nullptr means the run can't be cancelled.
+  const CancellationToken* cancelToken;
+};
+
+namespace internal {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class TerminationMonitor
+ * \brief Runtime state of TerminationCriteria owned by a solver.
+ *
+ * It counts fitness evaluations and measures the time since `start`. Evaluations can be counted
+ * from multiple threads. Copying a monitor doesn't copy its state.
+ */
+class TerminationMonitor {
+ public:
+  TerminationMonitor() : _evaluations(0), _targetReached(false) {}
+  TerminationMonitor(const TerminationMonitor&) : TerminationMonitor() {}
+  TerminationMonitor& operator=(const TerminationMonitor&) noexcept { return *this; }
+
+  /// Reset counters at the beginning of a run.
+  inline void start() noexcept {
+    _evaluations.store(0, std::memory_order_relaxed);
+    _targetReached = false;
+    _startTime = std::chrono::steady_clock::now();
+  }
+
+  /// Restart the clock but keep other states, e.g. after loading a checkpoint.
+  inline void resume(size_t evaluations, bool targetReached) noexcept {
+    start();
+    _evaluations.store(evaluations, std::memory_order_relaxed);
+    _targetReached = targetReached;
+  }
+
+  /// Count evaluations of the fitness function.
+  inline void addEvaluations(size_t n) noexcept {
+    _evaluations.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  /// Number of evaluations since `start`.
+  inline size_t evaluations() const noexcept {
+    return _evaluations.load(std::memory_order_relaxed);
+  }
+
+  /// Whether the best fitness reported last time reached the target.
+  inline bool targetReached() const noexcept { return _targetReached; }
+
+  /// Seconds since `start`.
+  inline double elapsedSeconds() const noexcept {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - _startTime).count();
+  }
+
+  /**
+   * \brief Report the best fitness of a single-objective solver, which is compared with the target.
+   */
+  template <FitnessOption fOpt>
+  inline void reportBestFitness(const TerminationCriteria& c, double best) noexcept {
+    if (std::isnan(c.targetFitness)) {
+      return;
+    }
+    _targetReached = (fOpt == FITNESS_GREATER_BETTER) ? (best >= c.targetFitness)
+                                                       : (best <= c.targetFitness);
+  }
+
+  /**
+   * \brief Whether any criterion is met.
+   *
+   * The clock is only read if a time limit is set, and only after all other criteria are checked.
+   */
+  inline bool shouldStop(const TerminationCriteria& c) const noexcept {
+    if (c.cancelToken != nullptr && c.cancelToken->isCancelled()) {
+      return true;
+    }
+    if (_targetReached) {
+      return true;
+    }
+    if (c.maxEvaluations > 0 && evaluations() >= c.maxEvaluations) {
+      return true;
+    }
+    return (c.maxSeconds > 0) && (elapsedSeconds() >= c.maxSeconds);
+  }
+
+ private:
+  std::atomic<size_t> _evaluations;
+  bool _targetReached;
+  std::chrono::steady_clock::time_point _startTime;
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \struct NoObserver
+ * \brief The observer used by `run()` without arguments. It never stops the run and is optimized
+ * away.
+ */
+struct NoObserver {
+  template <class Solver_t>
+  constexpr bool operator()(const Solver_t&) const noexcept {
+    return true;
+  }
+};
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Call an observer with a solver once a generation is done.
+ *
+ * An observer is any callable that accepts a const reference to the solver. If it returns a value
+ * convertible to bool, false means the run should stop. Observers returning void never stop a run.
+ *
+ * \return Whether the run should go on.
+ */
+template <class Observer_t, class Solver_t>
+inline bool notifyObserver(Observer_t& observer, const Solver_t& solver) noexcept {
+  if constexpr (std::is_void_v<std::invoke_result_t<Observer_t&, const Solver_t&>>) {
+    observer(solver);
+    return true;
+  } else {
+    return bool(observer(solver));
+  }
+}
+
+}  // namespace internal
+
+}  // namespace heu
+
+#endif  //  HEU_TERMINATION_HPP
@@ -24,7 +24,12 @@ This file is part of HeuristicFlow.
 #include <omp.h>
 #endif  //  EIGEN_HAS_OPENMP
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <assert.h>
 
@@ -72,20 +77,219 @@ inline void setThreadNum(int _thN) noexcept {
   thNumWrapper::internalThreadNum() = _thN;
 }
 
-// if HEU_NO_THREADS is defined, HEU_HAS_OPENMP won't be defined, preventing following algorithms to
-// apply multi-threading. Otherwise if Eigen has OpenMP, then HeuristicFlow will use it as well.
+// If HEU_NO_THREADS is defined, neither HEU_HAS_OPENMP nor HEU_HAS_THREADPOOL will be defined,
+// preventing following algorithms to apply multi-threading. Otherwise if Eigen has OpenMP and
+// HEU_USE_THREADPOOL is not defined, HeuristicFlow will use OpenMP as well. In other cases, the
+// built-in thread pool is used.
 #ifndef HEU_NO_THREADS
 
-#ifdef EIGEN_HAS_OPENMP
+#if defined(EIGEN_HAS_OPENMP) && !defined(HEU_USE_THREADPOOL)
 
 #ifndef HEU_HAS_OPENMP
 #define HEU_HAS_OPENMP
 #endif  //  HEU_HAS_OPENMP
 
-#endif  //  EIGEN_HAS_OPENMP
+#else
+
+#ifndef HEU_HAS_THREADPOOL
+#define HEU_HAS_THREADPOOL
+#endif  //  HEU_HAS_THREADPOOL
+
+#endif  //  defined(EIGEN_HAS_OPENMP) && !defined(HEU_USE_THREADPOOL)
 
 #endif  //  HEU_NO_THREADS
 
+namespace internal {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Number of iterations that a thread takes at a time in `parallel_for`.
+ *
+ * Each thread gets about 4 chunks, which balances the load when iterations cost differently.
+ */
+inline int parallelChunkSize(int taskNum, int thN) noexcept {
+  return std::max(1, taskNum / (4 * std::max(1, thN)));
+}
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class ThreadPool
+ * \brief A persistent thread pool that runs loops for `parallel_for`.
+ *
+ * Workers are created when they are needed for the first time, and then sleep on a condition
+ * variable between loops, so a loop doesn't pay for creating threads. The calling thread takes part
+ * in the loop as well. Iterations are split into chunks, and every thread keeps taking the next
+ * chunk from a shared atomic counter until all chunks are taken, so threads that finish early take
+ * over the remaining work of slower ones.
+ *
+ * Nested loops, or loops started by another thread while the pool is busy, run serially on the
+ * calling thread.
+ */
+class ThreadPool {
+ public:
+  /// The pool shared by all solvers.
+  static ThreadPool &global() noexcept {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  ThreadPool() : _epoch(0), _helperNum(0), _pendingNum(0), _stop(false) {}
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lk(_mtx);
+      _stop = true;
+    }
+    _cvWork.notify_all();
+    for (std::thread &t : _workers) {
+      t.join();
+    }
+  }
+
+  /// Number of worker threads that have been created.
+  inline int workerNum() const noexcept { return int(_workers.size()); }
+
+  /**
+   * \brief Run `fun(i)` for every i in [begin,end) with `thN` threads, including the caller.
+   */
+  template <class Fun>
+  void run(int begin, int end, int thN, Fun &fun) noexcept {
+    const int taskNum = end - begin;
+    thN = std::min(thN, taskNum);
+    if (thN <= 1 || inParallelRegion() || !_runMtx.try_lock()) {
+      for (int i = begin; i < end; i++) {
+        fun(i);
+      }
+      return;
+    }
+    std::lock_guard<std::mutex> runLock(_runMtx, std::adopt_lock);
+
+    {
+      std::lock_guard<std::mutex> lk(_mtx);
+      while (int(_workers.size()) < thN - 1) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, int(_workers.size()), _epoch);
+      }
+
+      _invoke = [](void *f, int i) { (*static_cast<Fun *>(f))(i); };
+      _fun = &fun;
+      _end = end;
+      _chunk = parallelChunkSize(taskNum, thN);
+      _next.store(begin);
+      _helperNum = thN - 1;
+      _pendingNum = thN - 1;
+      _epoch++;
+    }
+    _cvWork.notify_all();
+
+    inParallelRegion() = true;
+    work();
+    inParallelRegion() = false;
+
+    std::unique_lock<std::mutex> lk(_mtx);
+    _cvDone.wait(lk, [this]() { return _pendingNum <= 0; });
+  }
+
+ private:
+  std::vector<std::thread> _workers;
+  std::mutex _runMtx;  ///< Held while a loop is running
+  std::mutex _mtx;     ///< Protects the members below
+  std::condition_variable _cvWork;
+  std::condition_variable _cvDone;
+  uint64_t _epoch;   ///< Increased when a new loop is published
+  int _helperNum;    ///< Number of workers that take part in current loop
+  int _pendingNum;   ///< Number of workers that haven't finished current loop
+  bool _stop;
+
+  void (*_invoke)(void *, int);
+  void *_fun;
+  int _end;
+  int _chunk;
+  std::atomic<int> _next;
+
+  static inline bool &inParallelRegion() noexcept {
+    thread_local bool inside = false;
+    return inside;
+  }
+
+  inline void work() noexcept {
+    while (true) {
+      const int start = _next.fetch_add(_chunk);
+      if (start >= _end) {
+        break;
+      }
+      const int stop = std::min(start + _chunk, _end);
+      for (int i = start; i < stop; i++) {
+        _invoke(_fun, i);
+      }
+    }
+  }
+
+  void workerLoop(int id, uint64_t seenEpoch) noexcept {
+    inParallelRegion() = true;
+    while (true) {
+      std::unique_lock<std::mutex> lk(_mtx);
+      _cvWork.wait(lk, [&]() { return _stop || _epoch != seenEpoch; });
+      if (_stop) {
+        return;
+      }
+      seenEpoch = _epoch;
+      if (id >= _helperNum) {
+        continue;
+      }
+      lk.unlock();
+
+      work();
+
+      lk.lock();
+      _pendingNum--;
+      if (_pendingNum <= 0) {
+        _cvDone.notify_one();
+      }
+    }
+  }
+};
+
+}  //  namespace internal
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \brief Run `fun(i)` for every i in [begin,end) in parallel.
+ *
+ * The loop is executed by OpenMP if `HEU_HAS_OPENMP` is defined, or by the built-in thread pool if
+ * `HEU_HAS_THREADPOOL` is defined, otherwise it runs serially. Define `HEU_USE_THREADPOOL` to use
+ * the thread pool even if OpenMP is available, or `HEU_NO_THREADS` to disable multi-threading.
+ *
+ * The number of threads is queried by `threadNum()` on every call, so `setThreadNum` takes effect
+ * on the next loop.
+ *
+ * \param begin The first index
+ * \param end One plus the last index
+ * \param fun A callable that accepts an int index. Iterations must be independent of each other.
+ */
+template <class Fun>
+inline void parallel_for(int begin, int end, Fun &&fun) noexcept {
+  if (end <= begin) {
+    return;
+  }
+  const int thN = std::max(1, threadNum());
+#if defined(HEU_HAS_OPENMP)
+  const int chunk = internal::parallelChunkSize(end - begin, thN);
+#pragma omp parallel for schedule(dynamic, chunk) num_threads(thN)
+  for (int i = begin; i < end; i++) {
+    fun(i);
+  }
+#elif defined(HEU_HAS_THREADPOOL)
+  internal::ThreadPool::global().run(begin, end, thN, fun);
+#else
+  for (int i = begin; i < end; i++) {
+    fun(i);
+  }
+#endif
+}
+
 }  // namespace heu
 
 #endif  // HEU_THREADING_HPP
@@ -0,0 +1,171 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_WEIGHTEDSAMPLER_HPP
+#define HEU_WEIGHTEDSAMPLER_HPP
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include "InternalHeaderCheck.h"
+#include "Randoms.hpp"
+
+namespace heu {
+
+namespace internal {
+
+/**
+ * \ingroup HEU_GLOBAL
+ * \class WeightedSampler
+ * \brief Sampling without replacement with probability proportional to weights.
+ *
+ * Weights are stored in a Fenwick tree (binary indexed tree), so each draw costs O(log N) and
+ * drawing K elements out of N costs O(N + K log N), instead of O(NK) by scanning a list.
+ *
+ * If the sum of remaining weights is not positive, elements are drawn uniformly. This is also
+ * implemented by a Fenwick tree that counts the remaining elements.
+ */
+class WeightedSampler {
+ public:
+  WeightedSampler() : _remaining(0), _total(0), _topStep(0) {}
+
+  /**
+   * \brief Reset the sampler with weights of `n` elements. Weights must be non-negative.
+   */
+  void reset(const double *w, size_t n) {
+    _weights.assign(w, w + n);
+    _drawn.assign(n, false);
+    _wTree.assign(n + 1, 0);
+    _cTree.assign(n + 1, 0);
+    _remaining = n;
+    _total = 0;
+
+    // build both trees in O(n)
+    for (size_t i = 1; i <= n; i++) {
+      assert(_weights[i - 1] >= 0);
+      _wTree[i] += _weights[i - 1];
+      _cTree[i] += 1;
+      _total += _weights[i - 1];
+      const size_t parent = i + lowBit(i);
+      if (parent <= n) {
+        _wTree[parent] += _wTree[i];
+        _cTree[parent] += _cTree[i];
+      }
+    }
+
+    _topStep = 1;
+    while (_topStep * 2 <= n) {
+      _topStep *= 2;
+    }
+    if (n <= 0) {
+      _topStep = 0;
+    }
+  }
+
+  inline void reset(const std::vector<double> &w) { reset(w.data(), w.size()); }
+
+  /// Number of elements that haven't been drawn
+  inline size_t size() const noexcept { return _remaining; }
+
+  /// Number of elements, including drawn ones.
+  inline size_t capacity() const noexcept { return _weights.size(); }
+
+  /// Sum of weights of elements that haven't been drawn.
+  inline double totalWeight() const noexcept { return _total; }
+
+  /// Whether the `idx`-th element has been drawn.
+  inline bool isDrawn(size_t idx) const noexcept { return _drawn[idx]; }
+
+  /**
+   * \brief Draw an element and remove it from the sampler.
+   *
+   * \return size_t Index of the drawn element.
+   */
+  size_t draw() noexcept {
+    assert(_remaining > 0);
+    size_t idx = _weights.size();
+    if (_total > 0) {
+      idx = findByWeight(randD(0, _total));
+    }
+    // roundoff error may make it fall out of range or on a drawn element.
+    if (idx >= _weights.size() || _drawn[idx]) {
+      idx = findByCount(std::min(randIdx(_remaining), _remaining - 1));
+    }
+    remove(idx);
+    return idx;
+  }
+
+ private:
+  std::vector<double> _weights;
+  std::vector<bool> _drawn;
+  std::vector<double> _wTree;    ///< Fenwick tree of weights, 1-based.
+  std::vector<uint32_t> _cTree;  ///< Fenwick tree of remaining counts, 1-based.
+  size_t _remaining;
+  double _total;
+  size_t _topStep;  ///< The greatest power of 2 that is not greater than the number of elements
+
+  static inline size_t lowBit(size_t i) noexcept { return i & (~i + 1); }
+
+  // find the element whose cumulative weight interval contains r
+  inline size_t findByWeight(double r) const noexcept {
+    size_t pos = 0;
+    for (size_t step = _topStep; step > 0; step /= 2) {
+      const size_t next = pos + step;
+      if (next < _wTree.size() && _wTree[next] <= r) {
+        pos = next;
+        r -= _wTree[next];
+      }
+    }
+    return pos;
+  }
+
+  // find the k-th (0-based) remaining element
+  inline size_t findByCount(size_t k) const noexcept {
+    size_t pos = 0;
+    for (size_t step = _topStep; step > 0; step /= 2) {
+      const size_t next = pos + step;
+      if (next < _cTree.size() && _cTree[next] <= k) {
+        pos = next;
+        k -= _cTree[next];
+      }
+    }
+    return pos;
+  }
+
+  inline void remove(size_t idx) noexcept {
+    assert(!_drawn[idx]);
+    const double w = _weights[idx];
+    for (size_t i = idx + 1; i < _wTree.size(); i += lowBit(i)) {
+      _wTree[i] -= w;
+      _cTree[i] -= 1;
+    }
+    _weights[idx] = 0;
+    _drawn[idx] = true;
+    _total -= w;
+    _remaining--;
+  }
+};
+
+}  //  namespace internal
+
+}  //  namespace heu
+
+#endif  //  HEU_WEIGHTEDSAMPLER_HPP
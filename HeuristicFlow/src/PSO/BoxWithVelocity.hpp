@@ -44,7 +44,7 @@ class SquareBox4PSO {
 
   inline Scalar_t posMin(const int) const noexcept { return _posMinS; }
 
-  inline Scalar_t posMax(const int) const noexcept { return _posMinS; }
+  inline Scalar_t posMax(const int) const noexcept { return _posMaxS; }
 
   inline void setRange(const Scalar_t min, const Scalar_t max) noexcept {
     assert(min < max);
@@ -69,16 +69,24 @@ class SquareBox4PSO {
   }
 
   inline void applyConstraint4Position(Var_t* p) const noexcept {
-    for (int idx = 0; idx < p->size(); idx++) {
-      at(*p, idx) = std::min(_posMaxS, at(*p, idx));
-      at(*p, idx) = std::max(_posMinS, at(*p, idx));
+    if constexpr (array_traits<Var_t>::isEigenClass) {
+      p->array() = p->array().min(_posMaxS).max(_posMinS);
+    } else {
+      Scalar_t* const data = p->data();
+      for (int idx = 0; idx < int(p->size()); idx++) {
+        data[idx] = std::max(_posMinS, std::min(_posMaxS, data[idx]));
+      }
     }
   }
 
   inline void applyConstraint4Velocity(Var_t* v) const noexcept {
-    for (int idx = 0; idx < v->size(); idx++) {
-      at(*v, idx) = std::min(at(*v, idx), _maxVelocityS);
-      at(*v, idx) = std::max(at(*v, idx), -_maxVelocityS);
+    if constexpr (array_traits<Var_t>::isEigenClass) {
+      v->array() = v->array().min(_maxVelocityS).max(-_maxVelocityS);
+    } else {
+      Scalar_t* const data = v->data();
+      for (int idx = 0; idx < int(v->size()); idx++) {
+        data[idx] = std::max(std::min(data[idx], _maxVelocityS), -_maxVelocityS);
+      }
     }
   }
 
@@ -147,16 +155,24 @@ class NonsquareBox4PSO {
   }
 
   inline void applyConstraint4Position(Var_t* p) const noexcept {
-    for (int idx = 0; idx < p->size(); idx++) {
-      at(*p, idx) = std::min(at(_posMaxV, idx), at(*p, idx));
-      at(*p, idx) = std::max(at(_posMinV, idx), at(*p, idx));
+    if constexpr (array_traits<Var_t>::isEigenClass) {
+      p->array() = p->array().min(_posMaxV.array()).max(_posMinV.array());
+    } else {
+      Scalar_t* const data = p->data();
+      for (int idx = 0; idx < int(p->size()); idx++) {
+        data[idx] = std::max(_posMinV[idx], std::min(_posMaxV[idx], data[idx]));
+      }
     }
   }
 
   inline void applyConstraint4Velocity(Var_t* v) const noexcept {
-    for (int idx = 0; idx < v->size(); idx++) {
-      at(*v, idx) = std::min(at(*v, idx), at(_maxVelocityV, idx));
-      at(*v, idx) = std::max(at(*v, idx), -at(_maxVelocityV, idx));
+    if constexpr (array_traits<Var_t>::isEigenClass) {
+      v->array() = v->array().min(_maxVelocityV.array()).max(-_maxVelocityV.array());
+    } else {
+      Scalar_t* const data = v->data();
+      for (int idx = 0; idx < int(v->size()); idx++) {
+        data[idx] = std::max(std::min(data[idx], _maxVelocityV[idx]), -_maxVelocityV[idx]);
+      }
     }
   }
 
@@ -53,6 +53,7 @@ namespace internal {}  //  namespace internal
  * \sa PSOOption
  * \sa SOGA for the meanning of `Arg_t`
  * \sa BoxShape
+ * \sa PSOSoA for the structure-of-arrays layout
  *
  * PSO solvers have different APIs for different template parameters.
  *
@@ -101,6 +102,11 @@ namespace internal {}  //  namespace internal
  * ## These APIs exist when template parameter `_fFun_` is `nullptr` :
  * - `setfFun(fFun_t)` sets the fitness function.
  *
+ * ## These APIs exist when `Var_t` is a vector/matrix of numbers :
+ * - `setBatchfFun(batchFitnessFun)` sets a fitness function that evaluates the whole population in
+ * one call. See `internal::BatchFitnessBody`.
+ * - `bool hasBatchfFun() const` returns whether a batch fitness function is set.
+ *
  *
  * ## These APIs exist when `Var_t` CAN be a matrix :
  * - `int boxRows() const` return the rows of posMin, posMax and velocityMax.
@@ -138,6 +144,7 @@ class PSO
   ~PSO() = default;
 
   HEU_RELOAD_MEMBERFUCTION_RUN
+  HEU_RELOAD_MEMBERFUCTION_CHECKPOINT
   HEU_MAKE_PSOABSTRACT_TYPES(Base_t)
 
   /**
@@ -76,6 +76,8 @@ class PSO4Eigen
     } else {
       this->_failTimes++;
     }
+    this->_termination.template reportBestFitness<FitnessOpt>(this->_option.termination,
+                                                              this->gBest.fitness);
   }
 
   /**
@@ -83,11 +85,9 @@ class PSO4Eigen
    *
    */
   void __impl_updatePopulation() noexcept {
-#ifdef HEU_HAS_OPENMP
-    static const int32_t thN = threadNum();
-#pragma omp parallel for schedule(dynamic, this->_population.size() / thN)
-#endif  //  HEU_HAS_OPENMP
-    for (int idx = 0; idx < (int)this->_population.size(); idx++) {
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(this->_population.size()), [&](int idx) {
+      RandStreamScope randScope(randRegion, idx);
       Particle_t& i = this->_population[idx];
       const Scalar_t lFP = randD(), lFG = randD();
       i.velocity = this->_option.inertiaFactor * i.velocity +
@@ -105,7 +105,7 @@ class PSO4Eigen
       /*
     i.position = i.position.min(this->_posMax);
     i.position = i.position.max(this->_posMin);*/
-    }
+    });
   }
 };
 
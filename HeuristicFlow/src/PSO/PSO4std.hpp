@@ -85,6 +85,8 @@ class PSO4std : public internal::PSOAbstract<Var_t, double, RecordOpt, Arg_t, BS
     } else {
       this->_failTimes++;
     }
+    this->_termination.template reportBestFitness<FitnessOpt>(this->_option.termination,
+                                                              this->gBest.fitness);
   }
 
   /**
@@ -92,11 +94,9 @@ class PSO4std : public internal::PSOAbstract<Var_t, double, RecordOpt, Arg_t, BS
    *
    */
   void __impl_updatePopulation() noexcept {
-#ifdef HEU_HAS_OPENMP
-    static const int32_t thN = threadNum();
-#pragma omp parallel for schedule(dynamic, this->_population.size() / thN)
-#endif  //  HEU_HAS_OPENMP
-    for (int index = 0; index < this->_population.size(); index++) {
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(this->_population.size()), [&](int index) {
+      RandStreamScope randScope(randRegion, index);
       Particle_t& i = this->_population[index];
       const double rndP = randD();
       const double rndG = randD();
@@ -112,7 +112,7 @@ class PSO4std : public internal::PSOAbstract<Var_t, double, RecordOpt, Arg_t, BS
         i.position[idx] = std::max(i.position[idx], this->_posMin[idx]);
         i.position[idx] = std::min(i.position[idx], this->_posMax[idx]);
       }
-    }
+    });
   }
 
  private:
@@ -58,7 +58,8 @@ template <class Var_t, class Fitness_t, RecordOption Record, class Arg_t, BoxSha
 class PSOAbstract : public PSOParameterPack<Var_t, Fitness_t, Arg_t>,
                     public PSOParameterPack<Var_t, Fitness_t, Arg_t>::template iFunBody<_iFun_>,
                     public PSOParameterPack<Var_t, Fitness_t, Arg_t>::template fFunBody<_fFun_>,
-                    public Box4PSO<Var_t, BS> {
+                    public Box4PSO<Var_t, BS>,
+                    public BatchFitnessBody<Var_t, Fitness_t, Arg_t> {
   using Base_t = PSOParameterPack<Var_t, Fitness_t, Arg_t>;
 
  public:
@@ -123,6 +124,21 @@ class PSOAbstract : public PSOParameterPack<Var_t, Fitness_t, Arg_t>,
    */
   inline size_t failTimes() const noexcept { return _failTimes; }
 
+  /**
+   * \brief Get the number of fitness evaluations since the run started.
+   *
+   * \return size_t evaluation count.
+   */
+  inline size_t evaluationCount() const noexcept { return _termination.evaluations(); }
+
+  /**
+   * \brief Get the time spent in each phase since the run started. It's empty unless
+   * `HEU_DO_PROFILING` is defined.
+   *
+   * \return const SolverProfile& A const-ref to the profile.
+   */
+  inline const SolverProfile& profile() const noexcept { return _profile; }
+
   /**
    * \brief Get the population
    *
@@ -180,9 +196,11 @@ class PSOAbstract : public PSOParameterPack<Var_t, Fitness_t, Arg_t>,
 
     for (Particle& i : _population) {
       PSOExecutor<Base_t::HasParameters>::doInitialize(this, &i.position, &i.velocity);
+    }
 
-      PSOExecutor<Base_t::HasParameters>::doFitness(this, &i.position, &i.fitness);
+    __impl_computeAllFitness();
 
+    for (Particle& i : _population) {
       i.pBest = i;
     }
 
@@ -201,6 +219,12 @@ class PSOAbstract : public PSOParameterPack<Var_t, Fitness_t, Arg_t>,
   /// failtimes
   size_t _failTimes;
 
+  /// Counters of the termination criteria in option
+  TerminationMonitor _termination;
+
+  /// Timers of phases
+  SolverProfile _profile;
+
   /*
 /// Minimum position
 Var_t _posMin;
@@ -227,43 +251,166 @@ Var_t _velocityMax;
    * __impl_run is designed to be a template function inorder to achieve compile polymorphism, kind
    * of like CRTP
    *
+   * The observer is called with the solver after each generation is evaluated, and the run stops if
+   * it returns false. See `internal::notifyObserver`.
+   *
    * \sa GABase::run
    */
+  template <class this_t = PSOAbstract, class Observer_t>
+  void __impl_run(Observer_t&& observer) noexcept {
+    static_cast<this_t*>(this)->template __impl_startRun<this_t>();
+    if (!notifyObserver(observer, *static_cast<const this_t*>(this))) {
+      return;
+    }
+    static_cast<this_t*>(this)->template __impl_resume<this_t>(observer);
+  }
+
+  /**
+   * \brief Reset counters and records, then evaluate the initial population.
+   */
   template <class this_t = PSOAbstract>
-  void __impl_run() noexcept {
+  void __impl_startRun() noexcept {
     _generation = 0;
     _failTimes = 0;
+    _termination.start();
+    _profile.reset();
 
     static_cast<this_t*>(this)->__impl_clearRecord();
+    static_cast<this_t*>(this)->template __impl_evaluate<this_t>();
+  }
 
-    while (true) {
-      _generation++;
-      static_cast<this_t*>(this)->__impl_computeAllFitness();
-      static_cast<this_t*>(this)->__impl_updatePGBest();
+  /**
+   * \brief Move particles for one generation unless the solver should terminate.
+   *
+   * \return false if the solver has terminated, and nothing is done.
+   */
+  template <class this_t = PSOAbstract>
+  bool __impl_step() noexcept {
+    if (_generation >= _option.maxGeneration) {
+#ifdef HEU_DO_OUTPUT
+      std::cout << "Terminated by max generation limit" << std::endl;
+#endif
+      return false;
+    }
 
-      static_cast<this_t*>(this)->template __impl_recordFitness<this_t>();
-      if (_generation > _option.maxGeneration) {
+    if (_option.maxFailTimes > 0 && _failTimes > _option.maxFailTimes) {
 #ifdef HEU_DO_OUTPUT
-        std::cout << "Terminated by max generation limit" << std::endl;
+      std::cout << "Terminated by max failTime limit" << std::endl;
 #endif
-        break;
-      }
+      return false;
+    }
 
-      if (_option.maxFailTimes > 0 && _failTimes > _option.maxFailTimes) {
+    if (_termination.shouldStop(_option.termination)) {
 #ifdef HEU_DO_OUTPUT
-        std::cout << "Terminated by max failTime limit" << std::endl;
+      std::cout << "Terminated by termination criteria" << std::endl;
 #endif
-        break;
-      }
+      return false;
+    }
 #ifdef HEU_DO_OUTPUT
-      std::cout << "Generation "
-                << _generation
-                //<<" , elite fitness="<<_eliteIt->fitness()
-                << std::endl;
+    std::cout << "Generation "
+              << _generation
+              //<<" , elite fitness="<<_eliteIt->fitness()
+              << std::endl;
 #endif
+    {
+      ProfileTimer timer(&_profile, PHASE_UPDATE_POPULATION);
       static_cast<this_t*>(this)->__impl_updatePopulation();
     }
-    _generation--;
+    _generation++;
+    static_cast<this_t*>(this)->template __impl_evaluate<this_t>();
+    return true;
+  }
+
+  /// Compute fitness, update pBest and gBest, and record fitness.
+  template <class this_t = PSOAbstract>
+  inline void __impl_evaluate() noexcept {
+    {
+      ProfileTimer timer(&_profile, PHASE_FITNESS);
+      static_cast<this_t*>(this)->__impl_computeAllFitness();
+    }
+    {
+      ProfileTimer timer(&_profile, PHASE_UPDATE_PGBEST);
+      static_cast<this_t*>(this)->__impl_updatePGBest();
+    }
+
+    static_cast<this_t*>(this)->template __impl_recordFitness<this_t>();
+  }
+
+  /**
+   * \brief Run generations until the solver terminates. It continues a run after `__impl_startRun`
+   * or `__impl_loadCheckpoint`.
+   */
+  template <class this_t = PSOAbstract, class Observer_t>
+  void __impl_resume(Observer_t&& observer) noexcept {
+    while (static_cast<this_t*>(this)->template __impl_step<this_t>()) {
+      if (!notifyObserver(observer, *static_cast<const this_t*>(this))) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * \brief Write the state of a paused run to a binary stream.
+   *
+   * The checkpoint contains the random state of the calling thread, counters, all particles in
+   * order, gBest and records. Options and functions are not saved.
+   *
+   * \return Whether all bytes are written.
+   */
+  template <class this_t = PSOAbstract>
+  bool __impl_saveCheckpoint(std::ostream& os) const noexcept {
+    writeCheckpointHeader<this_t>(os);
+    writeBinary(os, uint64_t(_generation));
+    writeBinary(os, uint64_t(_failTimes));
+    writeBinary(os, uint64_t(_termination.evaluations()));
+    writeBinary(os, _termination.targetReached());
+    writeBinary(os, uint64_t(_population.size()));
+    for (const Particle& p : _population) {
+      writeBinary(os, p.position);
+      writeBinary(os, p.fitness);
+      writeBinary(os, p.velocity);
+      writeBinary(os, p.pBest.position);
+      writeBinary(os, p.pBest.fitness);
+    }
+    writeBinary(os, gBest.position);
+    writeBinary(os, gBest.fitness);
+    static_cast<const this_t*>(this)->__impl_saveRecord(os);
+    return bool(os);
+  }
+
+  /**
+   * \brief Restore a run written by `__impl_saveCheckpoint`. The time limit starts again from
+   * loading.
+   *
+   * \return false if the stream is truncated or belongs to another kind of solver. The solver must
+   * be initialized again in that case.
+   */
+  template <class this_t = PSOAbstract>
+  bool __impl_loadCheckpoint(std::istream& is) noexcept {
+    uint64_t generation = 0, failTimes = 0, evaluations = 0, popSize = 0;
+    bool targetReached = false;
+    if (!readCheckpointHeader<this_t>(is) || !readBinary(is, &generation) ||
+        !readBinary(is, &failTimes) || !readBinary(is, &evaluations) ||
+        !readBinary(is, &targetReached) || !readBinary(is, &popSize)) {
+      return false;
+    }
+    _population.resize(popSize);
+    for (Particle& p : _population) {
+      if (!readBinary(is, &p.position) || !readBinary(is, &p.fitness) ||
+          !readBinary(is, &p.velocity) || !readBinary(is, &p.pBest.position) ||
+          !readBinary(is, &p.pBest.fitness)) {
+        return false;
+      }
+    }
+    if (!readBinary(is, &gBest.position) || !readBinary(is, &gBest.fitness) ||
+        !static_cast<this_t*>(this)->__impl_loadRecord(is)) {
+      return false;
+    }
+    _generation = generation;
+    _failTimes = failTimes;
+    _termination.resume(evaluations, targetReached);
+    _profile.reset();
+    return true;
   }
 
   /**
@@ -279,24 +426,39 @@ Var_t _velocityMax;
   template <class this_t>
   inline void __impl_recordFitness() noexcept {}
 
+  /// Nothing is saved for non-recording solvers.
+  inline void __impl_saveRecord(std::ostream&) const noexcept {}
+
+  /// Nothing is loaded for non-recording solvers.
+  inline bool __impl_loadRecord(std::istream&) noexcept { return true; }
+
   /**
    * \brief Compute fitness for the whole population
    *
-   * In default cases, this function will boost the fitness computation via multi-threading.
+   * If a batch fitness function is set, the whole population is evaluated with a single call to
+   * it. Otherwise this function will boost the fitness computation via multi-threading.
    */
   void __impl_computeAllFitness() noexcept {
-#ifdef HEU_HAS_OPENMP
-    static const int32_t thN = threadNum();
-#pragma omp parallel for schedule(dynamic, _population.size() / thN)
-    for (int i = 0; i < _population.size(); i++) {
+    _termination.addEvaluations(_population.size());
+    _profile.addFitnessCalls(_population.size());
+    if (this->hasBatchfFun()) {
+      std::vector<const Var_t*> vars(_population.size());
+      std::vector<Fitness_t*> fits(_population.size());
+      for (size_t i = 0; i < _population.size(); i++) {
+        vars[i] = &_population[i].position;
+        fits[i] = &_population[i].fitness;
+      }
+      PSOExecutor<Base_t::HasParameters>::doBatchFitness(this, vars.data(), fits.data(),
+                                                         _population.size());
+      return;
+    }
+
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(_population.size()), [&](int i) {
+      RandStreamScope randScope(randRegion, i);
       Particle* ptr = &_population[i];
       PSOExecutor<Base_t::HasParameters>::doFitness(this, &ptr->position, &ptr->fitness);
-    }
-#else
-    for (Particle& i : _population) {
-      PSOExecutor<Base_t::HasParameters>::doFitness(this, &i.position, &i.fitness);
-    }
-#endif
+    });
   }
 
  private:
@@ -351,6 +513,11 @@ Var_t _velocityMax;
       s->runfFun(pos, &s->_arg, f);
     }
 
+    inline static void doBatchFitness(PSOAbstract* s, const Var_t* const* pos, Fitness_t* const* f,
+                                      size_t n) noexcept {
+      s->runBatchfFun(pos, f, n, &s->_arg);
+    }
+
     static_assert(Base_t::HasParameters == _HasParameters,
                   "A wrong specialization of PSOExecuter is called");
   };
@@ -371,6 +538,11 @@ Var_t _velocityMax;
       s->runfFun(pos, f);
     }
 
+    inline static void doBatchFitness(PSOAbstract* s, const Var_t* const* pos, Fitness_t* const* f,
+                                      size_t n) noexcept {
+      s->runBatchfFun(pos, f, n, nullptr);
+    }
+
     static_assert(Base_t::HasParameters == false,
                   "A wrong specialization of PSOExecuter is called");
   };
@@ -439,6 +611,12 @@ class PSOAbstract<Var_t, Fitness_t, RECORD_FITNESS, Arg_t, BS, _iFun_, _fFun_>
   inline void __impl_recordFitness() noexcept {
     _record.emplace_back(static_cast<this_t*>(this)->bestFitness());
   }
+
+  /// Save the fitness record.
+  inline void __impl_saveRecord(std::ostream& os) const noexcept { writeBinary(os, _record); }
+
+  /// Load the fitness record.
+  inline bool __impl_loadRecord(std::istream& is) noexcept { return readBinary(is, &_record); }
 };
 
 }  //  namespace internal
@@ -56,6 +56,8 @@ struct PSOOption {
   double learnFactorP;
   /// gBest factor, default value is 2
   double learnFactorG;
+  /// Evaluation budget, time limit, target fitness and cancellation. All disabled by default.
+  TerminationCriteria termination;
 };
 
 }  //  namespace heu
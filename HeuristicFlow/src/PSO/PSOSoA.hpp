@@ -0,0 +1,569 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef HEU_PSOSOA_HPP
+#define HEU_PSOSOA_HPP
+
+#include <type_traits>
+#include <vector>
+
+#ifdef HEU_DO_OUTPUT
+#include <iostream>
+#endif
+
+#include "InternalHeaderCheck.h"
+#include <HeuristicFlow/Global>
+#include "PSOOption.hpp"
+#include "PSOParameterPack.hpp"
+#include "BoxWithVelocity.hpp"
+
+namespace heu {
+
+namespace internal {
+
+/**
+ * \ingroup HEU_PSO
+ * \class PSOSoABase
+ * \brief Internal base class for PSO solvers that store the swarm in structure-of-arrays layout.
+ *
+ * Positions, velocities and pBest positions of all particles are stored in 3 dense matrices, each
+ * column of them is a particle. Thus the velocity/position update and clamping are done by a few
+ * vectorized sweeps over the whole swarm.
+ *
+ * This template class has a specilization for solvers with recording.
+ *
+ * \tparam Var_t Type of decision variable. Must be an Eigen vector of floating point numbers.
+ * \tparam FitnessOpt Trainning direction
+ * \tparam RecordOpt Record trainning curve or not.
+ * \tparam Arg_t Any other parameters
+ * \tparam BS Shape of box
+ * \tparam _fFun_ Fitness function at compile time
+ *
+ * \sa PSOAbstract It's array-of-structures counterpart.
+ */
+template <class Var_t, FitnessOption FitnessOpt, RecordOption RecordOpt, class Arg_t, BoxShape BS,
+          typename PSOParameterPack<Var_t, double, Arg_t>::fFun_t _fFun_>
+class PSOSoABase : public PSOParameterPack<Var_t, double, Arg_t>,
+                   public PSOParameterPack<Var_t, double, Arg_t>::template fFunBody<_fFun_>,
+                   public Box4PSO<Var_t, BS>,
+                   public BatchFitnessBody<Var_t, double, Arg_t> {
+  using Base_t = PSOParameterPack<Var_t, double, Arg_t>;
+
+  static_assert(array_traits<Var_t>::isEigenClass && array_traits<Var_t>::isVector,
+                "Var_t of PSOSoA must be an Eigen vector");
+
+ public:
+  ~PSOSoABase() = default;
+  HEU_MAKE_PSOPARAMETERPACK_TYPES(Base_t)
+  using Scalar_t = typename array_traits<Var_t>::Scalar_t;
+
+  static_assert(std::is_floating_point_v<Scalar_t>, "Scalar_t of PSOSoA must be floating point");
+
+  /// Dense matrix that stores a vector for each particle in its columns
+  using Swarm_t = Eigen::Array<Scalar_t, array_traits<Var_t>::sizeCT, Eigen::Dynamic>;
+  /// Column vector of a Swarm_t
+  using Column_t = Eigen::Array<Scalar_t, array_traits<Var_t>::sizeCT, 1>;
+  /// Fitness values of the swarm
+  using SwarmFitness_t = Eigen::Array<double, 1, Eigen::Dynamic>;
+
+  /**
+   * \brief A pair of position together with fitness.
+   */
+  struct Point {
+   public:
+    /// The position of a point
+    Var_t position;
+    /// The fitness value of a point
+    double fitness;
+  };
+
+  static_assert(std::is_same_v<Swarm_t,
+                               typename BatchFitnessBody<Var_t, double, Arg_t>::BatchVar_t>,
+                "The swarm should be able to be passed to the batch fitness function directly");
+
+ public:
+  /**
+   * \brief Set the option object
+   *
+   * \param opt Option of PSO solver
+   */
+  inline void setOption(const PSOOption& opt) noexcept { _option = opt; }
+
+  /**
+   * \brief Get the option object
+   *
+   * \return const PSOOption& A const-ref to the option object
+   */
+  inline const PSOOption& option() const noexcept { return _option; }
+
+  /// Get the generation.
+  inline size_t generation() const noexcept { return _generation; }
+
+  /// Get the fail times.
+  inline size_t failTimes() const noexcept { return _failTimes; }
+
+  /// Number of fitness evaluations since the run started.
+  inline size_t evaluationCount() const noexcept { return _termination.evaluations(); }
+
+  /// Time spent in each phase since the run started. Empty unless `HEU_DO_PROFILING` is defined.
+  inline const SolverProfile& profile() const noexcept { return _profile; }
+
+  /// Number of particles
+  inline int swarmSize() const noexcept { return int(_positions.cols()); }
+
+  /// Positions of all particles, one column for each particle.
+  inline const Swarm_t& positions() const noexcept { return _positions; }
+
+  /// Velocities of all particles, one column for each particle.
+  inline const Swarm_t& velocities() const noexcept { return _velocities; }
+
+  /// The best position that each particle has ever reached, one column for each particle.
+  inline const Swarm_t& pBestPositions() const noexcept { return _pBestPositions; }
+
+  /// Fitness of current position of each particle.
+  inline const SwarmFitness_t& fitness() const noexcept { return _fitness; }
+
+  /// Fitness of pBest of each particle.
+  inline const SwarmFitness_t& pBestFitness() const noexcept { return _pBestFitness; }
+
+  /**
+   * \brief Get the global best solution that PSO has ever found.
+   *
+   * \return const Point& A const-ref to gBest.
+   */
+  inline const Point& globalBest() const noexcept { return gBest; }
+
+  /**
+   * \brief Initialize the whole swarm.
+   *
+   * Positions are sampled uniformly inside the box and velocities are set to 0.
+   */
+  void initializePop() noexcept {
+    const int dim = this->dimensions();
+    const int N = int(_option.populationSize);
+
+    _posMin.resize(dim, 1);
+    _posMax.resize(dim, 1);
+    _velocityMax.resize(dim, 1);
+    for (int r = 0; r < dim; r++) {
+      if constexpr (BS == BoxShape::SQUARE_BOX) {
+        _posMin(r) = this->posMin();
+        _posMax(r) = this->posMax();
+        _velocityMax(r) = this->maxVelocity();
+      } else {
+        _posMin(r) = this->posMin()(r);
+        _posMax(r) = this->posMax()(r);
+        _velocityMax(r) = this->maxVelocity()(r);
+      }
+    }
+
+    _positions.resize(dim, N);
+    for (int c = 0; c < N; c++) {
+      for (int r = 0; r < dim; r++) {
+        _positions(r, c) = randD(_posMin(r), _posMax(r));
+      }
+    }
+    _velocities.setZero(dim, N);
+    _fitness.resize(1, N);
+
+    __impl_computeAllFitness();
+
+    _pBestPositions = _positions;
+    _pBestFitness = _fitness;
+
+    int bestIdx = 0;
+    for (int c = 1; c < N; c++) {
+      if (isBetterThan(_fitness(c), _fitness(bestIdx))) {
+        bestIdx = c;
+      }
+    }
+    gBest.position = _positions.col(bestIdx);
+    gBest.fitness = _fitness(bestIdx);
+
+    _generation = 0;
+    _failTimes = 0;
+  }
+
+ protected:
+  PSOOption _option;   ///< The option of PSO solver
+  size_t _generation;  ///< Generation used.
+  size_t _failTimes;   ///< failtimes
+
+  TerminationMonitor _termination;  ///< Counters of the termination criteria in option
+  SolverProfile _profile;           ///< Timers of phases
+
+  Swarm_t _positions;            ///< Positions of particles
+  Swarm_t _velocities;           ///< Velocities of particles
+  Swarm_t _pBestPositions;       ///< pBest positions of particles
+  SwarmFitness_t _fitness;       ///< Fitness of particles
+  SwarmFitness_t _pBestFitness;  ///< Fitness of pBest
+
+  Column_t _posMin;       ///< Minimum position of each dimension
+  Column_t _posMax;       ///< Maximum position of each dimension
+  Column_t _velocityMax;  ///< Maximum absolute velocity of each dimension
+
+  Point gBest;  ///< The global pBest that the solver has ever found
+
+  static inline bool isBetterThan(double a, double b) noexcept {
+    if constexpr (FitnessOpt == FitnessOption::FITNESS_GREATER_BETTER) {
+      return a > b;
+    } else {
+      return a < b;
+    }
+  }
+
+  /**
+   * \brief run the algorithm
+   *
+   * \sa PSOAbstract::__impl_run
+   */
+  template <class this_t = PSOSoABase, class Observer_t>
+  void __impl_run(Observer_t&& observer) noexcept {
+    static_cast<this_t*>(this)->template __impl_startRun<this_t>();
+    if (!notifyObserver(observer, *static_cast<const this_t*>(this))) {
+      return;
+    }
+    static_cast<this_t*>(this)->template __impl_resume<this_t>(observer);
+  }
+
+  /// \sa PSOAbstract::__impl_startRun
+  template <class this_t = PSOSoABase>
+  void __impl_startRun() noexcept {
+    _generation = 0;
+    _failTimes = 0;
+    _termination.start();
+    _profile.reset();
+
+    static_cast<this_t*>(this)->__impl_clearRecord();
+    static_cast<this_t*>(this)->template __impl_evaluate<this_t>();
+  }
+
+  /// \sa PSOAbstract::__impl_step
+  template <class this_t = PSOSoABase>
+  bool __impl_step() noexcept {
+    if (_generation >= _option.maxGeneration) {
+#ifdef HEU_DO_OUTPUT
+      std::cout << "Terminated by max generation limit" << std::endl;
+#endif
+      return false;
+    }
+
+    if (_option.maxFailTimes > 0 && _failTimes > _option.maxFailTimes) {
+#ifdef HEU_DO_OUTPUT
+      std::cout << "Terminated by max failTime limit" << std::endl;
+#endif
+      return false;
+    }
+
+    if (_termination.shouldStop(_option.termination)) {
+#ifdef HEU_DO_OUTPUT
+      std::cout << "Terminated by termination criteria" << std::endl;
+#endif
+      return false;
+    }
+#ifdef HEU_DO_OUTPUT
+    std::cout << "Generation " << _generation << std::endl;
+#endif
+    {
+      ProfileTimer timer(&_profile, PHASE_UPDATE_POPULATION);
+      __impl_updatePopulation();
+    }
+    _generation++;
+    static_cast<this_t*>(this)->template __impl_evaluate<this_t>();
+    return true;
+  }
+
+  /// Compute fitness, update pBest and gBest, and record fitness.
+  template <class this_t = PSOSoABase>
+  inline void __impl_evaluate() noexcept {
+    {
+      ProfileTimer timer(&_profile, PHASE_FITNESS);
+      __impl_computeAllFitness();
+    }
+    {
+      ProfileTimer timer(&_profile, PHASE_UPDATE_PGBEST);
+      __impl_updatePGBest();
+    }
+
+    static_cast<this_t*>(this)->template __impl_recordFitness<this_t>();
+  }
+
+  /// \sa PSOAbstract::__impl_resume
+  template <class this_t = PSOSoABase, class Observer_t>
+  void __impl_resume(Observer_t&& observer) noexcept {
+    while (static_cast<this_t*>(this)->template __impl_step<this_t>()) {
+      if (!notifyObserver(observer, *static_cast<const this_t*>(this))) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * \brief Write the swarm matrices, gBest, counters and records to a binary stream.
+   *
+   * \sa PSOAbstract::__impl_saveCheckpoint
+   */
+  template <class this_t = PSOSoABase>
+  bool __impl_saveCheckpoint(std::ostream& os) const noexcept {
+    writeCheckpointHeader<this_t>(os);
+    writeBinary(os, uint64_t(_generation));
+    writeBinary(os, uint64_t(_failTimes));
+    writeBinary(os, uint64_t(_termination.evaluations()));
+    writeBinary(os, _termination.targetReached());
+    writeBinary(os, _positions);
+    writeBinary(os, _velocities);
+    writeBinary(os, _pBestPositions);
+    writeBinary(os, _fitness);
+    writeBinary(os, _pBestFitness);
+    writeBinary(os, gBest.position);
+    writeBinary(os, gBest.fitness);
+    static_cast<const this_t*>(this)->__impl_saveRecord(os);
+    return bool(os);
+  }
+
+  /**
+   * \brief Restore a run written by `__impl_saveCheckpoint`. `initializePop` must be called before
+   * to set up the box.
+   *
+   * \sa PSOAbstract::__impl_loadCheckpoint
+   */
+  template <class this_t = PSOSoABase>
+  bool __impl_loadCheckpoint(std::istream& is) noexcept {
+    uint64_t generation = 0, failTimes = 0, evaluations = 0;
+    bool targetReached = false;
+    if (!readCheckpointHeader<this_t>(is) || !readBinary(is, &generation) ||
+        !readBinary(is, &failTimes) || !readBinary(is, &evaluations) ||
+        !readBinary(is, &targetReached)) {
+      return false;
+    }
+    if (!readBinary(is, &_positions) || !readBinary(is, &_velocities) ||
+        !readBinary(is, &_pBestPositions) || !readBinary(is, &_fitness) ||
+        !readBinary(is, &_pBestFitness) || !readBinary(is, &gBest.position) ||
+        !readBinary(is, &gBest.fitness) || !static_cast<this_t*>(this)->__impl_loadRecord(is)) {
+      return false;
+    }
+    _generation = generation;
+    _failTimes = failTimes;
+    _termination.resume(evaluations, targetReached);
+    _profile.reset();
+    return true;
+  }
+
+  inline void __impl_clearRecord() noexcept {}
+
+  template <class this_t>
+  inline void __impl_recordFitness() noexcept {}
+
+  inline void __impl_saveRecord(std::ostream&) const noexcept {}
+
+  inline bool __impl_loadRecord(std::istream&) noexcept { return true; }
+
+  /**
+   * \brief Compute fitness for the whole swarm
+   *
+   * If a batch fitness function is set, the position matrix is passed to it directly without any
+   * copying. Otherwise each column is copied to a `Var_t` and evaluated by fFun, which is
+   * parallelized if OpenMP is used.
+   */
+  void __impl_computeAllFitness() noexcept {
+    _termination.addEvaluations(size_t(_positions.cols()));
+    _profile.addFitnessCalls(size_t(_positions.cols()));
+    if (this->hasBatchfFun()) {
+      if constexpr (Base_t::HasParameters) {
+        this->batchfFun()(&_positions, &this->_arg, &_fitness);
+      } else {
+        this->batchfFun()(&_positions, &_fitness);
+      }
+      assert(_fitness.cols() == _positions.cols());
+      return;
+    }
+
+    const uint64_t randRegion = newRandStreamRegion();
+    parallel_for(0, int(_positions.cols()), [&](int c) {
+      RandStreamScope randScope(randRegion, c);
+      Var_t pos;
+      pos = _positions.col(c);
+      if constexpr (Base_t::HasParameters) {
+        this->runfFun(&pos, &this->_arg, &_fitness(c));
+      } else {
+        this->runfFun(&pos, &_fitness(c));
+      }
+    });
+  }
+
+  /**
+   * \brief Update the value of pBest and gBest
+   */
+  void __impl_updatePGBest() noexcept {
+    int bestIdx = 0;
+    for (int c = 0; c < int(_fitness.cols()); c++) {
+      if (isBetterThan(_fitness(c), _pBestFitness(c))) {
+        _pBestFitness(c) = _fitness(c);
+        _pBestPositions.col(c) = _positions.col(c);
+      }
+      if (isBetterThan(_pBestFitness(c), _pBestFitness(bestIdx))) {
+        bestIdx = c;
+      }
+    }
+
+    if (isBetterThan(_pBestFitness(bestIdx), gBest.fitness)) {
+      _failTimes = 0;
+      gBest.position = _pBestPositions.col(bestIdx);
+      gBest.fitness = _pBestFitness(bestIdx);
+    } else {
+      _failTimes++;
+    }
+    _termination.template reportBestFitness<FitnessOpt>(_option.termination, gBest.fitness);
+  }
+
+  /**
+   * \brief Update the position and velocity of the whole swarm in a few vectorized sweeps.
+   *
+   * Like PSO4Eigen, each particle draws one random factor for pBest and another for gBest.
+   */
+  void __impl_updatePopulation() noexcept {
+    const int N = int(_positions.cols());
+    _randP.resize(1, N);
+    _randG.resize(1, N);
+    for (int c = 0; c < N; c++) {
+      _randP(c) = Scalar_t(randD() * _option.learnFactorP);
+      _randG(c) = Scalar_t(randD() * _option.learnFactorG);
+    }
+
+    const Column_t gBestPos = gBest.position.array();
+
+    // Each assignment is a single fused loop over the swarm, clamping included.
+    _velocities = (Scalar_t(_option.inertiaFactor) * _velocities +
+                   (_pBestPositions - _positions).rowwise() * _randP +
+                   ((-_positions).colwise() + gBestPos).rowwise() * _randG)
+                      .min(_velocityMax.replicate(1, N))
+                      .max(-_velocityMax.replicate(1, N));
+
+    _positions =
+        (_positions + _velocities).min(_posMax.replicate(1, N)).max(_posMin.replicate(1, N));
+  }
+
+ private:
+  // random factors of each particle, kept among generations to avoid reallocating
+  Eigen::Array<Scalar_t, 1, Eigen::Dynamic> _randP;
+  Eigen::Array<Scalar_t, 1, Eigen::Dynamic> _randG;
+};
+
+/**
+ * \ingroup HEU_PSO
+ * \class PSOSoABase<Var_t, FitnessOpt, RECORD_FITNESS, Arg_t, BS, _fFun_>
+ * \brief partial specialization for PSOSoABase with recording
+ *
+ * \note PSOSoABase with record is herited from PSOSoABase without record.
+ */
+template <class Var_t, FitnessOption FitnessOpt, class Arg_t, BoxShape BS,
+          typename PSOParameterPack<Var_t, double, Arg_t>::fFun_t _fFun_>
+class PSOSoABase<Var_t, FitnessOpt, RECORD_FITNESS, Arg_t, BS, _fFun_>
+    : public PSOSoABase<Var_t, FitnessOpt, DONT_RECORD_FITNESS, Arg_t, BS, _fFun_> {
+  using Base_t = PSOSoABase<Var_t, FitnessOpt, DONT_RECORD_FITNESS, Arg_t, BS, _fFun_>;
+  friend Base_t;
+
+ public:
+  ~PSOSoABase() = default;
+
+  /**
+   * \brief Get the fitness record
+   *
+   * \return const std::vector<double>& The fitness record.
+   */
+  const std::vector<double>& record() const noexcept { return _record; }
+
+ protected:
+  /// The fitness record
+  std::vector<double> _record;
+
+  inline void __impl_clearRecord() noexcept {
+    _record.clear();
+    _record.reserve(this->_option.maxGeneration + 1);
+  }
+
+  template <class this_t>
+  inline void __impl_recordFitness() noexcept {
+    _record.emplace_back(static_cast<this_t*>(this)->bestFitness());
+  }
+
+  inline void __impl_saveRecord(std::ostream& os) const noexcept { writeBinary(os, _record); }
+
+  inline bool __impl_loadRecord(std::istream& is) noexcept { return readBinary(is, &_record); }
+};
+
+}  //  namespace internal
+
+/**
+ * \ingroup HEU_PSO
+ * \class PSOSoA
+ * \brief PSO solver that stores the swarm in structure-of-arrays layout.
+ *
+ * PSO stores each particle as a struct in a `std::vector`, and updates particles one by one.
+ * PSOSoA stores positions, velocities and pBest positions of the whole swarm as 3 dense matrices
+ * (one column per particle), and the velocity/position/clamp update is expressed as a few
+ * vectorized sweeps. This layout has much higher throughput when there are thousands of particles
+ * in low dimensions.
+ *
+ * With a batch fitness function set by `setBatchfFun`, the position matrix is passed to it without
+ * copying.
+ *
+ * \tparam Var_t Type of decision variable. Must be an Eigen vector of floating point numbers.
+ * \tparam BS The shape of box-constraint of your PSO solver.
+ * \tparam FitnessOpt Trainning direction (FITNESS_LESS_BETTER)
+ * \tparam RecordOpt Record trainning curve or not. (DONT_RECORD_FITNESS)
+ * \tparam Arg_t Pseudo-global other args stored in the solver. (void)
+ * \tparam _fFun_ Fitness function at compile time (nullptr)
+ *
+ * ## APIs that are different from PSO:
+ * - `const Swarm_t& positions() const` returns positions of all particles.
+ * - `const Swarm_t& velocities() const` returns velocities of all particles.
+ * - `const Swarm_t& pBestPositions() const` returns pBest positions of all particles.
+ * - `const SwarmFitness_t& fitness() const` returns fitness of all particles.
+ * - `const SwarmFitness_t& pBestFitness() const` returns pBest fitness of all particles.
+ * - `int swarmSize() const` returns the number of particles.
+ * - There is no `population()` and no custom initialization function.
+ *
+ * \sa PSO
+ */
+template <typename Var_t, BoxShape BS = BoxShape::RECTANGLE_BOX,
+          FitnessOption FitnessOpt = FITNESS_LESS_BETTER,
+          RecordOption RecordOpt = DONT_RECORD_FITNESS, class Arg_t = void,
+          typename internal::PSOParameterPack<Var_t, double, Arg_t>::fFun_t _fFun_ = nullptr>
+class PSOSoA : public internal::PSOSoABase<Var_t, FitnessOpt, RecordOpt, Arg_t, BS, _fFun_> {
+  using Base_t = internal::PSOSoABase<Var_t, FitnessOpt, RecordOpt, Arg_t, BS, _fFun_>;
+
+ public:
+  PSOSoA() = default;
+  ~PSOSoA() = default;
+
+  HEU_RELOAD_MEMBERFUCTION_RUN
+  HEU_RELOAD_MEMBERFUCTION_CHECKPOINT
+
+  /**
+   * \brief Function used to provide a result for recording
+   *
+   * \return double The best fitness to be recorded
+   */
+  inline double bestFitness() const noexcept { return this->gBest.fitness; }
+};
+
+}  // namespace heu
+
+#endif  // HEU_PSOSOA_HPP
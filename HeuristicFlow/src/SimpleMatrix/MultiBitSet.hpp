@@ -352,12 +352,15 @@ class multiBitSet {
    * \param size__ The initial size.
    */
   explicit multiBitSet(size_t size__) {
+    data_ = nullptr;
+    end_ = nullptr;
+    size_ = 0;
     if (size__ <= 0) {
       return;
     }
 
     // const size_t __bytesNeed = std::ceil(float(eleBits * __size) / 8);
-    const size_t __blocksNeed = size_t(std::ceil(float(size__ * eleBits) / (blockBits)));
+    const size_t __blocksNeed = blocksFor(size__);
     data_ = alloc().allocate(__blocksNeed);
     end_ = data_ + __blocksNeed;
     size_ = size__;
@@ -377,7 +380,7 @@ class multiBitSet {
     if (b.size() > 0) {
       this->resize(b.size());
 
-      memcpy(this->data_, b.data_, b.blocks() * sizeof(block_t));
+      memcpy(this->data_, b.data_, b.usedBlocks() * sizeof(block_t));
     }
   }
 
@@ -430,6 +433,13 @@ class multiBitSet {
    */
   inline block_t* data() noexcept { return data_; }
 
+  /**
+   * \brief The pointer of data
+   *
+   * \return const block_t* A read only pointer to data
+   */
+  inline const block_t* data() const noexcept { return data_; }
+
   /**
    * \brief Blocks uesd to store all elements.
    *
@@ -437,6 +447,46 @@ class multiBitSet {
    */
   [[nodiscard]] inline size_t blocks() const noexcept { return end_ - data_; }
 
+  /**
+   * \brief Blocks that contain at least one element. It may be less than `blocks()` after
+   * shrinking or reserving.
+   *
+   * \return size_t Number of used blocks
+   */
+  [[nodiscard]] inline size_t usedBlocks() const noexcept { return blocksFor(size_); }
+
+  /**
+   * \brief Mask of bits that belong to elements in the last used block. Elements are stored from
+   * the most significant bit, so bits out of the mask are unused.
+   *
+   * \return block_t The mask, all ones if the last block is full.
+   */
+  [[nodiscard]] inline block_t tailMask() const noexcept {
+    const size_t usedBits = (size_ * eleBits) % blockBits;
+    return (usedBits == 0) ? (~block_t(0)) : (~block_t(0) << (blockBits - usedBits));
+  }
+
+  /**
+   * \brief Compare elements of two multiBitSet. Unused bits are ignored.
+   */
+  inline bool operator==(const multiBitSet& another) const noexcept {
+    if (this->size() != another.size()) {
+      return false;
+    }
+    const size_t blockNum = usedBlocks();
+    if (blockNum <= 0) {
+      return true;
+    }
+    for (size_t b = 0; b + 1 < blockNum; b++) {
+      if (data_[b] != another.data_[b]) {
+        return false;
+      }
+    }
+    return ((data_[blockNum - 1] ^ another.data_[blockNum - 1]) & tailMask()) == 0;
+  }
+
+  inline bool operator!=(const multiBitSet& another) const noexcept { return !(*this == another); }
+
   inline reference_t at(size_t idx) noexcept { return this->operator[](idx); }
 
   inline value_t at(size_t idx) const noexcept { return this->operator[](idx); }
@@ -452,23 +502,38 @@ class multiBitSet {
   }
 
   /**
-   * \brief Change the size of multiBitSet
+   * \brief Change the size of multiBitSet. Existing elements are kept and new elements are 0.
    *
    * \param newSize
    */
   inline void resize(size_t newSize) noexcept {
+    // keep existing elements, and new elements are 0 whether or not memory is reallocated
+    const size_t oldBlockNum = usedBlocks();
+    const size_t newBlockNum = blocksFor(newSize);
+
     if (newSize <= this->capacity()) {
+      if (newSize > size_) {
+        // bits after the old size may hold elements dropped by an earlier shrink
+        if (oldBlockNum > 0) {
+          data_[oldBlockNum - 1] &= tailMask();
+        }
+        memset(data_ + oldBlockNum, 0, (newBlockNum - oldBlockNum) * sizeof(block_t));
+      }
       size_ = newSize;
       return;
     }
 
-    const size_t newBlockNum = size_t(std::ceil(float(newSize * eleBits) / (sizeof(block_t) * 8)));
-
     block_t* newDataPtr = alloc().allocate(newBlockNum);
 
-    // memcpy(newDataPtr, _data, _end - _data);
+    if (oldBlockNum > 0) {
+      memcpy(newDataPtr, data_, oldBlockNum * sizeof(block_t));
+      newDataPtr[oldBlockNum - 1] &= tailMask();
+    }
+    memset(newDataPtr + oldBlockNum, 0, (newBlockNum - oldBlockNum) * sizeof(block_t));
 
-    alloc().deallocate(data_, end_ - data_);
+    if (data_ != nullptr) {
+      alloc().deallocate(data_, end_ - data_);
+    }
 
     data_ = newDataPtr;
     end_ = data_ + newBlockNum;
@@ -485,20 +550,21 @@ class multiBitSet {
       return;
     }
 
-    const size_t newBlockNum = std::ceil(float(newCap * eleBits) / (sizeof(block_t) * 8));
+    const size_t newBlockNum = blocksFor(newCap);
 
     block_t* newDataPtr = alloc().allocate(newBlockNum);
 
-    memcpy(newDataPtr, data_, end_ - data_);
-
-    alloc().deallocate(data_, end_ - data_);
+    if (data_ != nullptr) {
+      memcpy(newDataPtr, data_, (end_ - data_) * sizeof(block_t));
+      alloc().deallocate(data_, end_ - data_);
+    }
 
     data_ = newDataPtr;
     end_ = data_ + newBlockNum;
   }
 
   inline void shrink_to_fit() noexcept {
-    const size_t blocksNeed = std::ceil(float(size() * eleBits) / blockBits);
+    const size_t blocksNeed = usedBlocks();
 
     if (blocksNeed == blocks()) {
       return;
@@ -564,7 +630,7 @@ class multiBitSet {
     }
 
     resize(another.size());
-    const size_t blocksNeed = std::ceil(float(size() * eleBits) / blockBits);
+    const size_t blocksNeed = usedBlocks();
 
     memcpy(data_, another.data_, blocksNeed * sizeof(block_t));
     return *this;
@@ -593,6 +659,11 @@ class multiBitSet {
 
   friend class reference_t;
 
+  /// Number of blocks to store `n` elements
+  static inline size_t blocksFor(size_t n) noexcept {
+    return (n * eleBits + blockBits - 1) / blockBits;
+  }
+
   value_t setValue(const size_t index, block_t value) noexcept {
     value &= blockMask;  // remove extra bits
 
@@ -661,6 +732,44 @@ class multiBitSet {
   }
 };
 
+/**
+ * \ingroup HEU_SIMPLEMATRIX
+ * \brief Write a multiBitSet to a checkpoint: its size and then the used blocks.
+ *
+ * \sa internal::writeBinary
+ */
+template <int eleBits, typename block, class allocator_t>
+inline void writeBinary(std::ostream& os,
+                        const multiBitSet<eleBits, block, allocator_t>& v) noexcept {
+  internal::writeBinary(os, uint64_t(v.size()));
+  os.write(reinterpret_cast<const char*>(v.data()),
+           std::streamsize(v.usedBlocks() * sizeof(block)));
+}
+
+/**
+ * \ingroup HEU_SIMPLEMATRIX
+ * \brief Read a multiBitSet written by `writeBinary`. It fails without allocating if the size is
+ * larger than the rest of the stream.
+ *
+ * \sa internal::readBinary
+ */
+template <int eleBits, typename block, class allocator_t>
+inline bool readBinary(std::istream& is, multiBitSet<eleBits, block, allocator_t>* v) noexcept {
+  uint64_t size = 0;
+  constexpr uint64_t blockBits = 8 * sizeof(block);
+  if (!internal::readBinary(is, &size) ||
+      size > (std::numeric_limits<uint64_t>::max() - blockBits) / eleBits) {
+    return false;
+  }
+  const uint64_t blocks = (size * eleBits + blockBits - 1) / blockBits;
+  if (!internal::canReadValues(is, blocks, sizeof(block))) {
+    return false;
+  }
+  v->resize(size);
+  is.read(reinterpret_cast<char*>(v->data()), std::streamsize(v->usedBlocks() * sizeof(block)));
+  return bool(is);
+}
+
 }  // namespace heu
 
 #endif  // HEU_MULTIBITSET_HPP
\ No newline at end of file
@@ -0,0 +1,552 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+/*
+  Performance benchmark of all solvers.
+
+  Every case runs a solver on a built-in test function for a fixed number of generations, and
+  reports wall time per generation, fitness evaluations per second and peak heap usage. Results are
+  written as JSON so that they can be compared between versions.
+
+  Usage: HeuBench [--quick] [--out <file>] [--filter <substring>] [--threads <n1,n2,...>]
+                  [--pop <n1,n2,...>]
+
+  --quick    Use fewer generations and smaller populations. This is what ctest runs.
+  --out      Write JSON to a file instead of stdout.
+  --filter   Only run cases whose name contains the substring.
+  --threads  Numbers of threads to test. Default value is 1 and hardware concurrency.
+  --pop      Population sizes to test. Default value is 100 and 1000.
+*/
+
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/AOS>
+#include <HeuristicFlow/EAGlobal>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout, std::endl;
+
+// Heap usage is measured by counting the bytes of live heap blocks. With glibc, malloc and its
+// family are replaced, so both operator new and Eigen's aligned allocator (which is based on
+// malloc) are counted. Otherwise only global operator new is hooked, and heap blocks of Eigen
+// matrices are missing. The JSON output tells which one is used by "heapCounter".
+namespace heapCounter {
+
+std::atomic<int64_t> liveBytes(0);
+std::atomic<int64_t> peakBytes(0);
+
+inline void add(int64_t n) noexcept {
+  const int64_t cur = (liveBytes += n);
+  int64_t peak = peakBytes.load();
+  while (cur > peak && !peakBytes.compare_exchange_weak(peak, cur)) {
+  }
+}
+
+/// Start a new measurement and return current heap usage.
+inline int64_t reset() noexcept {
+  const int64_t cur = liveBytes.load();
+  peakBytes = cur;
+  return cur;
+}
+
+}  // namespace heapCounter
+
+#ifdef __GLIBC__
+
+#include <malloc.h>
+#include <unistd.h>
+
+// glibc allows an executable to replace malloc, and exports the original implementations.
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+}
+
+namespace heapCounter {
+
+constexpr const char* name = "malloc";
+
+inline void* counted(void* p) noexcept {
+  if (p != nullptr) {
+    add(int64_t(malloc_usable_size(p)));
+  }
+  return p;
+}
+
+}  // namespace heapCounter
+
+extern "C" {
+void* malloc(size_t n) { return heapCounter::counted(__libc_malloc(n)); }
+void* calloc(size_t num, size_t n) { return heapCounter::counted(__libc_calloc(num, n)); }
+void* memalign(size_t align, size_t n) {
+  return heapCounter::counted(__libc_memalign(align, n));
+}
+void* aligned_alloc(size_t align, size_t n) { return memalign(align, n); }
+void* valloc(size_t n) { return memalign(size_t(sysconf(_SC_PAGESIZE)), n); }
+void* pvalloc(size_t n) {
+  const size_t page = size_t(sysconf(_SC_PAGESIZE));
+  return memalign(page, (n + page - 1) / page * page);
+}
+int posix_memalign(void** p, size_t align, size_t n) {
+  if (align % sizeof(void*) != 0 || (align & (align - 1)) != 0) {
+    return EINVAL;
+  }
+  *p = memalign(align, n);
+  return (*p == nullptr && n > 0) ? ENOMEM : 0;
+}
+void free(void* p) {
+  if (p != nullptr) {
+    heapCounter::add(-int64_t(malloc_usable_size(p)));
+    __libc_free(p);
+  }
+}
+void* realloc(void* p, size_t n) {
+  const int64_t before = (p == nullptr) ? 0 : int64_t(malloc_usable_size(p));
+  void* ret = __libc_realloc(p, n);
+  if (ret != nullptr) {
+    heapCounter::add(int64_t(malloc_usable_size(ret)) - before);
+  } else if (n == 0) {
+    heapCounter::add(-before);
+  }
+  return ret;
+}
+}
+
+#else  // __GLIBC__
+
+namespace heapCounter {
+
+constexpr const char* name = "operator new";
+
+// A header is placed before each block to remember its size. 16 bytes keeps the alignment of
+// malloc.
+constexpr size_t headerSize = 16;
+
+inline void* allocate(size_t n) noexcept {
+  char* p = static_cast<char*>(std::malloc(n + headerSize));
+  if (p == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(p, &n, sizeof(n));
+  add(int64_t(n));
+  return p + headerSize;
+}
+
+inline void release(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  char* p = static_cast<char*>(ptr) - headerSize;
+  size_t n;
+  std::memcpy(&n, p, sizeof(n));
+  add(-int64_t(n));
+  std::free(p);
+}
+
+}  // namespace heapCounter
+
+void* operator new(size_t n) {
+  void* p = heapCounter::allocate(n);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return heapCounter::allocate(n); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return heapCounter::allocate(n); }
+void operator delete(void* p) noexcept { heapCounter::release(p); }
+void operator delete[](void* p) noexcept { heapCounter::release(p); }
+void operator delete(void* p, size_t) noexcept { heapCounter::release(p); }
+void operator delete[](void* p, size_t) noexcept { heapCounter::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { heapCounter::release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { heapCounter::release(p); }
+
+#endif  // __GLIBC__
+
+// Fitness functions are wrapped to count evaluations.
+static std::atomic<int64_t> evaluations(0);
+
+template <class Var_t>
+void countedRastrigin(const Var_t* x, double* f) {
+  evaluations++;
+  heu::testFunctions<Var_t>::rastrigin(x, f);
+}
+
+template <class Var_t, class Args_t>
+void countedRastrigin(const Var_t* x, const Args_t*, double* f) {
+  countedRastrigin(x, f);
+}
+
+template <class Var_t, class Fitness_t, int idx>
+void countedDTLZ(const Var_t* x, Fitness_t* f) {
+  evaluations++;
+  using fun_t = heu::testFunctions<Var_t, Fitness_t>;
+  if constexpr (idx == 1) {
+    fun_t::DTLZ1(x, f);
+  } else if constexpr (idx == 2) {
+    fun_t::DTLZ2(x, f);
+  } else if constexpr (idx == 3) {
+    fun_t::DTLZ3(x, f);
+  } else if constexpr (idx == 4) {
+    fun_t::DTLZ4(x, f);
+  } else if constexpr (idx == 5) {
+    fun_t::DTLZ5(x, f);
+  } else if constexpr (idx == 6) {
+    fun_t::DTLZ6(x, f);
+  } else {
+    fun_t::DTLZ7(x, f);
+  }
+}
+
+struct config {
+  bool quick = false;
+  std::string filter;
+  std::vector<int> threads;
+  std::vector<size_t> populations;
+  size_t soGenerations = 200;
+  size_t moGenerations = 100;
+};
+
+struct result {
+  std::string solver;
+  std::string variant;
+  std::string problem;
+  size_t population;
+  int threads;
+  size_t generations;
+  double seconds;
+  int64_t evaluations;
+  int64_t peakHeapBytes;
+  double quality;  ///< Best fitness for single-objective solvers, PF size for multi-objective ones
+};
+
+class benchmark {
+ public:
+  explicit benchmark(const config& c) : _cfg(c) {}
+
+  const std::vector<result>& results() const noexcept { return _results; }
+
+  /**
+   * Run `fun` for every population size and thread count. `fun(popSize)` should configure and run
+   * a solver, and return {generations, quality}.
+   */
+  template <class Fun>
+  void run(const std::string& solver, const std::string& variant, const std::string& problem,
+           Fun&& fun) {
+    const std::string name = solver + "/" + variant + "/" + problem;
+    if (!_cfg.filter.empty() && name.find(_cfg.filter) == std::string::npos) {
+      return;
+    }
+    for (size_t pop : _cfg.populations) {
+      for (int thN : _cfg.threads) {
+        heu::setThreadNum(thN);
+        heu::setRandomSeed(20220101);
+        evaluations = 0;
+        const int64_t heapBefore = heapCounter::reset();
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::pair<size_t, double> ret = fun(pop);
+        const double sec =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        result r{solver,    variant,     problem,     pop,
+                 thN,       ret.first,   sec,         evaluations.load(),
+                 heapCounter::peakBytes.load() - heapBefore, ret.second};
+        std::cerr << name << " pop=" << pop << " threads=" << thN << " : "
+                  << 1e3 * sec / std::max<size_t>(1, r.generations) << " ms/generation" << endl;
+        _results.emplace_back(r);
+      }
+    }
+  }
+
+  const config& cfg() const noexcept { return _cfg; }
+
+ private:
+  config _cfg;
+  std::vector<result> _results;
+};
+
+// SOGA on rastrigin function with each selection method
+template <heu::SelectMethod sm>
+void benchSOGA(benchmark* b, const char* variant) {
+  constexpr int N = 30;
+  using Var_t = Eigen::Array<double, N, 1>;
+  using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+  using solver_t =
+      heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, sm, args_t,
+                heu::GADefaults<Var_t, args_t>::iFun<>, countedRastrigin<Var_t, args_t>,
+                heu::GADefaults<Var_t, args_t>::cFunNd, heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+  b->run("SOGA", variant, "rastrigin30", [b](size_t pop) {
+    solver_t solver;
+    heu::GAOption opt;
+    opt.populationSize = pop;
+    opt.maxGenerations = b->cfg().soGenerations;
+    opt.maxFailTimes = -1;
+    opt.crossoverProb = 0.8;
+    opt.mutateProb = 0.1;
+    solver.setOption(opt);
+
+    args_t args;
+    args.setRange(-5.12, 5.12);
+    args.setDelta(0.02);
+    solver.setArgs(args);
+
+    solver.initializePop();
+    solver.run();
+    return std::make_pair(solver.generation(), solver.bestFitness());
+  });
+}
+
+template <class Var_t>
+void mutateUnitBox(const Var_t* src, Var_t* dst) {
+  *dst = *src;
+  double& p = dst->operator[](heu::randIdx(dst->size()));
+  p = std::clamp(p + 0.1 * heu::randD(-1, 1), 0.0, 1.0);
+}
+
+// NSGA2 and NSGA3 on DTLZ problems with 3 objectives
+template <int idx>
+void benchMOGA(benchmark* b) {
+  constexpr int N = 12, M = 3;
+  using Var_t = Eigen::Array<double, N, 1>;
+  using Fitness_t = Eigen::Array<double, M, 1>;
+  const std::string problem = "DTLZ" + std::to_string(idx);
+
+  b->run("NSGA2", "Default", problem, [b](size_t pop) {
+    heu::NSGA2<Var_t, M, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+               heu::GADefaults<Var_t>::iFunNd<>, countedDTLZ<Var_t, Fitness_t, idx>,
+               heu::GADefaults<Var_t>::cFunNd<>, mutateUnitBox<Var_t>>
+        solver;
+    heu::GAOption opt;
+    opt.populationSize = pop;
+    opt.maxGenerations = b->cfg().moGenerations;
+    opt.crossoverProb = 0.8;
+    opt.mutateProb = 0.1;
+    solver.setOption(opt);
+    solver.initializePop();
+    solver.run();
+    return std::make_pair(solver.generation(), double(solver.pfGenes().size()));
+  });
+
+  b->run("NSGA3", "SingleLayer", problem, [b](size_t pop) {
+    heu::NSGA3<Var_t, M, heu::DONT_RECORD_FITNESS, heu::SINGLE_LAYER, void,
+               heu::GADefaults<Var_t>::iFunNd<>, countedDTLZ<Var_t, Fitness_t, idx>,
+               heu::GADefaults<Var_t>::cFunNd<>, mutateUnitBox<Var_t>>
+        solver;
+    heu::GAOption opt;
+    opt.populationSize = pop;
+    opt.maxGenerations = b->cfg().moGenerations;
+    opt.crossoverProb = 0.8;
+    opt.mutateProb = 0.1;
+    solver.setOption(opt);
+    solver.setReferencePointPrecision(12);
+    solver.initializePop();
+    solver.run();
+    return std::make_pair(solver.generation(), double(solver.pfGenes().size()));
+  });
+}
+
+// PSO, PSOSoA and AOS on rastrigin function
+void benchSwarms(benchmark* b) {
+  constexpr int N = 30;
+  using Var_t = Eigen::Array<double, N, 1>;
+
+  heu::PSOOption psoOpt;
+  psoOpt.maxGeneration = b->cfg().soGenerations;
+  psoOpt.maxFailTimes = -1;
+
+  b->run("PSO", "Eigen", "rastrigin30", [&](size_t pop) {
+    heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+             void, countedRastrigin<Var_t>>
+        solver;
+    psoOpt.populationSize = pop;
+    solver.setOption(psoOpt);
+    solver.setRange(-5.12, 5.12);
+    solver.setMaxVelocity(0.1);
+    solver.initializePop();
+    solver.run();
+    return std::make_pair(solver.generation(), solver.bestFitness());
+  });
+
+  b->run("PSOSoA", "Eigen", "rastrigin30", [&](size_t pop) {
+    heu::PSOSoA<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                heu::DONT_RECORD_FITNESS, void, countedRastrigin<Var_t>>
+        solver;
+    psoOpt.populationSize = pop;
+    solver.setOption(psoOpt);
+    solver.setRange(-5.12, 5.12);
+    solver.setMaxVelocity(0.1);
+    solver.initializePop();
+    solver.run();
+    return std::make_pair(solver.generation(), solver.bestFitness());
+  });
+
+  b->run("AOS", "Eigen", "rastrigin30", [&](size_t pop) {
+    heu::AOS<heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>, heu::FITNESS_LESS_BETTER,
+             heu::DONT_RECORD_FITNESS, void, countedRastrigin<Var_t>>
+        solver;
+    heu::AOSOption opt;
+    opt.electronNum = pop;
+    opt.maxGeneration = b->cfg().soGenerations;
+    opt.maxEarlyStop = opt.maxGeneration;
+    solver.setOption(opt);
+    solver.setRange(-5.12, 5.12);
+    solver.setDelta(0.1);
+    solver.initializePop();
+    solver.run();
+    return std::make_pair(solver.generation(), solver.bestElectron().energy);
+  });
+}
+
+const char* threadingBackend() {
+#if defined(HEU_HAS_OPENMP)
+  return "OpenMP";
+#elif defined(HEU_HAS_THREADPOOL)
+  return "ThreadPool";
+#else
+  return "None";
+#endif
+}
+
+void writeJSON(const benchmark& b, std::ostream& os) {
+  os << "{\n";
+  os << "  \"threadingBackend\": \"" << threadingBackend() << "\",\n";
+  os << "  \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << ",\n";
+  os << "  \"heapCounter\": \"" << heapCounter::name << "\",\n";
+  os << "  \"quick\": " << (b.cfg().quick ? "true" : "false") << ",\n";
+  os << "  \"results\": [";
+  bool first = true;
+  for (const result& r : b.results()) {
+    const double gen = double(std::max<size_t>(1, r.generations));
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "    {\"solver\": \"" << r.solver << "\", \"variant\": \"" << r.variant
+       << "\", \"problem\": \"" << r.problem << "\", \"population\": " << r.population
+       << ", \"threads\": " << r.threads << ", \"generations\": " << r.generations
+       << ", \"seconds\": " << r.seconds << ", \"msPerGeneration\": " << 1e3 * r.seconds / gen
+       << ", \"evaluations\": " << r.evaluations
+       << ", \"evaluationsPerSecond\": " << double(r.evaluations) / std::max(r.seconds, 1e-9)
+       << ", \"peakHeapBytes\": " << r.peakHeapBytes << ", \"quality\": " << r.quality << "}";
+  }
+  os << "\n  ]\n}" << endl;
+}
+
+template <class T>
+std::vector<T> parseList(const char* str) {
+  std::vector<T> ret;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    ret.emplace_back(T(std::stoll(item)));
+  }
+  return ret;
+}
+
+int main(int argc, char** argv) {
+  config cfg;
+  std::string outPath;
+  for (int i = 1; i < argc; i++) {
+    const bool hasNext = (i + 1 < argc);
+    if (std::strcmp(argv[i], "--quick") == 0 || std::strcmp(argv[i], "--auto") == 0) {
+      cfg.quick = true;
+    } else if (std::strcmp(argv[i], "--out") == 0 && hasNext) {
+      outPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--filter") == 0 && hasNext) {
+      cfg.filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--threads") == 0 && hasNext) {
+      cfg.threads = parseList<int>(argv[++i]);
+    } else if (std::strcmp(argv[i], "--pop") == 0 && hasNext) {
+      cfg.populations = parseList<size_t>(argv[++i]);
+    } else {
+      std::cerr << "Unknown argument " << argv[i] << endl;
+      return 1;
+    }
+  }
+
+  if (cfg.threads.empty()) {
+    cfg.threads.emplace_back(1);
+    const int hc = std::max(1, int(std::thread::hardware_concurrency()));
+    if (hc > 1) {
+      cfg.threads.emplace_back(hc);
+    }
+  }
+  if (cfg.populations.empty()) {
+    if (cfg.quick) {
+      cfg.populations = {50};
+    } else {
+      cfg.populations = {100, 1000};
+    }
+  }
+  if (cfg.quick) {
+    cfg.soGenerations = 20;
+    cfg.moGenerations = 10;
+  }
+
+  benchmark b(cfg);
+
+  benchSOGA<heu::SelectMethod::RouletteWheel>(&b, "RouletteWheel");
+  benchSOGA<heu::SelectMethod::Tournament>(&b, "Tournament");
+  benchSOGA<heu::SelectMethod::Truncation>(&b, "Truncation");
+  benchSOGA<heu::SelectMethod::MonteCarlo>(&b, "MonteCarlo");
+  benchSOGA<heu::SelectMethod::Probability>(&b, "Probability");
+  benchSOGA<heu::SelectMethod::LinearRank>(&b, "LinearRank");
+  benchSOGA<heu::SelectMethod::ExponentialRank>(&b, "ExponentialRank");
+  benchSOGA<heu::SelectMethod::Boltzmann>(&b, "Boltzmann");
+  benchSOGA<heu::SelectMethod::StochasticUniversal>(&b, "StochasticUniversal");
+  benchSOGA<heu::SelectMethod::EliteReserved>(&b, "EliteReserved");
+
+  benchMOGA<1>(&b);
+  benchMOGA<2>(&b);
+  benchMOGA<3>(&b);
+  benchMOGA<4>(&b);
+  benchMOGA<5>(&b);
+  benchMOGA<6>(&b);
+  benchMOGA<7>(&b);
+
+  benchSwarms(&b);
+
+  if (outPath.empty()) {
+    writeJSON(b, cout);
+  } else {
+    std::ofstream ofs(outPath);
+    if (!ofs) {
+      std::cerr << "Failed to open " << outPath << endl;
+      return 1;
+    }
+    writeJSON(b, ofs);
+  }
+  return 0;
+}
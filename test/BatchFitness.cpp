@@ -0,0 +1,166 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/AOS>
+#include <HeuristicFlow/EAGlobal>
+#include <array>
+#include <cmath>
+#include <iostream>
+using namespace std;
+
+static int batchCalls = 0;
+
+// Vectorized rastrigin function, each column is a decision variable.
+template <class BatchVar_t, class BatchFitness_t>
+void rastriginBatch(const BatchVar_t* x, BatchFitness_t* f) {
+  batchCalls++;
+  f->row(0) = 10.0 * x->rows() +
+              (x->square() - 10 * (x->operator*(2 * M_PI)).cos()).colwise().sum();
+}
+
+template <class Var_t>
+bool isClose(const Var_t& x, double f) {
+  double ref;
+  heu::testFunctions<Var_t>::rastrigin(&x, &ref);
+  if (std::abs(ref - f) > 1e-9) {
+    cout << "Batch fitness " << f << " differs from " << ref << endl;
+    return false;
+  }
+  return true;
+}
+
+bool testSOGA() {
+  using Var_t = array<double, 4>;
+  using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+  using solver_t =
+      heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+                heu::SelectMethod::Tournament, args_t, heu::GADefaults<Var_t, args_t>::iFun<>,
+                nullptr, heu::GADefaults<Var_t, args_t>::cFunNd,
+                heu::GADefaults<Var_t, args_t>::mFun<>>;
+  solver_t solver;
+
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 30;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  solver.setArgs(args);
+
+  solver.setBatchfFun(
+      [](const solver_t::BatchVar_t* x, const args_t*, solver_t::BatchFitness_t* f) {
+        rastriginBatch(x, f);
+      });
+
+  batchCalls = 0;
+  solver.initializePop();
+  solver.run();
+
+  if (batchCalls != int(solver.generation()) + 1) {
+    cout << "SOGA called batch fitness function " << batchCalls << " times in "
+         << solver.generation() << " generations" << endl;
+    return false;
+  }
+  for (const auto& gene : solver.population()) {
+    if (!isClose(gene.decision_variable, gene.fitness)) {
+      return false;
+    }
+  }
+  cout << "SOGA with batch fitness : " << solver.bestFitness() << endl;
+  return true;
+}
+
+bool testPSO() {
+  using Var_t = Eigen::Array<double, 4, 1>;
+  using solver_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX>;
+  solver_t solver;
+
+  heu::PSOOption opt;
+  opt.populationSize = 50;
+  opt.maxGeneration = 30;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.setBatchfFun(rastriginBatch<solver_t::BatchVar_t, solver_t::BatchFitness_t>);
+
+  batchCalls = 0;
+  solver.initializePop();
+  solver.run();
+
+  // one more call when initializing
+  if (batchCalls != int(solver.generation()) + 2) {
+    cout << "PSO called batch fitness function " << batchCalls << " times in "
+         << solver.generation() << " generations" << endl;
+    return false;
+  }
+  for (const auto& p : solver.population()) {
+    if (!isClose(p.position, p.fitness) || !isClose(p.pBest.position, p.pBest.fitness)) {
+      return false;
+    }
+  }
+  cout << "PSO with batch fitness : " << solver.bestFitness() << endl;
+  return true;
+}
+
+bool testAOS() {
+  using Var_t = Eigen::Array<double, 4, 1>;
+  using solver_t =
+      heu::AOS<heu::FixedContinousBox17<Var_t, heu::encode(-5.0), heu::encode(5.0),
+                                        heu::encode(1.5)>,
+               heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void>;
+  solver_t solver;
+
+  heu::AOSOption opt;
+  opt.electronNum = 50;
+  opt.maxEarlyStop = 20;
+  opt.maxGeneration = 30;
+  opt.photonRate = 0.1;
+  opt.maxLayerNum = 5;
+  solver.setOption(opt);
+  solver.setBatchfFun(rastriginBatch<solver_t::BatchVar_t, solver_t::BatchFitness_t>);
+
+  batchCalls = 0;
+  solver.initializePop();
+  solver.run();
+
+  if (batchCalls <= 0) {
+    cout << "AOS didn't call batch fitness function" << endl;
+    return false;
+  }
+  for (const auto& e : solver.electrons()) {
+    if (!isClose(e.state, e.energy)) {
+      return false;
+    }
+  }
+  cout << "AOS with batch fitness : " << solver.bestElectron().energy << endl;
+  return true;
+}
+
+int main() {
+  if (!testSOGA() || !testPSO() || !testAOS()) {
+    return 1;
+  }
+  return 0;
+}
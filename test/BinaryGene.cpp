@@ -0,0 +1,207 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <HeuristicFlow/Genetic>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <vector>
+using namespace std;
+
+using heu::binaryGene_t;
+using ops_t = heu::BinaryGADefaults;
+
+vector<bool> toBools(const binaryGene_t& v) {
+  vector<bool> b(v.size());
+  for (size_t i = 0; i < v.size(); i++) {
+    b[i] = v[i];
+  }
+  return b;
+}
+
+// popcount, Hamming distance and serialization agree with bit-by-bit results
+bool testUtilities() {
+  for (size_t N : {1, 63, 64, 65, 1000}) {
+    binaryGene_t a, b;
+    ops_t::initialize(&a, N);
+    ops_t::initialize(&b, N);
+    const vector<bool> ba = toBools(a), bb = toBools(b);
+    size_t count = 0, distance = 0;
+    for (size_t i = 0; i < N; i++) {
+      count += ba[i];
+      distance += (ba[i] != bb[i]);
+    }
+    if (heu::popcount(a) != count || heu::hammingDistance(a, b) != distance) {
+      cout << "popcount or Hamming distance is wrong with " << N << " bits" << endl;
+      return false;
+    }
+
+    std::stringstream ss;
+    heu::writeBinary(ss, a);
+    binaryGene_t restored;
+    if (!heu::readBinary(ss, &restored) || restored != a) {
+      cout << "Failed to restore a binary gene with " << N << " bits" << endl;
+      return false;
+    }
+
+    // New elements are 0 after a shrink and a grow, with or without reallocation
+    for (size_t grown : {N, N + 100}) {
+      binaryGene_t c = a;
+      c.resize(N / 2);
+      c.resize(grown);
+      const vector<bool> bc = toBools(c);
+      for (size_t i = 0; i < grown; i++) {
+        if (bc[i] != ((i < N / 2) && ba[i])) {
+          cout << "Wrong element after resizing " << N << " bits to " << grown << endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  // masks with probability 0.25 and 0.5
+  size_t ones25 = 0, ones50 = 0;
+  for (int i = 0; i < 1000; i++) {
+    ones25 += heu::internal::popcountBlock(ops_t::randomMask(0.25));
+    ones50 += heu::internal::popcountBlock(ops_t::randomMask(0.5));
+  }
+  cout << "Ratio of 1 in masks : " << ones25 / 64000.0 << ", " << ones50 / 64000.0 << endl;
+  return std::abs(ones25 / 64000.0 - 0.25) < 0.01 && std::abs(ones50 / 64000.0 - 0.5) < 0.01;
+}
+
+// Children of crossovers take each bit from one of the parents, and they're complementary
+bool testOperators() {
+  const size_t N = 1000;
+  binaryGene_t p1, p2, c1, c2;
+  ops_t::initialize(&p1, N);
+  p2 = p1;
+  ops_t::flipBits(&p2, 0.5);
+  const vector<bool> b1 = toBools(p1), b2 = toBools(p2);
+
+  for (int trial = 0; trial < 20; trial++) {
+    if (trial % 2 == 0) {
+      ops_t::cFunRandb<>(&p1, &p2, &c1, &c2);
+    } else {
+      ops_t::cFunNPointb<3>(&p1, &p2, &c1, &c2);
+    }
+    const vector<bool> d1 = toBools(c1), d2 = toBools(c2);
+    size_t switches = 0;
+    bool fromP1 = true;
+    for (size_t i = 0; i < N; i++) {
+      if (d1[i] == d2[i] ? (d1[i] != b1[i] || b1[i] != b2[i])
+                         : !((d1[i] == b1[i] && d2[i] == b2[i]) ||
+                             (d1[i] == b2[i] && d2[i] == b1[i]))) {
+        cout << "Children have bits that don't come from parents" << endl;
+        return false;
+      }
+      if (b1[i] != b2[i] && (d1[i] == b1[i]) != fromP1) {
+        fromP1 = !fromP1;
+        switches++;
+      }
+    }
+    if (trial % 2 == 1 && switches > 3) {
+      cout << "3-point crossover switched parents for " << switches << " times" << endl;
+      return false;
+    }
+  }
+
+  // mutation flips about rate*N bits, and at least one
+  size_t flipped = 0;
+  for (int trial = 0; trial < 100; trial++) {
+    ops_t::mFunb<heu::DivEncode<1, 100>::code>(&p1, &c1);
+    const size_t d = heu::hammingDistance(p1, c1);
+    if (d <= 0) {
+      cout << "Mutation doesn't change the gene" << endl;
+      return false;
+    }
+    flipped += d;
+  }
+  cout << "Average flipped bits : " << flipped / 100.0 << endl;
+  return flipped > 700 && flipped < 1300;
+}
+
+struct Knapsack {
+  vector<double> weights;
+  vector<double> values;
+  double capacity;
+  int dimensions() const { return int(weights.size()); }
+};
+
+void knapsackFitness(const binaryGene_t* x, const Knapsack* k, double* f) {
+  double weight = 0, value = 0;
+  for (size_t i = 0; i < x->size(); i++) {
+    if ((*x)[i]) {
+      weight += k->weights[i];
+      value += k->values[i];
+    }
+  }
+  *f = (weight <= k->capacity) ? value : k->capacity - weight;
+}
+
+// SOGA solves a 1000-item knapsack problem with packed genes
+bool testKnapsack() {
+  const size_t N = 1000;
+  Knapsack k;
+  for (size_t i = 0; i < N; i++) {
+    k.weights.emplace_back(heu::randD(1.0, 10.0));
+    k.values.emplace_back(k.weights.back() + heu::randD(0.0, 5.0));
+  }
+  k.capacity = std::accumulate(k.weights.begin(), k.weights.end(), 0.0) / 4;
+
+  // greedy by value density as a baseline
+  vector<size_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&k](size_t a, size_t b) {
+    return k.values[a] / k.weights[a] > k.values[b] / k.weights[b];
+  });
+  double greedyWeight = 0, greedyValue = 0;
+  for (size_t i : order) {
+    if (greedyWeight + k.weights[i] <= k.capacity) {
+      greedyWeight += k.weights[i];
+      greedyValue += k.values[i];
+    }
+  }
+
+  heu::SOGA<binaryGene_t, heu::FITNESS_GREATER_BETTER, heu::DONT_RECORD_FITNESS,
+            heu::SelectMethod::Tournament, Knapsack, ops_t::iFunXb<Knapsack>, knapsackFitness,
+            ops_t::cFunNPointb<2>, ops_t::mFunb<heu::DivEncode<1, 1000>::code>>
+      solver;
+  heu::GAOption opt;
+  opt.populationSize = 100;
+  opt.maxGenerations = 1000;
+  opt.maxFailTimes = 1000;
+  opt.mutateProb = 0.5;
+  solver.setOption(opt);
+  solver.setArgs(k);
+  solver.initializePop();
+  solver.run();
+
+  cout << "Knapsack : " << solver.generation() << " generations, GA value = " << solver.bestFitness()
+       << ", greedy value = " << greedyValue << endl;
+  return solver.bestFitness() > 0.9 * greedyValue;
+}
+
+int main() {
+  heu::setRandomSeed(20221017);
+  if (!testUtilities() || !testOperators() || !testKnapsack()) {
+    return 1;
+  }
+  cout << "Binary genes are correct" << endl;
+  return 0;
+}
@@ -208,8 +208,67 @@ void test_Box() {
   // static_assert(heu::isBoxConstraint<decltype(box0)>);
 }
 
+// whole-vector clamping and initialization agree with the element-wise ones
+template <class Box_t>
+bool test_clampAndInitialize(const Box_t& box) {
+  using Var_t = typename Box_t::Var_t;
+  for (int trial = 0; trial < 100; trial++) {
+    Var_t v, expected;
+    box.initialize(&v);
+    for (int idx = 0; idx < box.dimensions(); idx++) {
+      if (heu::at(v, idx) < box.min(idx) || heu::at(v, idx) > box.max(idx)) {
+        cout << "Initialized value out of the box" << endl;
+        return false;
+      }
+      heu::at(v, idx) += heu::randD(-5, 5);
+    }
+    expected = v;
+    for (int idx = 0; idx < box.dimensions(); idx++) {
+      box.applyConstraint(&expected, idx);
+    }
+    box.applyConstraint(&v);
+    for (int idx = 0; idx < box.dimensions(); idx++) {
+      if (heu::at(v, idx) != heu::at(expected, idx)) {
+        cout << "Whole-vector clamping differs from element-wise clamping" << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool test_vectorizedBoxes() {
+  heu::ContinousBox<Eigen::ArrayXd, BoxShape::SQUARE_BOX> squareEigen;
+  squareEigen.setDimensions(37);
+  squareEigen.setRange(-1, 2);
+
+  heu::ContinousBox<Eigen::Array<double, 3, 4>, BoxShape::RECTANGLE_BOX> rectEigen;
+  for (int idx = 0; idx < rectEigen.dimensions(); idx++) {
+    rectEigen.min()(idx) = -idx * 0.5;
+    rectEigen.max()(idx) = 1 + idx;
+  }
+
+  heu::DiscretBox<std::vector<double>, BoxShape::SQUARE_BOX> squareStd;
+  squareStd.setDimensions(19);
+  squareStd.setRange(-3, 3);
+
+  heu::DiscretBox<std::array<double, 5>, BoxShape::RECTANGLE_BOX> rectStd;
+  rectStd.setRange({-1, -2, -3, -4, -5}, {0, 1, 2, 3, 4});
+
+  heu::DiscretBox<std::vector<float>, BoxShape::SQUARE_BOX> squareFloat;
+  squareFloat.setDimensions(9);
+  squareFloat.setRange(0, 1);
+
+  return test_clampAndInitialize(squareEigen) && test_clampAndInitialize(rectEigen) &&
+         test_clampAndInitialize(squareStd) && test_clampAndInitialize(rectStd) &&
+         test_clampAndInitialize(squareFloat);
+}
+
 int main() {
   test_Box();
+  if (!test_vectorizedBoxes()) {
+    return 1;
+  }
   // system("pause");
   return 0;
 }
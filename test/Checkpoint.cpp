@@ -0,0 +1,360 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/AOS>
+#include <HeuristicFlow/EAGlobal>
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+using Var_t = Eigen::Array<double, 6, 1>;
+using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+
+void mutateInUnitBox(const Var_t* src, Var_t* dst) {
+  *dst = *src;
+  const size_t idx = heu::randIdx(dst->size());
+  (*dst)[idx] = std::min(1.0, std::max(0.0, (*dst)[idx] + 0.05 * heu::randD(-1, 1)));
+}
+
+/**
+ * Run a seeded solver to the end and save a checkpoint at generation `pauseAt`, then load the
+ * checkpoint into a newly initialized solver and resume it. Both runs must end identically.
+ */
+template <class Solver_t, class Setup_t, class Equal_t>
+bool testRestore(const char* name, Setup_t setup, Equal_t isEqual, size_t pauseAt) {
+  heu::setRandomSeed(20221017);
+  Solver_t original;
+  setup(&original);
+  std::stringstream checkpoint;
+  bool saved = false;
+  original.run([&](const Solver_t& s) {
+    if (s.generation() == pauseAt) {
+      saved = s.saveCheckpoint(checkpoint);
+    }
+  });
+
+  // Restore on a solver whose random streams have moved on
+  heu::setRandomSeed(114514);
+  Solver_t restored;
+  setup(&restored);
+  if (!saved || !restored.loadCheckpoint(checkpoint) || restored.generation() != pauseAt) {
+    cout << name << " failed to save or load the checkpoint" << endl;
+    return false;
+  }
+  restored.resume();
+
+  if (restored.generation() != original.generation() || !isEqual(original, restored)) {
+    cout << name << " didn't reproduce the trajectory after restoring" << endl;
+    return false;
+  }
+  cout << name << " restored at generation " << pauseAt << " with " << checkpoint.str().size()
+       << " bytes, finished at generation " << restored.generation() << endl;
+  return true;
+}
+
+inline bool isSame(double a, double b) { return a == b; }
+
+template <class Derived>
+bool isSame(const Eigen::ArrayBase<Derived>& a, const Eigen::ArrayBase<Derived>& b) {
+  return (a == b).all();
+}
+
+template <class Solver_t>
+bool isSamePopulation(const Solver_t& a, const Solver_t& b) {
+  if (a.population().size() != b.population().size()) {
+    return false;
+  }
+  auto itB = b.population().begin();
+  for (const auto& gene : a.population()) {
+    if (!isSame(gene.decision_variable, itB->decision_variable) ||
+        !isSame(gene.fitness, itB->fitness)) {
+      return false;
+    }
+    ++itB;
+  }
+  return true;
+}
+
+bool testSOGA() {
+  using soga_t = heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::RECORD_FITNESS,
+                           heu::SelectMethod::Tournament, args_t,
+                           heu::GADefaults<Var_t, args_t>::iFun<>, nullptr,
+                           heu::GADefaults<Var_t, args_t>::cFunSwapNs,
+                           heu::GADefaults<Var_t, args_t>::mFun<>>;
+  auto setup = [](soga_t* solver) {
+    heu::GAOption opt;
+    opt.populationSize = 50;
+    opt.maxGenerations = 60;
+    opt.maxFailTimes = -1;
+    solver->setOption(opt);
+    args_t args;
+    args.setRange(-5, 5);
+    args.setDelta(0.05);
+    solver->setArgs(args);
+    solver->setfFun([](const Var_t* x, const args_t*, double* f) {
+      heu::testFunctions<Var_t>::rastrigin(x, f);
+    });
+    solver->initializePop();
+  };
+  return testRestore<soga_t>(
+      "SOGA", setup,
+      [](const soga_t& a, const soga_t& b) {
+        return a.record() == b.record() && (a.result() == b.result()).all() &&
+               a.evaluationCount() == b.evaluationCount() && isSamePopulation(a, b);
+      },
+      25);
+}
+
+bool testNSGA2() {
+  using nsga2_t =
+      heu::NSGA2<Var_t, 3, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                 heu::GADefaults<Var_t, void>::iFunNd<>,
+                 heu::testFunctions<Var_t, Eigen::Array3d>::DTLZ1,
+                 heu::GADefaults<Var_t, void>::cFunNd<>, mutateInUnitBox>;
+  auto setup = [](nsga2_t* solver) {
+    heu::GAOption opt;
+    opt.populationSize = 60;
+    opt.maxGenerations = 40;
+    solver->setOption(opt);
+    solver->setArchiveEnabled(true);
+    solver->archive().setCapacity(100);
+    solver->initializePop();
+  };
+  return testRestore<nsga2_t>(
+      "NSGA2", setup,
+      [](const nsga2_t& a, const nsga2_t& b) {
+        nsga2_t::Archive_t::Front_t archiveA, archiveB;
+        a.archive().paretoFront(archiveA);
+        b.archive().paretoFront(archiveB);
+        return isSamePopulation(a, b) && a.pfGenes().size() == b.pfGenes().size() &&
+               archiveA.cols() > 0 && archiveA.cols() == archiveB.cols() &&
+               isSame(archiveA, archiveB);
+      },
+      15);
+}
+
+bool testNSGA3() {
+  using nsga3_t = heu::NSGA3<Var_t, 3, heu::DONT_RECORD_FITNESS, heu::SINGLE_LAYER, void,
+                             heu::GADefaults<Var_t, void>::iFunNd<>,
+                             heu::testFunctions<Var_t, Eigen::Array3d>::DTLZ1,
+                             heu::GADefaults<Var_t, void>::cFunNd<>, mutateInUnitBox>;
+  auto setup = [](nsga3_t* solver) {
+    heu::GAOption opt;
+    opt.populationSize = 60;
+    opt.maxGenerations = 40;
+    solver->setOption(opt);
+    solver->setReferencePointPrecision(6);
+    solver->initializePop();
+  };
+  return testRestore<nsga3_t>(
+      "NSGA3", setup,
+      [](const nsga3_t& a, const nsga3_t& b) {
+        return isSamePopulation(a, b) && a.pfGenes().size() == b.pfGenes().size() &&
+               (a.referencePoints() == b.referencePoints()).all();
+      },
+      15);
+}
+
+bool testPSO() {
+  using pso_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                         heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  auto setup = [](pso_t* solver) {
+    heu::PSOOption opt;
+    opt.populationSize = 100;
+    opt.maxGeneration = 50;
+    opt.maxFailTimes = -1;
+    solver->setOption(opt);
+    solver->setRange(-5.12, 5.12);
+    solver->setMaxVelocity(0.1);
+    solver->initializePop();
+  };
+  return testRestore<pso_t>(
+      "PSO", setup,
+      [](const pso_t& a, const pso_t& b) {
+        if (a.record() != b.record() || a.population().size() != b.population().size()) {
+          return false;
+        }
+        for (size_t i = 0; i < a.population().size(); i++) {
+          if ((a.population()[i].position != b.population()[i].position).any() ||
+              (a.population()[i].velocity != b.population()[i].velocity).any()) {
+            return false;
+          }
+        }
+        return true;
+      },
+      20);
+}
+
+bool testPSOSoA() {
+  using soa_t = heu::PSOSoA<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  auto setup = [](soa_t* solver) {
+    heu::PSOOption opt;
+    opt.populationSize = 100;
+    opt.maxGeneration = 50;
+    opt.maxFailTimes = -1;
+    solver->setOption(opt);
+    solver->setRange(-5.12, 5.12);
+    solver->setMaxVelocity(0.1);
+    solver->initializePop();
+  };
+  return testRestore<soa_t>(
+      "PSOSoA", setup,
+      [](const soa_t& a, const soa_t& b) {
+        return a.record() == b.record() && (a.positions() == b.positions()).all() &&
+               (a.velocities() == b.velocities()).all();
+      },
+      20);
+}
+
+bool testAOS() {
+  using aos_t = heu::AOS<heu::FixedContinousBox17<Var_t, heu::encode(-5.0), heu::encode(5.0),
+                                                  heu::encode(1.5)>,
+                         heu::FITNESS_LESS_BETTER, heu::RECORD_FITNESS, void,
+                         heu::testFunctions<Var_t>::rastrigin>;
+  auto setup = [](aos_t* solver) {
+    heu::AOSOption opt;
+    opt.maxGeneration = 40;
+    opt.maxEarlyStop = 100;
+    solver->setOption(opt);
+    solver->initializePop();
+  };
+  return testRestore<aos_t>(
+      "AOS", setup,
+      [](const aos_t& a, const aos_t& b) {
+        if (a.record() != b.record() || a.electrons().size() != b.electrons().size()) {
+          return false;
+        }
+        auto itB = b.electrons().begin();
+        for (const auto& elec : a.electrons()) {
+          if ((elec.state != itB->state).any() || elec.energy != itB->energy) {
+            return false;
+          }
+          ++itB;
+        }
+        return true;
+      },
+      10);
+}
+
+// Broken checkpoints and checkpoints of other solvers are rejected
+bool testRejection() {
+  using pso_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                         heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  using soa_t = heu::PSOSoA<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  pso_t pso;
+  heu::PSOOption opt;
+  opt.populationSize = 20;
+  opt.maxGeneration = 5;
+  pso.setOption(opt);
+  pso.setRange(-5.12, 5.12);
+  pso.setMaxVelocity(0.1);
+  pso.initializePop();
+  pso.run();
+
+  std::stringstream checkpoint;
+  pso.saveCheckpoint(checkpoint);
+  const std::string bytes = checkpoint.str();
+
+  soa_t soa;
+  soa.setOption(opt);
+  soa.setRange(-5.12, 5.12);
+  soa.setMaxVelocity(0.1);
+  soa.initializePop();
+  std::stringstream another(bytes);
+  if (soa.loadCheckpoint(another)) {
+    cout << "A PSO checkpoint is loaded by PSOSoA" << endl;
+    return false;
+  }
+
+  std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+  pso.initializePop();
+  if (pso.loadCheckpoint(truncated)) {
+    cout << "A truncated checkpoint is loaded" << endl;
+    return false;
+  }
+  return true;
+}
+
+// Overwrite the leading size of a written value
+template <class T>
+std::string withHugeSize(const T& v, uint64_t size) {
+  std::stringstream ss;
+  heu::internal::writeBinary(ss, v);
+  std::string bytes = ss.str();
+  bytes.replace(0, sizeof(size), reinterpret_cast<const char*>(&size), sizeof(size));
+  return bytes;
+}
+
+// Sizes in corrupt checkpoints are rejected before anything is allocated
+bool testCorruptSizes() {
+  const uint64_t huge = uint64_t(1) << 60;
+  std::vector<double> v{1, 2, 3};
+  std::stringstream vs(withHugeSize(v, huge));
+  if (heu::internal::readBinary(vs, &v) || v.size() != 3) {
+    cout << "A vector with a corrupt size is loaded" << endl;
+    return false;
+  }
+
+  std::vector<std::vector<int>> nested{{1}, {2, 3}};
+  std::stringstream ns(withHugeSize(nested, huge));
+  if (heu::internal::readBinary(ns, &nested) || nested.size() != 2) {
+    cout << "A nested vector with a corrupt size is loaded" << endl;
+    return false;
+  }
+
+  Eigen::ArrayXXd mat = Eigen::ArrayXXd::Ones(2, 3);
+  std::stringstream ms(withHugeSize(mat, uint64_t(1) << 31));
+  if (heu::internal::readBinary(ms, &mat) || mat.size() != 6) {
+    cout << "A matrix with a corrupt shape is loaded" << endl;
+    return false;
+  }
+
+  heu::multiBitSet<1> bits(100);
+  bits[7] = 1;
+  std::stringstream bs;
+  heu::writeBinary(bs, bits);
+  heu::multiBitSet<1> loaded;
+  if (!heu::readBinary(bs, &loaded) || loaded != bits) {
+    cout << "Failed to load a multiBitSet" << endl;
+    return false;
+  }
+  const std::string bitBytes = bs.str();
+  std::string corrupt = bitBytes;
+  corrupt.replace(0, sizeof(huge), reinterpret_cast<const char*>(&huge), sizeof(huge));
+  std::stringstream cs(corrupt);
+  std::stringstream ts(bitBytes.substr(0, bitBytes.size() - 1));
+  if (heu::readBinary(cs, &loaded) || heu::readBinary(ts, &loaded)) {
+    cout << "A multiBitSet with a corrupt size is loaded" << endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  if (!testSOGA() || !testNSGA2() || !testNSGA3() || !testPSO() || !testPSOSoA() || !testAOS() ||
+      !testRejection() || !testCorruptSizes()) {
+    return 1;
+  }
+  cout << "All checkpoints are restored correctly" << endl;
+  return 0;
+}
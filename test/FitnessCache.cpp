@@ -0,0 +1,202 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/EAGlobal>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <vector>
+using namespace std;
+
+class cache_t : public heu::internal::FitnessCacheBody<int, double> {
+ public:
+  using heu::internal::FitnessCacheBody<int, double>::findCachedFitness;
+  using heu::internal::FitnessCacheBody<int, double>::cacheFitness;
+};
+
+class doubleCache_t : public heu::internal::FitnessCacheBody<double, double> {
+ public:
+  using heu::internal::FitnessCacheBody<double, double>::findCachedFitness;
+  using heu::internal::FitnessCacheBody<double, double>::cacheFitness;
+  using heu::internal::FitnessCacheBody<double, double>::removeDuplicatedTasks;
+};
+
+struct gene_t {
+  double decision_variable;
+  double fitness;
+};
+
+// The cache holds at most capacity entries, and evicts entries that are not used recently
+bool testClockEviction() {
+  cache_t cache;
+  double f;
+  if (cache.isFitnessCacheEnabled() || cache.findCachedFitness(0, &f)) {
+    cout << "Cache should be disabled by default" << endl;
+    return false;
+  }
+
+  cache.setFitnessCacheCapacity(3);
+  cache.cacheFitness(1, 1.0);
+  cache.cacheFitness(2, 2.0);
+  cache.cacheFitness(3, 3.0);
+  // 1 is used, so 2 will be evicted instead of it
+  if (!cache.findCachedFitness(1, &f) || f != 1.0) {
+    cout << "Failed to find a cached entry" << endl;
+    return false;
+  }
+  cache.cacheFitness(4, 4.0);
+
+  if (cache.fitnessCacheSize() != 3 || cache.findCachedFitness(2, &f) ||
+      !cache.findCachedFitness(1, &f) || !cache.findCachedFitness(4, &f) || f != 4.0) {
+    cout << "Wrong entry is evicted" << endl;
+    return false;
+  }
+  if (cache.fitnessCacheHits() != 3 || cache.fitnessCacheMisses() != 2) {
+    cout << "Wrong counters : hits = " << cache.fitnessCacheHits()
+         << ", misses = " << cache.fitnessCacheMisses() << endl;
+    return false;
+  }
+  return true;
+}
+
+// NaN never equals itself, so it's never cached and never merged with other genes
+bool testNaNAndDuplicates() {
+  const double nan = std::nan("");
+  doubleCache_t cache;
+  double f;
+  cache.setFitnessCacheCapacity(2);
+  cache.cacheFitness(nan, 0.0);
+  cache.cacheFitness(1.0, 1.0);
+  cache.cacheFitness(2.0, 2.0);
+  cache.cacheFitness(3.0, 3.0);
+  if (cache.fitnessCacheSize() != 2 || cache.findCachedFitness(nan, &f) ||
+      !cache.findCachedFitness(3.0, &f) || f != 3.0) {
+    cout << "NaN is cached" << endl;
+    return false;
+  }
+
+  cache.clearFitnessCache();
+  vector<gene_t> genes{{1, 0}, {2, 0}, {1, 0}, {nan, 0}, {nan, 0}, {2, 0}, {1, 0}};
+  vector<gene_t*> tasks;
+  for (gene_t& g : genes) {
+    if (!cache.findCachedFitness(g.decision_variable, &g.fitness)) {
+      tasks.emplace_back(&g);
+    }
+  }
+  vector<pair<gene_t*, const gene_t*>> duplicates;
+  cache.removeDuplicatedTasks(&tasks, &duplicates);
+  if (tasks.size() != 4 || duplicates.size() != 3 || cache.fitnessCacheHits() != 3 ||
+      cache.fitnessCacheMisses() != 4) {
+    cout << "Duplicated genes are not merged" << endl;
+    return false;
+  }
+  for (const auto& d : duplicates) {
+    if (d.first->decision_variable != d.second->decision_variable || d.second >= d.first) {
+      cout << "Duplicated genes are merged into wrong genes" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+static atomic<int> fitnessCalls(0);
+static set<vector<double>> evaluated;
+static mutex evaluatedLock;
+
+using Var_t = Eigen::Array<double, 4, 1>;
+using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+using solver_t =
+    heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+              heu::SelectMethod::RouletteWheel, args_t, heu::GADefaults<Var_t, args_t>::iFun<>,
+              nullptr, heu::GADefaults<Var_t, args_t>::cFunSwapNs,
+              heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+// Run SOGA on a coarse discrete box, where children are often identical to evaluated genes.
+double runSOGA(size_t cacheCapacity, solver_t* solver, double range = 5) {
+  heu::setRandomSeed(114514);
+
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 50;
+  opt.maxFailTimes = -1;
+  solver->setOption(opt);
+
+  args_t args;
+  args.setRange(-range, range);
+  args.setDelta(1);
+  solver->setArgs(args);
+
+  solver->setfFun([](const Var_t* x, const args_t*, double* f) {
+    fitnessCalls++;
+    {
+      lock_guard<mutex> lk(evaluatedLock);
+      evaluated.emplace(x->data(), x->data() + x->size());
+    }
+    heu::testFunctions<Var_t>::rastrigin(x, f);
+  });
+  solver->setFitnessCacheCapacity(cacheCapacity);
+
+  fitnessCalls = 0;
+  evaluated.clear();
+  solver->initializePop();
+  solver->run();
+  return solver->bestFitness();
+}
+
+int main() {
+  if (!testClockEviction() || !testNaNAndDuplicates()) {
+    return 1;
+  }
+
+  solver_t noCache;
+  const double f0 = runSOGA(0, &noCache);
+  const int calls0 = fitnessCalls;
+
+  solver_t withCache;
+  const double f1 = runSOGA(256, &withCache);
+  const int calls1 = fitnessCalls;
+
+  cout << "Without cache : fitness = " << f0 << ", " << calls0 << " evaluations" << endl;
+  cout << "With cache : fitness = " << f1 << ", " << calls1 << " evaluations, "
+       << withCache.fitnessCacheHits() << " hits, " << withCache.fitnessCacheMisses() << " misses"
+       << endl;
+
+  if (f0 != f1) {
+    cout << "Cache changes the result" << endl;
+    return 1;
+  }
+  if (calls1 != int(withCache.fitnessCacheMisses()) || withCache.fitnessCacheHits() <= 0 ||
+      calls1 + int(withCache.fitnessCacheHits()) != calls0) {
+    cout << "Cache counters don't match evaluations" << endl;
+    return 1;
+  }
+
+  // The cache is large enough to keep all genes, so no decision variable is evaluated twice
+  solver_t largeCache;
+  runSOGA(1 << 16, &largeCache, 1);
+  cout << "Large cache : " << fitnessCalls << " evaluations, " << largeCache.fitnessCacheHits()
+       << " hits, " << evaluated.size() << " distinct genes" << endl;
+  if (size_t(fitnessCalls) != evaluated.size()) {
+    cout << "Duplicated genes are evaluated" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#define HEU_GA_USE_GENEPOOL
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <iostream>
+#include <list>
+#include <ctime>
+using namespace Eigen;
+using namespace std;
+
+// GenePool should behave exactly like std::list for the interfaces that genetic solvers use
+bool testGenePoolAsList() {
+  heu::GenePool<int, 8> pool;
+  std::list<int> ref;
+
+  for (int i = 0; i < 50; i++) {
+    pool.emplace_back(i);
+    ref.emplace_back(i);
+  }
+
+  const int* stablePtr = &pool.front();
+
+  for (int i = 0; i < 200; i++) {
+    // the first element is never erased
+    const size_t idx = heu::randIdx<size_t>(1, ref.size());
+    pool.erase(std::next(pool.begin(), idx));
+    ref.erase(std::next(ref.begin(), idx));
+    const int val = heu::randIdx(1000);
+    pool.emplace_back(val);
+    ref.emplace_back(val);
+  }
+
+  if (pool.size() != ref.size() || !std::equal(pool.begin(), pool.end(), ref.begin())) {
+    cout << "GenePool differs from std::list" << endl;
+    return false;
+  }
+
+  // all nodes are reused from the free list, so no more slabs are allocated
+  if (pool.capacity() != 56) {
+    cout << "GenePool allocated " << pool.capacity() << " nodes for 50 elements" << endl;
+    return false;
+  }
+
+  if (&pool.front() != stablePtr || *stablePtr != 0) {
+    cout << "Element is moved" << endl;
+    return false;
+  }
+
+  pool.resize(5);
+  ref.resize(5);
+  if (pool.size() != ref.size() || !std::equal(pool.begin(), pool.end(), ref.begin())) {
+    cout << "GenePool differs from std::list after resize" << endl;
+    return false;
+  }
+
+  heu::GenePool<int, 8> copy = pool;
+  if (copy.size() != ref.size() || !std::equal(copy.begin(), copy.end(), ref.begin())) {
+    cout << "Copied GenePool differs" << endl;
+    return false;
+  }
+  return true;
+}
+
+template <heu::SelectMethod sm>
+double runSOGAWithGenePool() {
+  using args_t = heu::ContinousBox<array<double, 2>, heu::BoxShape::SQUARE_BOX>;
+  using solver_t = heu::SOGA<array<double, 2>, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+                             sm, args_t, heu::GADefaults<array<double, 2>, args_t>::iFun<>,
+                             heu::testFunctions<array<double, 2>, double, args_t>::ackley,
+                             heu::GADefaults<array<double, 2>, args_t>::cFunNd,
+                             heu::GADefaults<array<double, 2>, args_t>::mFun<>>;
+
+  static_assert(std::is_same_v<std::decay_t<decltype(solver_t().population())>,
+                               heu::GenePool<typename solver_t::Gene_t>>,
+                "HEU_GA_USE_GENEPOOL should make solvers store population in GenePool");
+
+  solver_t algo;
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxFailTimes = 50;
+  opt.maxGenerations = 100;
+  algo.setOption(opt);
+
+  if constexpr (sm == heu::SelectMethod::Tournament) algo.setTournamentSize(3);
+  if constexpr (sm == heu::SelectMethod::LinearRank) algo.setLinearSelectProbability(0.2, 0.8);
+  if constexpr (sm == heu::SelectMethod::ExponentialRank) algo.setExponetialSelectBase(0.8);
+  if constexpr (sm == heu::SelectMethod::Boltzmann) algo.setBoltzmannSelectStrength(-10);
+  if constexpr (sm == heu::SelectMethod::EliteReserved) algo.setEliteNum(3);
+
+  {
+    args_t args;
+    args.setRange(-5, 5);
+    args.setDelta(0.05);
+    algo.setArgs(args);
+  }
+
+  algo.initializePop();
+  algo.run();
+
+  cout << heu::Enum2String(sm) << " : fitness = " << algo.bestFitness() << " after "
+       << algo.generation() << " generations, population size = " << algo.population().size()
+       << endl;
+  return algo.bestFitness();
+}
+
+void runNSGA2WithGenePool() {
+  using Var_t = std::array<double, 3>;
+  heu::NSGA2<Var_t, 2, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS> algo;
+
+  algo.setiFun([](Var_t* x) {
+    for (auto& i : *x) {
+      i = heu::randD(-5, 5);
+    }
+  });
+  algo.setfFun(heu::testFunctions<Var_t, Eigen::Array<double, 2, 1>>::Kursawe);
+  algo.setcFun(heu::GADefaults<Var_t>::cFunNd<heu::DivEncode<1, 5>::code>);
+  algo.setmFun([](const Var_t* src, Var_t* x) {
+    *x = *src;
+    const size_t idx = heu::randIdx(3);
+    x->operator[](idx) = std::clamp(x->operator[](idx) + 0.1 * heu::randD(-1, 1), -5.0, 5.0);
+  });
+
+  heu::GAOption opt;
+  opt.maxGenerations = 100;
+  opt.populationSize = 100;
+  algo.setOption(opt);
+  algo.initializePop();
+  algo.run();
+
+  cout << "NSGA2 : " << algo.pfGenes().size() << " genes on PF, population size = "
+       << algo.population().size() << endl;
+}
+
+void runNSGA3WithGenePool() {
+  constexpr size_t N = 10;
+  constexpr size_t M = 3;
+  using Var_t = Eigen::Array<double, N, 1>;
+  heu::NSGA3<Var_t, M, heu::DONT_RECORD_FITNESS, heu::SINGLE_LAYER, void> solver;
+
+  solver.setiFun(heu::GADefaults<Var_t>::iFunNd<>);
+  solver.setfFun(heu::testFunctions<Var_t, Eigen::Array<double, M, 1>>::DTLZ7);
+  solver.setcFun(heu::GADefaults<Var_t>::cFunNd<heu::DivEncode<1, 10>::code>);
+  solver.setmFun([](const Var_t* src, Var_t* v) {
+    *v = *src;
+    double& p = v->operator[](heu::randIdx(v->size()));
+    p = std::clamp(p + 0.4 * heu::randD(-1, 1), 0.0, 1.0);
+  });
+
+  heu::GAOption opt;
+  opt.maxGenerations = 100;
+  opt.populationSize = 100;
+  solver.setOption(opt);
+  solver.setReferencePointPrecision(6);
+  solver.initializePop();
+  solver.run();
+
+  cout << "NSGA3 : " << solver.pfGenes().size() << " genes on PF, population size = "
+       << solver.population().size() << endl;
+}
+
+int main() {
+  if (!testGenePoolAsList()) {
+    return 1;
+  }
+
+  std::clock_t t = std::clock();
+  runSOGAWithGenePool<heu::SelectMethod::RouletteWheel>();
+  runSOGAWithGenePool<heu::SelectMethod::Tournament>();
+  runSOGAWithGenePool<heu::SelectMethod::Probability>();
+  runSOGAWithGenePool<heu::SelectMethod::Truncation>();
+  runSOGAWithGenePool<heu::SelectMethod::LinearRank>();
+  runSOGAWithGenePool<heu::SelectMethod::ExponentialRank>();
+  runSOGAWithGenePool<heu::SelectMethod::Boltzmann>();
+  runSOGAWithGenePool<heu::SelectMethod::EliteReserved>();
+  runNSGA2WithGenePool();
+  runNSGA3WithGenePool();
+  t = std::clock() - t;
+  cout << "Finished in " << double(t) / CLOCKS_PER_SEC << " seconds" << endl;
+  return 0;
+}
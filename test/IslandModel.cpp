@@ -0,0 +1,123 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/EAGlobal>
+#include <iostream>
+using namespace std;
+
+using Var_t = Eigen::Array<double, 5, 1>;
+using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+using soga_t =
+    heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+              heu::SelectMethod::RouletteWheel, args_t, heu::GADefaults<Var_t, args_t>::iFun<>,
+              heu::testFunctions<Var_t, double, args_t>::rastrigin,
+              heu::GADefaults<Var_t, args_t>::cFunSwapNs, heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+// Run islands of SOGA, returns the best fitness
+double runSOGAIslands(int thN, size_t* migrationTimes) {
+  heu::setRandomSeed(1919810);
+  heu::setThreadNum(thN);
+
+  soga_t prototype;
+  heu::GAOption opt;
+  opt.populationSize = 40;
+  opt.maxGenerations = 100;
+  opt.maxFailTimes = -1;
+  prototype.setOption(opt);
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  prototype.setArgs(args);
+
+  heu::IslandOption iOpt;
+  iOpt.islandNum = 4;
+  iOpt.migrationInterval = 10;
+  iOpt.migrantNum = 2;
+  heu::IslandModel<soga_t> islands(prototype, iOpt);
+  islands.initializePop();
+  islands.run();
+
+  *migrationTimes = islands.migrationTimes();
+  const soga_t& best = islands.island(islands.bestIsland());
+  cout << thN << " threads : best fitness = " << best.bestFitness() << " on island "
+       << islands.bestIsland() << ", " << best.generation() << " generations, "
+       << *migrationTimes << " migrations" << endl;
+  return best.bestFitness();
+}
+
+using nsga2_t = heu::NSGA2<Var_t, 3, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                           heu::GADefaults<Var_t, void>::iFunNd<>,
+                           heu::testFunctions<Var_t, Eigen::Array3d>::DTLZ1,
+                           heu::GADefaults<Var_t, void>::cFunNd<>>;
+
+bool testNSGA2Torus() {
+  nsga2_t prototype;
+  heu::GAOption opt;
+  opt.populationSize = 60;
+  opt.maxGenerations = 40;
+  prototype.setOption(opt);
+  prototype.setmFun([](const Var_t* src, Var_t* dst) {
+    *dst = *src;
+    const size_t idx = heu::randIdx(dst->size());
+    (*dst)[idx] = std::min(1.0, std::max(0.0, (*dst)[idx] + 0.05 * heu::randD(-1, 1)));
+  });
+
+  heu::IslandOption iOpt;
+  iOpt.islandNum = 6;
+  iOpt.topology = heu::MigrationTopology::TORUS;
+  iOpt.migrationInterval = 8;
+  heu::IslandModel<nsga2_t> islands(prototype, iOpt);
+
+  // 6 islands are arranged in 3 rows and 2 columns
+  if (islands.neighbors(0) != std::vector<size_t>{1, 2} ||
+      islands.neighbors(5) != std::vector<size_t>{1, 4}) {
+    cout << "Wrong torus neighbors" << endl;
+    return false;
+  }
+
+  islands.initializePop();
+  islands.run();
+  for (size_t i = 0; i < islands.islandNum(); i++) {
+    if (islands.island(i).pfGenes().empty() || islands.island(i).generation() != 40) {
+      cout << "Island " << i << " is not solved" << endl;
+      return false;
+    }
+  }
+  cout << "NSGA2 islands finished with " << islands.migrationTimes() << " migrations" << endl;
+  return islands.migrationTimes() == 4;
+}
+
+int main() {
+  size_t m1, m4;
+  const double f1 = runSOGAIslands(1, &m1);
+  const double f4 = runSOGAIslands(4, &m4);
+  if (f1 != f4) {
+    cout << "Result depends on the number of threads" << endl;
+    return 1;
+  }
+  if (m1 != 9 || m4 != 9) {
+    cout << "Wrong number of migrations" << endl;
+    return 1;
+  }
+  if (!testNSGA2Torus()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/EAGlobal>
+#include <HeuristicFlow/Genetic>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+// Hypervolume by inclusion-exclusion over all subsets of points. Only for small fronts.
+template <int M>
+double bruteForceHV(const Eigen::Array<double, M, Eigen::Dynamic>& front,
+                    const Eigen::Array<double, M, 1>& ref) {
+  const size_t N = front.cols();
+  double volume = 0;
+  for (size_t mask = 1; mask < (size_t(1) << N); mask++) {
+    Eigen::Array<double, M, 1> corner = Eigen::Array<double, M, 1>::Constant(M, 1, -1e300);
+    int bitNum = 0;
+    for (size_t i = 0; i < N; i++) {
+      if (mask & (size_t(1) << i)) {
+        corner = corner.max(front.col(i));
+        bitNum++;
+      }
+    }
+    const double v = (ref - corner).max(0.0).prod();
+    volume += (bitNum % 2 == 1) ? v : -v;
+  }
+  return volume;
+}
+
+// Random points on the simplex x_0+...+x_{M-1}=1, together with a few dominated points
+template <int M>
+Eigen::Array<double, M, Eigen::Dynamic> randomFront(int N) {
+  Eigen::Array<double, M, Eigen::Dynamic> front(M, N);
+  for (int c = 0; c < N; c++) {
+    for (int o = 0; o < M; o++) {
+      front(o, c) = heu::randD();
+    }
+    front.col(c) /= front.col(c).sum();
+    if (c % 4 == 3) {
+      front.col(c) += 0.3;
+    }
+  }
+  return front;
+}
+
+bool test2D() {
+  using metrics_t = heu::ParetoMetrics<2>;
+  metrics_t::Front_t front(2, 4);
+  front << 1, 2, 3, 3, 3, 2, 1, 3;
+  const Eigen::Array2d ref(4, 4);
+  // the last point is dominated
+  const double hv = metrics_t::hypervolume(front, ref);
+  if (std::abs(hv - 6) > 1e-12) {
+    cout << "Hypervolume of the 2d front is " << hv << ", expected 6" << endl;
+    return false;
+  }
+
+  // the same front when greater is better
+  const double hvMax = heu::ParetoMetrics<2, heu::FITNESS_GREATER_BETTER>::hypervolume(-front, -ref);
+  if (hvMax != hv) {
+    cout << "Hypervolume differs when greater is better" << endl;
+    return false;
+  }
+
+  // points out of the reference point contribute nothing
+  metrics_t::Front_t outside(2, 1);
+  outside << 5, 0;
+  return metrics_t::hypervolume(outside, ref) == 0;
+}
+
+template <int M>
+bool testExactHV() {
+  using metrics_t = heu::ParetoMetrics<M>;
+  const Eigen::Array<double, M, 1> ref = Eigen::Array<double, M, 1>::Constant(M, 1, 1.1);
+  for (int trial = 0; trial < 20; trial++) {
+    const auto front = randomFront<M>(12);
+    const double expected = bruteForceHV<M>(front, ref);
+    const double hv = metrics_t::exactHypervolume(front, ref);
+    if (std::abs(hv - expected) > 1e-9 * expected) {
+      cout << "Exact hypervolume for " << M << " objectives is " << hv << ", expected " << expected
+           << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testEstimatedHV() {
+  // 4 objectives: compare the estimation with the exact value
+  using metrics4_t = heu::ParetoMetrics<4>;
+  const auto front4 = randomFront<4>(40);
+  const Eigen::Array4d ref4 = Eigen::Array4d::Constant(1.1);
+  const double exact4 = metrics4_t::exactHypervolume(front4, ref4);
+  const double estimated4 = metrics4_t::estimateHypervolume(front4, ref4, 200000);
+  cout << "4 objectives : exact HV = " << exact4 << ", estimated HV = " << estimated4 << endl;
+  if (std::abs(estimated4 - exact4) > 0.02 * exact4) {
+    return false;
+  }
+
+  // 8 objectives are estimated by default
+  using metrics8_t = heu::ParetoMetrics<Eigen::Dynamic>;
+  const metrics8_t::Front_t front8 = randomFront<8>(10);
+  const metrics8_t::Fitness_t ref8 = metrics8_t::Fitness_t::Constant(8, 1.1);
+  const double expected8 = bruteForceHV<8>(front8, ref8);
+  const double estimated8 = metrics8_t::hypervolume(front8, ref8, 400000);
+  cout << "8 objectives : exact HV = " << expected8 << ", estimated HV = " << estimated8 << endl;
+  return std::abs(estimated8 - expected8) <= 0.02 * expected8;
+}
+
+bool testIGD() {
+  using metrics_t = heu::ParetoMetrics<2>;
+  // 101 points on the line x+y=1
+  metrics_t::Front_t refFront(2, 101);
+  for (int i = 0; i <= 100; i++) {
+    refFront(0, i) = i / 100.0;
+    refFront(1, i) = 1 - i / 100.0;
+  }
+
+  if (metrics_t::IGD(refFront, refFront) != 0 || metrics_t::IGDPlus(refFront, refFront) != 0) {
+    cout << "IGD of the reference front itself isn't 0" << endl;
+    return false;
+  }
+
+  // moving the front towards worse values by 0.1 on both objectives
+  const metrics_t::Front_t worse = refFront + 0.1;
+  const double igd = metrics_t::IGD(worse, refFront), igdPlus = metrics_t::IGDPlus(worse, refFront);
+  if (std::abs(igdPlus - 0.1 * std::sqrt(2.0)) > 1e-12 || igd > igdPlus + 1e-12) {
+    cout << "IGD = " << igd << ", IGD+ = " << igdPlus << endl;
+    return false;
+  }
+
+  // a front better than the reference has IGD+ 0 but IGD > 0
+  const metrics_t::Front_t better = refFront - 0.1;
+  if (metrics_t::IGDPlus(better, refFront) != 0 || metrics_t::IGD(better, refFront) <= 0) {
+    cout << "IGD+ isn't Pareto compliant" << endl;
+    return false;
+  }
+
+  // evenly distributed points on the whole reference front have a better spread than a cluster
+  metrics_t::Front_t even(2, 11), cluster(2, 11);
+  for (int i = 0; i <= 10; i++) {
+    even.col(i) = refFront.col(10 * i);
+    cluster.col(i) = refFront.col(45 + i);
+  }
+  const double evenSpread = metrics_t::spread(even, refFront);
+  const double clusterSpread = metrics_t::spread(cluster, refFront);
+  cout << "Spread : even = " << evenSpread << ", cluster = " << clusterSpread << endl;
+  return evenSpread < 1e-9 && clusterSpread > 0.5;
+}
+
+// The hypervolume of an NSGA2 solver grows when it's monitored by an observer
+bool testMonitoring() {
+  using Var_t = Eigen::Array<double, 8, 1>;
+  using nsga2_t = heu::NSGA2<Var_t, 2, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                             heu::GADefaults<Var_t, void>::iFunNd<>,
+                             heu::testFunctions<Var_t, Eigen::Array2d>::DTLZ2,
+                             heu::GADefaults<Var_t, void>::cFunNd<>>;
+  nsga2_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 50;
+  solver.setOption(opt);
+  solver.setmFun([](const Var_t* src, Var_t* dst) {
+    *dst = *src;
+    const size_t idx = heu::randIdx(dst->size());
+    (*dst)[idx] = std::min(1.0, std::max(0.0, (*dst)[idx] + 0.1 * heu::randD(-1, 1)));
+  });
+  solver.initializePop();
+
+  const Eigen::Array2d ref(3, 3);
+  std::vector<double> hvs;
+  solver.run([&hvs, &ref](const nsga2_t& s) {
+    heu::ParetoMetrics<2>::Front_t front;
+    s.paretoFront(front);
+    hvs.emplace_back(heu::ParetoMetrics<2>::hypervolume(front, ref));
+  });
+  cout << "NSGA2 hypervolume : " << hvs.front() << " -> " << hvs.back() << endl;
+  return hvs.size() == opt.maxGenerations + 1 && hvs.back() > hvs.front();
+}
+
+int main() {
+  heu::setRandomSeed(20221017);
+  if (!test2D() || !testExactHV<3>() || !testExactHV<4>() || !testExactHV<6>() ||
+      !testEstimatedHV() || !testIGD() || !testMonitoring()) {
+    return 1;
+  }
+  cout << "All metrics are correct" << endl;
+  return 0;
+}
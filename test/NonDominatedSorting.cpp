@@ -0,0 +1,111 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/EAGlobal>
+#include <iostream>
+#include <vector>
+#include <ctime>
+using namespace std;
+
+// Compute pareto ranks by definition : peel the non-dominated points layer by layer.
+template <int M>
+vector<size_t> bruteForceRanks(const vector<Eigen::Array<double, M, 1>>& points) {
+  const size_t N = points.size();
+  vector<size_t> ranks(N, 0);
+  vector<bool> isAssigned(N, false);
+  size_t assignedNum = 0;
+  for (size_t layer = 0; assignedNum < N; layer++) {
+    vector<size_t> curLayer;
+    for (size_t i = 0; i < N; i++) {
+      if (isAssigned[i]) continue;
+      bool isDominated = false;
+      for (size_t j = 0; j < N; j++) {
+        if (isAssigned[j] || i == j) continue;
+        if (heu::internal::Pareto<M, heu::FITNESS_LESS_BETTER>::isStrongDominate(&points[j],
+                                                                                  &points[i])) {
+          isDominated = true;
+          break;
+        }
+      }
+      if (!isDominated) curLayer.emplace_back(i);
+    }
+    for (size_t i : curLayer) {
+      ranks[i] = layer;
+      isAssigned[i] = true;
+    }
+    assignedNum += curLayer.size();
+  }
+  return ranks;
+}
+
+template <int M, heu::FitnessOption fOpt, heu::NDSortMethod method>
+bool testNDSort(const size_t N, const int valueNum) {
+  // values are picked from a few levels so that there are many duplicated values and points
+  vector<Eigen::Array<double, M, 1>> points(N);
+  for (auto& p : points) {
+    for (int o = 0; o < M; o++) {
+      p[o] = heu::randIdx(valueNum);
+    }
+  }
+
+  vector<Eigen::Array<double, M, 1>> minimized = points;
+  if constexpr (fOpt == heu::FITNESS_GREATER_BETTER) {
+    for (auto& p : points) {
+      p = -p;
+    }
+  }
+
+  vector<const Eigen::Array<double, M, 1>*> ptrs(N);
+  for (size_t i = 0; i < N; i++) {
+    ptrs[i] = &points[i];
+  }
+
+  heu::internal::NDSorter<M, fOpt, method> sorter;
+  vector<size_t> ranks(N);
+  std::clock_t c = std::clock();
+  const size_t layerNum = sorter.sort(ptrs.data(), N, ranks.data());
+  c = std::clock() - c;
+
+  const vector<size_t> expected = bruteForceRanks<M>(minimized);
+  const size_t expectedLayerNum = *max_element(expected.begin(), expected.end()) + 1;
+
+  if (ranks != expected || layerNum != expectedLayerNum) {
+    cout << "Wrong ranks for M=" << M << ", N=" << N << ", method=" << method << endl;
+    return false;
+  }
+  cout << "M=" << M << ", N=" << N << ", method=" << method << " : " << layerNum
+       << " layers, solved in " << double(c) / CLOCKS_PER_SEC << " s" << endl;
+  return true;
+}
+
+int main() {
+  bool ok = true;
+  for (int valueNum : {4, 100, 100000}) {
+    ok &= testNDSort<2, heu::FITNESS_LESS_BETTER, heu::FAST_NONDOMINATED_SORT>(500, valueNum);
+    ok &= testNDSort<2, heu::FITNESS_LESS_BETTER, heu::SWEEP_2D>(500, valueNum);
+    ok &= testNDSort<2, heu::FITNESS_GREATER_BETTER, heu::SWEEP_2D>(500, valueNum);
+    ok &= testNDSort<2, heu::FITNESS_LESS_BETTER, heu::DIVIDE_AND_CONQUER>(500, valueNum);
+    ok &= testNDSort<3, heu::FITNESS_LESS_BETTER, heu::FAST_NONDOMINATED_SORT>(500, valueNum);
+    ok &= testNDSort<3, heu::FITNESS_LESS_BETTER, heu::DIVIDE_AND_CONQUER>(500, valueNum);
+    ok &= testNDSort<3, heu::FITNESS_GREATER_BETTER, heu::DIVIDE_AND_CONQUER>(500, valueNum);
+    ok &= testNDSort<5, heu::FITNESS_LESS_BETTER, heu::DIVIDE_AND_CONQUER>(500, valueNum);
+    ok &= testNDSort<8, heu::FITNESS_LESS_BETTER, heu::DIVIDE_AND_CONQUER>(300, valueNum);
+  }
+  return ok ? 0 : 1;
+}
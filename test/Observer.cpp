@@ -0,0 +1,157 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/AOS>
+#include <HeuristicFlow/EAGlobal>
+#include <iostream>
+using namespace std;
+
+using Var_t = Eigen::Array<double, 6, 1>;
+using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+using soga_t =
+    heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::RECORD_FITNESS, heu::SelectMethod::Tournament,
+              args_t, heu::GADefaults<Var_t, args_t>::iFun<>, nullptr,
+              heu::GADefaults<Var_t, args_t>::cFunSwapNs, heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+void setupSOGA(soga_t* solver) {
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 100;
+  opt.maxFailTimes = -1;
+  solver->setOption(opt);
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  solver->setArgs(args);
+  solver->setfFun([](const Var_t* x, const args_t*, double* f) {
+    heu::testFunctions<Var_t>::rastrigin(x, f);
+  });
+  solver->initializePop();
+}
+
+bool testSOGA() {
+  soga_t solver;
+  setupSOGA(&solver);
+
+  // An observer returning void never stops the run
+  size_t calls = 0;
+  bool isConsistent = true;
+  solver.run([&calls, &isConsistent](const soga_t& s) {
+    isConsistent = isConsistent && (s.generation() == calls) &&
+                   (s.population().size() == s.option().populationSize) &&
+                   (s.record().back() == s.bestFitness());
+    calls++;
+  });
+  cout << "SOGA observed " << calls << " times" << endl;
+  if (calls != solver.generation() + 1 || !isConsistent) {
+    cout << "Observer isn't called once per generation" << endl;
+    return false;
+  }
+
+  // Stop the run at generation 10
+  solver.initializePop();
+  solver.run([](const soga_t& s) { return s.generation() < 10; });
+  if (solver.generation() != 10 || solver.record().size() != 11) {
+    cout << "Observer doesn't stop SOGA" << endl;
+    return false;
+  }
+
+  // Stop a stalled run from steady-state mode
+  solver.initializePop();
+  solver.runAsync([](const soga_t& s) { return s.failTimes() < 3; });
+  cout << "SOGA steady-state stopped after " << solver.generation() << " generations with "
+       << solver.failTimes() << " fail times" << endl;
+  if (solver.generation() >= solver.option().maxGenerations || solver.failTimes() != 3) {
+    cout << "Observer doesn't stop SOGA in steady-state mode" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool testPSO() {
+  using pso_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                         heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  pso_t solver;
+  heu::PSOOption opt;
+  opt.populationSize = 100;
+  opt.maxGeneration = 50;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.initializePop();
+
+  size_t calls = 0;
+  solver.run([&calls](const pso_t& s) {
+    calls++;
+    return s.generation() < 20;
+  });
+  cout << "PSO observed " << calls << " times" << endl;
+  return calls == 21 && solver.generation() == 20 && solver.record().size() == 21;
+}
+
+bool testPSOSoA() {
+  using soa_t = heu::PSOSoA<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  soa_t solver;
+  heu::PSOOption opt;
+  opt.populationSize = 100;
+  opt.maxGeneration = 50;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.initializePop();
+
+  size_t calls = 0;
+  solver.run([&calls](const soa_t&) { calls++; });
+  cout << "PSOSoA observed " << calls << " times" << endl;
+  return calls == opt.maxGeneration + 1 && solver.generation() == opt.maxGeneration &&
+         solver.record().size() == opt.maxGeneration + 1;
+}
+
+bool testAOS() {
+  using aos_t = heu::AOS<heu::FixedContinousBox17<Eigen::Array<double, 3, 1>, heu::encode(-5.0),
+                                                  heu::encode(5.0), heu::encode(1.5)>,
+                         heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                         heu::testFunctions<Eigen::Array<double, 3, 1>>::rastrigin>;
+  aos_t solver;
+  heu::AOSOption opt;
+  opt.maxGeneration = 30;
+  opt.maxEarlyStop = 100;
+  solver.setOption(opt);
+  solver.initializePop();
+
+  size_t calls = 0;
+  solver.run([&calls](const aos_t& s) {
+    calls++;
+    return s.generation() < 5;
+  });
+  cout << "AOS observed " << calls << " times" << endl;
+  return calls == 6 && solver.generation() == 5;
+}
+
+int main() {
+  if (!testSOGA() || !testPSO() || !testPSOSoA() || !testAOS()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/EAGlobal>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+using namespace std;
+
+static constexpr int Dim = 4;
+using Var_t = Eigen::Array<double, Dim, 1>;
+
+// Vectorized rastrigin function, each column is a particle
+template <class Swarm_t, class Fitness_t>
+void rastriginBatch(const Swarm_t* x, Fitness_t* f) {
+  *f = 10.0 * x->rows() + (x->square() - 10 * (*x * (2 * M_PI)).cos()).colwise().sum();
+}
+
+// Check that all particles are inside the box and all fitness values are consistent
+template <class solver_t>
+bool checkSwarm(const solver_t& solver) {
+  for (int c = 0; c < solver.swarmSize(); c++) {
+    if ((solver.positions().col(c) < -5.12).any() || (solver.positions().col(c) > 5.12).any()) {
+      cout << "Particle " << c << " is out of box" << endl;
+      return false;
+    }
+    if ((solver.velocities().col(c).abs() > 0.1 + 1e-12).any()) {
+      cout << "Velocity of particle " << c << " is too large" << endl;
+      return false;
+    }
+    Var_t x = solver.pBestPositions().col(c);
+    double f;
+    heu::testFunctions<Var_t>::rastrigin(&x, &f);
+    if (std::abs(f - solver.pBestFitness()(c)) > 1e-9) {
+      cout << "pBest fitness of particle " << c << " is wrong" << endl;
+      return false;
+    }
+    if (solver.pBestFitness()(c) < solver.bestFitness()) {
+      cout << "gBest is not the best" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testPSOSoA(bool useBatch) {
+  using solver_t = heu::PSOSoA<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                               heu::RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  solver_t solver;
+
+  heu::PSOOption opt;
+  opt.populationSize = 2000;
+  opt.maxGeneration = 100;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  if (useBatch) {
+    solver.setBatchfFun(rastriginBatch<solver_t::Swarm_t, solver_t::SwarmFitness_t>);
+  }
+  solver.initializePop();
+
+  std::clock_t c = std::clock();
+  solver.run();
+  c = std::clock() - c;
+
+  cout << "PSOSoA" << (useBatch ? " with batch fitness" : "") << " : fitness = "
+       << solver.bestFitness() << ", " << double(c) / CLOCKS_PER_SEC << " s" << endl;
+
+  if (solver.record().size() != solver.generation() + 1) {
+    cout << "Wrong record size" << endl;
+    return false;
+  }
+  for (size_t i = 1; i < solver.record().size(); i++) {
+    if (solver.record()[i] > solver.record()[i - 1]) {
+      cout << "gBest becomes worse" << endl;
+      return false;
+    }
+  }
+  return checkSwarm(solver);
+}
+
+// The AoS solver with the same settings, for comparison
+void runPSO() {
+  using solver_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::DONT_RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  solver_t solver;
+
+  heu::PSOOption opt;
+  opt.populationSize = 2000;
+  opt.maxGeneration = 100;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.initializePop();
+
+  std::clock_t c = std::clock();
+  solver.run();
+  c = std::clock() - c;
+
+  cout << "PSO : fitness = " << solver.bestFitness() << ", " << double(c) / CLOCKS_PER_SEC << " s"
+       << endl;
+}
+
+int main() {
+  if (!testPSOSoA(false) || !testPSOSoA(true)) {
+    return 1;
+  }
+  runPSO();
+  return 0;
+}
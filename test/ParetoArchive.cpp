@@ -0,0 +1,205 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/EAGlobal>
+#include <HeuristicFlow/Genetic>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+using Fitness3_t = Eigen::Array3d;
+
+// Points around the simplex x_0+x_1+x_2=1, many of them dominated
+Fitness3_t randomPoint() {
+  Fitness3_t p;
+  for (int o = 0; o < 3; o++) {
+    p[o] = heu::randD();
+  }
+  return p / p.sum() + heu::randD(0, 0.2);
+}
+
+// Non-dominated points among `points`, removing duplicates
+vector<Fitness3_t> bruteForcePF(const vector<Fitness3_t>& points) {
+  vector<Fitness3_t> pf;
+  for (size_t i = 0; i < points.size(); i++) {
+    bool isDominated = false;
+    for (size_t j = 0; j < points.size() && !isDominated; j++) {
+      const bool weak = (points[j] <= points[i]).all();
+      isDominated = weak && ((points[j] < points[i]).any() || j < i);
+    }
+    if (!isDominated) {
+      pf.emplace_back(points[i]);
+    }
+  }
+  return pf;
+}
+
+bool lexLess(const Fitness3_t& a, const Fitness3_t& b) {
+  return std::lexicographical_compare(a.data(), a.data() + 3, b.data(), b.data() + 3);
+}
+
+// An unbounded archive keeps exactly the non-dominated points of all insertions
+template <heu::FitnessOption fOpt>
+bool testUnbounded() {
+  const double sign = (fOpt == heu::FITNESS_LESS_BETTER) ? 1 : -1;
+  heu::ParetoArchive<int, 3, fOpt> archive(0, 4);
+  vector<Fitness3_t> points;
+  for (int i = 0; i < 3000; i++) {
+    points.emplace_back(randomPoint());
+    archive.insert(int(points.size()) - 1, sign * points.back());
+    // duplicates are rejected
+    if (i % 100 == 99) {
+      points.emplace_back(points[points.size() / 2]);
+      archive.insert(int(points.size()) - 1, sign * points.back());
+    }
+  }
+
+  vector<Fitness3_t> expected = bruteForcePF(points), actual;
+  for (const auto& e : archive.entries()) {
+    actual.emplace_back(sign * e.fitness);
+    if ((sign * points[e.decision_variable] != e.fitness).any()) {
+      cout << "Decision variable and fitness are mismatched" << endl;
+      return false;
+    }
+  }
+  std::sort(expected.begin(), expected.end(), lexLess);
+  std::sort(actual.begin(), actual.end(), lexLess);
+  if (expected.size() != actual.size() || !std::equal(expected.begin(), expected.end(),
+                                                      actual.begin(), [](auto& a, auto& b) {
+                                                        return (a == b).all();
+                                                      })) {
+    cout << "The archive has " << actual.size() << " points, but the PF has " << expected.size()
+         << endl;
+    return false;
+  }
+
+  for (const Fitness3_t& p : points) {
+    if (!archive.isDominated(sign * p)) {
+      cout << "An inserted point isn't dominated by the archive" << endl;
+      return false;
+    }
+  }
+  cout << "Unbounded archive keeps " << archive.size() << " of " << points.size() << " points"
+       << endl;
+  return !archive.isDominated(Fitness3_t::Constant(-sign));
+}
+
+// A bounded archive doesn't exceed its capacity and keeps extreme points
+bool testBounded() {
+  heu::ParetoArchive<int, 2> archive(50);
+  for (int i = 0; i < 2000; i++) {
+    const double x = heu::randD();
+    archive.insert(i, Eigen::Array2d(x, 1 - x));
+  }
+  archive.insert(-1, Eigen::Array2d(0, 1));
+  archive.insert(-2, Eigen::Array2d(1, 0));
+  for (int i = 0; i < 100; i++) {
+    const double x = heu::randD();
+    archive.insert(i, Eigen::Array2d(x, 1 - x));
+  }
+  if (archive.size() != 50) {
+    cout << "Size of the bounded archive is " << archive.size() << endl;
+    return false;
+  }
+
+  heu::ParetoArchive<int, 2>::Front_t front;
+  archive.paretoFront(front);
+  if (front.row(0).minCoeff() != 0 || front.row(0).maxCoeff() != 1) {
+    cout << "Extreme points are lost" << endl;
+    return false;
+  }
+
+  // crowding distance pruning spreads points evenly
+  std::vector<double> xs;
+  for (Eigen::Index c = 0; c < front.cols(); c++) {
+    xs.emplace_back(front(0, c));
+  }
+  std::sort(xs.begin(), xs.end());
+  double maxGap = 0;
+  for (size_t i = 1; i < xs.size(); i++) {
+    maxGap = std::max(maxGap, xs[i] - xs[i - 1]);
+  }
+  cout << "Max gap in the bounded archive : " << maxGap << endl;
+  if (maxGap > 0.04) {
+    return false;
+  }
+
+  archive.setCapacity(10);
+  return archive.size() == 10;
+}
+
+// The archive of NSGA2 dominates its final PF
+bool testNSGA2() {
+  using Var_t = Eigen::Array<double, 8, 1>;
+  using nsga2_t = heu::NSGA2<Var_t, 2, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                             heu::GADefaults<Var_t, void>::iFunNd<>,
+                             heu::testFunctions<Var_t, Eigen::Array2d>::DTLZ2,
+                             heu::GADefaults<Var_t, void>::cFunNd<>>;
+  nsga2_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 100;
+  solver.setOption(opt);
+  solver.setmFun([](const Var_t* src, Var_t* dst) {
+    *dst = *src;
+    const size_t idx = heu::randIdx(dst->size());
+    (*dst)[idx] = std::min(1.0, std::max(0.0, (*dst)[idx] + 0.1 * heu::randD(-1, 1)));
+  });
+  solver.setArchiveEnabled(true);
+  solver.archive().setCapacity(200);
+  solver.initializePop();
+  solver.run();
+
+  const auto& archive = solver.archive();
+  for (const auto* gene : solver.pfGenes()) {
+    if (!archive.isDominated(gene->fitness)) {
+      cout << "A gene of the PF isn't dominated by the archive" << endl;
+      return false;
+    }
+  }
+  for (const auto& e : archive.entries()) {
+    Eigen::Array2d f;
+    heu::testFunctions<Var_t, Eigen::Array2d>::DTLZ2(&e.decision_variable, &f);
+    if ((f != e.fitness).any()) {
+      cout << "Decision variable and fitness are mismatched" << endl;
+      return false;
+    }
+  }
+
+  const Eigen::Array2d ref(3, 3);
+  heu::ParetoMetrics<2>::Front_t pf, archived;
+  solver.paretoFront(pf);
+  archive.paretoFront(archived);
+  const double pfHV = heu::ParetoMetrics<2>::hypervolume(pf, ref);
+  const double archiveHV = heu::ParetoMetrics<2>::hypervolume(archived, ref);
+  cout << "NSGA2 : " << pf.cols() << " points in PF, HV = " << pfHV << " ; " << archived.cols()
+       << " points in archive, HV = " << archiveHV << endl;
+  return archive.size() > size_t(pf.cols()) && archive.size() <= 200 && archiveHV >= pfHV;
+}
+
+int main() {
+  heu::setRandomSeed(20221017);
+  if (!testUnbounded<heu::FITNESS_LESS_BETTER>() || !testUnbounded<heu::FITNESS_GREATER_BETTER>() ||
+      !testBounded() || !testNSGA2()) {
+    return 1;
+  }
+  cout << "Pareto archive is correct" << endl;
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#define HEU_DO_PROFILING
+
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/AOS>
+#include <HeuristicFlow/EAGlobal>
+#include <iostream>
+using namespace std;
+
+using Var_t = Eigen::Array<double, 6, 1>;
+
+void printProfile(const char* name, const heu::SolverProfile& profile) {
+  cout << name << " : " << profile.fitnessCalls() << " fitness calls\n";
+  for (int p = 0; p < heu::PHASE_NUM; p++) {
+    const heu::SolverPhase phase = heu::SolverPhase(p);
+    if (profile.count(phase) > 0) {
+      cout << "  " << heu::Enum2String(phase) << " : " << profile.count(phase) << " times, "
+           << profile.seconds(phase) << " s\n";
+    }
+  }
+  cout << endl;
+}
+
+bool testSOGA() {
+  using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+  using soga_t = heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+                           heu::SelectMethod::Tournament, args_t,
+                           heu::GADefaults<Var_t, args_t>::iFun<>, nullptr,
+                           heu::GADefaults<Var_t, args_t>::cFunSwapNs,
+                           heu::GADefaults<Var_t, args_t>::mFun<>>;
+  soga_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 100;
+  opt.maxGenerations = 50;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  solver.setArgs(args);
+  solver.setfFun([](const Var_t* x, const args_t*, double* f) {
+    heu::testFunctions<Var_t>::rastrigin(x, f);
+  });
+  solver.initializePop();
+  solver.run();
+
+  const heu::SolverProfile& profile = solver.profile();
+  printProfile("SOGA", profile);
+  return profile.fitnessCalls() == solver.evaluationCount() &&
+         profile.count(heu::PHASE_FITNESS) == solver.generation() + 1 &&
+         profile.count(heu::PHASE_SELECT) == solver.generation() + 1 &&
+         profile.count(heu::PHASE_CROSSOVER) == solver.generation() &&
+         profile.count(heu::PHASE_MUTATE) == solver.generation() &&
+         profile.nanoseconds(heu::PHASE_FITNESS) > 0 && profile.count(heu::PHASE_MAKE_LAYERS) == 0;
+}
+
+bool testNSGA2() {
+  using nsga2_t = heu::NSGA2<Var_t, 3, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                             heu::GADefaults<Var_t, void>::iFunNd<>,
+                             heu::testFunctions<Var_t, Eigen::Array3d>::DTLZ2,
+                             heu::GADefaults<Var_t, void>::cFunNd<>>;
+  nsga2_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 20;
+  solver.setOption(opt);
+  solver.setmFun([](const Var_t* src, Var_t* dst) {
+    *dst = *src;
+    const size_t idx = heu::randIdx(dst->size());
+    (*dst)[idx] = std::min(1.0, std::max(0.0, (*dst)[idx] + 0.05 * heu::randD(-1, 1)));
+  });
+  solver.initializePop();
+  solver.run();
+
+  const heu::SolverProfile& profile = solver.profile();
+  printProfile("NSGA2", profile);
+  return profile.count(heu::PHASE_SELECT) == solver.generation() + 1 &&
+         profile.nanoseconds(heu::PHASE_SELECT) > 0;
+}
+
+bool testPSO() {
+  using pso_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                         heu::DONT_RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  pso_t solver;
+  heu::PSOOption opt;
+  opt.populationSize = 100;
+  opt.maxGeneration = 50;
+  opt.maxFailTimes = -1;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.initializePop();
+  solver.run();
+
+  const heu::SolverProfile& profile = solver.profile();
+  printProfile("PSO", profile);
+  // The last generation is evaluated but particles are not moved
+  return profile.fitnessCalls() == opt.populationSize * (solver.generation() + 1) &&
+         profile.count(heu::PHASE_UPDATE_PGBEST) == solver.generation() + 1 &&
+         profile.count(heu::PHASE_UPDATE_POPULATION) == solver.generation();
+}
+
+bool testAOS() {
+  using aos_t = heu::AOS<heu::FixedContinousBox17<Eigen::Array<double, 3, 1>, heu::encode(-5.0),
+                                                  heu::encode(5.0), heu::encode(1.5)>,
+                         heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                         heu::testFunctions<Eigen::Array<double, 3, 1>>::rastrigin>;
+  aos_t solver;
+  heu::AOSOption opt;
+  opt.maxGeneration = 30;
+  opt.maxEarlyStop = 100;
+  solver.setOption(opt);
+  solver.initializePop();
+  solver.run();
+
+  const heu::SolverProfile& profile = solver.profile();
+  printProfile("AOS", profile);
+  return profile.fitnessCalls() == solver.evaluationCount() &&
+         profile.count(heu::PHASE_MAKE_LAYERS) == solver.generation() + 1 &&
+         profile.count(heu::PHASE_UPDATE_POPULATION) == solver.generation();
+}
+
+int main() {
+  static_assert(heu::SolverProfile::isEnabled, "Profiling should be enabled");
+  if (!testSOGA() || !testNSGA2() || !testPSO() || !testAOS()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/EAGlobal>
+#include <iostream>
+#include <vector>
+#include <ctime>
+using namespace std;
+
+// The same master seed must produce the same sequence
+bool testSameSeedSameSequence() {
+  heu::setRandomSeed(20220101);
+  vector<double> a(100);
+  for (auto& i : a) i = heu::randD();
+
+  heu::setRandomSeed(20220101);
+  vector<double> b(100);
+  for (auto& i : b) i = heu::randD();
+
+  if (a != b) {
+    cout << "Same seed gives different sequences" << endl;
+    return false;
+  }
+
+  heu::internal::RandEngine e(1), f(1);
+  f.jump();
+  for (int i = 0; i < 100; i++) {
+    if (e() == f()) {
+      cout << "Jumped stream overlaps" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// PSO draws random numbers in parallel regions. With the same seed, it should give the same result
+// regardless of the number of threads.
+double runPSO(int thN) {
+  static constexpr size_t N = 10;
+  using Var_t = Eigen::Array<double, N, 1>;
+  using solver_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::DONT_RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+
+  heu::setThreadNum(thN);
+#ifdef _OPENMP
+  omp_set_num_threads(thN);
+#endif
+  heu::setRandomSeed(3407);
+
+  heu::PSOOption opt;
+  opt.populationSize = 200;
+  opt.maxGeneration = 200;
+  opt.maxFailTimes = -1;
+
+  solver_t solver;
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.setOption(opt);
+  solver.initializePop();
+
+  std::clock_t c = std::clock();
+  solver.run();
+  c = std::clock() - c;
+
+  cout << "PSO with " << thN << " threads : fitness = " << solver.bestFitness() << ", "
+       << double(c) / CLOCKS_PER_SEC << " s" << endl;
+  return solver.bestFitness();
+}
+
+// Crossover and mutation also run in parallel regions, so SOGA should be reproducible as well.
+double runSOGA(int thN) {
+  using Var_t = Eigen::Array<double, 10, 1>;
+  using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+  using solver_t =
+      heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS,
+                heu::SelectMethod::RouletteWheel, args_t, heu::GADefaults<Var_t, args_t>::iFun<>,
+                heu::testFunctions<Var_t, double, args_t>::rastrigin,
+                heu::GADefaults<Var_t, args_t>::cFunSwapNs, heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+  heu::setThreadNum(thN);
+  heu::setRandomSeed(20220101);
+
+  heu::GAOption opt;
+  opt.populationSize = 100;
+  opt.maxGenerations = 100;
+  opt.maxFailTimes = -1;
+  args_t args;
+  args.setRange(-5.12, 5.12);
+  args.setDelta(0.01);
+
+  solver_t solver;
+  solver.setOption(opt);
+  solver.setArgs(args);
+  solver.initializePop();
+  solver.run();
+
+  cout << "SOGA with " << thN << " threads : fitness = " << solver.bestFitness() << endl;
+  return solver.bestFitness();
+}
+
+int main() {
+  if (!testSameSeedSameSequence()) {
+    return 1;
+  }
+
+  const double f1 = runPSO(1);
+  const double f4 = runPSO(4);
+  if (f1 != f4 || runSOGA(1) != runSOGA(4)) {
+    cout << "Results differ with different number of threads" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <iostream>
+#include <set>
+#include <vector>
+using namespace std;
+
+template <int ObjNum>
+bool checkLayers(size_t dimN, size_t precision, size_t innerPrecision) {
+  using cache_t = heu::internal::ReferencePointCache<ObjNum>;
+  const auto rps = cache_t::get(dimN, precision, innerPrecision);
+  if (rps != cache_t::get(dimN, precision, innerPrecision)) {
+    cout << "RPs are not cached" << endl;
+    return false;
+  }
+
+  const size_t innerNum = (innerPrecision > 0) ? cache_t::pointNum(dimN, innerPrecision) : 0;
+  if (size_t(rps->rows()) != dimN ||
+      size_t(rps->cols()) != innerNum + cache_t::pointNum(dimN, precision)) {
+    cout << "Wrong size of RP matrix : " << rps->rows() << "x" << rps->cols() << endl;
+    return false;
+  }
+
+  set<vector<double>> unique;
+  for (int c = 0; c < rps->cols(); c++) {
+    const double expectedSum = (size_t(c) < innerNum) ? (1.0 / std::sqrt(2.0)) : 1.0;
+    if ((rps->col(c) < -1e-12).any() || std::abs(rps->col(c).sum() - expectedSum) > 1e-10) {
+      cout << "RP " << c << " is not on its layer" << endl;
+      return false;
+    }
+    unique.emplace(rps->col(c).data(), rps->col(c).data() + dimN);
+  }
+  if (unique.size() != size_t(rps->cols())) {
+    cout << "Duplicated RPs" << endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  if (!checkLayers<3>(3, 12, 0) || !checkLayers<5>(5, 4, 2) || !checkLayers<1>(1, 3, 0) ||
+      !checkLayers<Eigen::Dynamic>(8, 3, 0)) {
+    return 1;
+  }
+
+  // solvers copy their RPs from the cache
+  using Var_t = Eigen::Array<double, 4, 1>;
+  heu::NSGA3<Var_t, 3, heu::DONT_RECORD_FITNESS, heu::SINGLE_LAYER> a, b;
+  a.setiFun([](Var_t* v) { v->setZero(); });
+  b.setiFun([](Var_t* v) { v->setZero(); });
+  a.setReferencePointPrecision(12);
+  b.setReferencePointPrecision(12);
+  a.initializePop();
+  b.initializePop();
+  if (a.referencePoints().cols() != 91 || b.referencePoints().cols() != 91) {
+    cout << "Wrong number of RPs" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/EAGlobal>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <iostream>
+using namespace std;
+
+static atomic<int> fitnessCalls(0);
+
+using Var_t = Eigen::Array<double, 6, 1>;
+using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+using soga_t =
+    heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::RECORD_FITNESS, heu::SelectMethod::Truncation,
+              args_t, heu::GADefaults<Var_t, args_t>::iFun<>, nullptr,
+              heu::GADefaults<Var_t, args_t>::cFunSwapNs, heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+// The cost of fitness varies a lot between genes
+void slowRastrigin(const Var_t* x, const args_t*, double* f) {
+  fitnessCalls++;
+  if (heu::randD() < 0.05) {
+    this_thread::sleep_for(chrono::microseconds(500));
+  }
+  heu::testFunctions<Var_t>::rastrigin(x, f);
+}
+
+bool testSOGA() {
+  soga_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 60;
+  opt.maxFailTimes = -1;
+  opt.crossoverProb = 0.8;
+  opt.mutateProb = 0.1;
+  solver.setOption(opt);
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  solver.setArgs(args);
+  solver.setfFun(slowRastrigin);
+
+  fitnessCalls = 0;
+  solver.initializePop();
+  solver.runAsync();
+
+  cout << "SOGA : best fitness = " << solver.bestFitness() << ", " << solver.generation()
+       << " generations, " << fitnessCalls << " evaluations, initial best fitness = "
+       << solver.record().front() << endl;
+
+  if (solver.generation() != opt.maxGenerations ||
+      solver.record().size() != opt.maxGenerations + 1) {
+    cout << "Wrong number of generations" << endl;
+    return false;
+  }
+  // Each worker may have at most 2 children in evaluation when the solver stops
+  const int minCalls = int(opt.populationSize * (opt.maxGenerations + 1));
+  if (fitnessCalls < minCalls || fitnessCalls > minCalls + 2 * heu::threadNum() + 2) {
+    cout << "Wrong number of evaluations" << endl;
+    return false;
+  }
+  if (solver.population().size() > opt.populationSize + size_t(heu::threadNum()) + 1) {
+    cout << "Population is not selected" << endl;
+    return false;
+  }
+  if (!(solver.bestFitness() < 0.75 * solver.record().front())) {
+    cout << "SOGA doesn't converge" << endl;
+    return false;
+  }
+  return true;
+}
+
+static atomic<int> batchCalls(0);
+static atomic<int> wrongBatches(0);
+
+// Batches overlap in async mode, so each of them is checked and delayed a bit
+void slowRastriginBatch(const soga_t::BatchVar_t* x, const args_t*, soga_t::BatchFitness_t* f) {
+  batchCalls++;
+  if (x->cols() < 1 || f->cols() != x->cols()) {
+    wrongBatches++;
+  }
+  this_thread::sleep_for(chrono::microseconds(50));
+  for (int c = 0; c < x->cols(); c++) {
+    const Var_t v = x->col(c);
+    heu::testFunctions<Var_t>::rastrigin(&v, &(*f)(0, c));
+  }
+}
+
+bool testBatchSOGA() {
+  soga_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 40;
+  opt.maxFailTimes = -1;
+  opt.crossoverProb = 0.8;
+  opt.mutateProb = 0.1;
+  solver.setOption(opt);
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  solver.setArgs(args);
+  solver.setfFun(slowRastrigin);
+  solver.setBatchfFun(slowRastriginBatch);
+
+  fitnessCalls = 0;
+  batchCalls = 0;
+  wrongBatches = 0;
+  solver.initializePop();
+  solver.runAsync();
+
+  cout << "SOGA with batch fitness : best fitness = " << solver.bestFitness() << ", "
+       << batchCalls << " batches" << endl;
+
+  if (fitnessCalls != 0 || wrongBatches != 0 || batchCalls <= int(opt.maxGenerations)) {
+    cout << "Batch fitness function is not called correctly" << endl;
+    return false;
+  }
+  // A fitness written from another worker's buffer would mismatch its gene
+  for (const auto& gene : solver.population()) {
+    double f;
+    heu::testFunctions<Var_t>::rastrigin(&gene.decision_variable, &f);
+    if (f != gene.fitness) {
+      cout << "Fitness doesn't match its gene" << endl;
+      return false;
+    }
+  }
+  return solver.generation() == opt.maxGenerations;
+}
+
+using nsga2_t = heu::NSGA2<Var_t, 3, heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                           heu::GADefaults<Var_t, void>::iFunNd<>,
+                           heu::testFunctions<Var_t, Eigen::Array3d>::DTLZ2,
+                           heu::GADefaults<Var_t, void>::cFunNd<>>;
+
+bool testNSGA2() {
+  nsga2_t solver;
+  heu::GAOption opt;
+  opt.populationSize = 40;
+  opt.maxGenerations = 50;
+  solver.setOption(opt);
+  solver.setmFun([](const Var_t* src, Var_t* dst) {
+    *dst = *src;
+    const size_t idx = heu::randIdx(dst->size());
+    (*dst)[idx] = std::min(1.0, std::max(0.0, (*dst)[idx] + 0.05 * heu::randD(-1, 1)));
+  });
+  solver.initializePop();
+  solver.runAsync();
+
+  cout << "NSGA2 : " << solver.pfGenes().size() << " genes in PF after " << solver.generation()
+       << " generations" << endl;
+  return solver.generation() == opt.maxGenerations && !solver.pfGenes().empty();
+}
+
+int main() {
+  heu::setThreadNum(4);
+  if (!testSOGA() || !testBatchSOGA() || !testNSGA2()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <Eigen/Dense>
+#include <HeuristicFlow/Genetic>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/AOS>
+#include <HeuristicFlow/EAGlobal>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <iostream>
+using namespace std;
+
+static atomic<int> fitnessCalls(0);
+
+using Var_t = Eigen::Array<double, 6, 1>;
+using args_t = heu::ContinousBox<Var_t, heu::BoxShape::SQUARE_BOX>;
+using soga_t =
+    heu::SOGA<Var_t, heu::FITNESS_LESS_BETTER, heu::RECORD_FITNESS, heu::SelectMethod::Truncation,
+              args_t, heu::GADefaults<Var_t, args_t>::iFun<>, nullptr,
+              heu::GADefaults<Var_t, args_t>::cFunSwapNs, heu::GADefaults<Var_t, args_t>::mFun<>>;
+
+void countedRastrigin(const Var_t* x, const args_t*, double* f) {
+  fitnessCalls++;
+  heu::testFunctions<Var_t>::rastrigin(x, f);
+}
+
+void slowRastrigin(const Var_t* x, const args_t*, double* f) {
+  this_thread::sleep_for(chrono::microseconds(100));
+  heu::testFunctions<Var_t>::rastrigin(x, f);
+}
+
+void setupSOGA(soga_t* solver, const heu::TerminationCriteria& termination) {
+  heu::GAOption opt;
+  opt.populationSize = 50;
+  opt.maxGenerations = 100000;
+  opt.maxFailTimes = -1;
+  opt.crossoverProb = 0.8;
+  opt.mutateProb = 0.1;
+  opt.termination = termination;
+  solver->setOption(opt);
+  args_t args;
+  args.setRange(-5, 5);
+  args.setDelta(0.05);
+  solver->setArgs(args);
+  solver->setfFun(countedRastrigin);
+  solver->initializePop();
+}
+
+bool testEvaluationBudget() {
+  heu::setRandomSeed(20221017);
+  heu::TerminationCriteria termination;
+  termination.maxEvaluations = 2000;
+  soga_t solver;
+  setupSOGA(&solver, termination);
+  fitnessCalls = 0;
+  solver.run();
+
+  cout << "SOGA with evaluation budget : " << solver.evaluationCount() << " evaluations in "
+       << solver.generation() << " generations, best fitness = " << solver.bestFitness() << endl;
+
+  // The budget is checked once per generation, and a generation makes less than 2*popSize genes
+  if (size_t(fitnessCalls) != solver.evaluationCount() || solver.evaluationCount() < 2000 ||
+      solver.evaluationCount() >= 2000 + 2 * solver.option().populationSize) {
+    cout << "Wrong number of evaluations" << endl;
+    return false;
+  }
+  return solver.record().size() == solver.generation() + 1;
+}
+
+bool testTargetFitness() {
+  heu::setRandomSeed(20221017);
+  heu::TerminationCriteria termination;
+  termination.targetFitness = 10;
+  soga_t solver;
+  setupSOGA(&solver, termination);
+  solver.run();
+
+  cout << "SOGA with target fitness : best fitness = " << solver.bestFitness() << " in "
+       << solver.generation() << " generations" << endl;
+  if (solver.bestFitness() > 10 || solver.generation() >= solver.option().maxGenerations) {
+    cout << "Target fitness doesn't stop the solver" << endl;
+    return false;
+  }
+  // The target is reached in the last generation only
+  return solver.record().size() < 2 || solver.record()[solver.record().size() - 2] > 10;
+}
+
+bool testCancellation() {
+  heu::CancellationToken token;
+  heu::TerminationCriteria termination;
+  termination.cancelToken = &token;
+  soga_t solver;
+  setupSOGA(&solver, termination);
+  solver.setfFun(slowRastrigin);
+
+  thread canceller([&token]() {
+    this_thread::sleep_for(chrono::milliseconds(100));
+    token.cancel();
+  });
+  const auto begin = chrono::steady_clock::now();
+  solver.run();
+  const double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+  canceller.join();
+
+  cout << "SOGA cancelled after " << seconds << " s and " << solver.generation()
+       << " generations, best fitness = " << solver.bestFitness() << endl;
+  if (seconds > 5 || !token.isCancelled() || solver.generation() == 0) {
+    cout << "Cancellation doesn't stop the solver" << endl;
+    return false;
+  }
+
+  // A cancelled token stops the next run at once, until it is reset
+  solver.run();
+  if (solver.generation() != 0) {
+    cout << "Cancelled token is ignored" << endl;
+    return false;
+  }
+  token.reset();
+  return std::isfinite(solver.bestFitness());
+}
+
+bool testPSO() {
+  heu::setRandomSeed(20221017);
+  using pso_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                         heu::DONT_RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  pso_t solver;
+  heu::PSOOption opt;
+  opt.populationSize = 100;
+  opt.maxGeneration = 100000;
+  opt.maxFailTimes = -1;
+  opt.termination.maxEvaluations = 1050;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.initializePop();
+  solver.run();
+
+  cout << "PSO with evaluation budget : " << solver.evaluationCount() << " evaluations in "
+       << solver.generation() << " generations" << endl;
+  if (solver.evaluationCount() != 1100) {
+    cout << "Wrong number of evaluations" << endl;
+    return false;
+  }
+
+  opt.termination.maxEvaluations = 0;
+  opt.termination.maxSeconds = 0.1;
+  solver.setOption(opt);
+  const auto begin = chrono::steady_clock::now();
+  solver.run();
+  const double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+  cout << "PSO with time limit : " << seconds << " s, " << solver.generation() << " generations"
+       << endl;
+  if (seconds < 0.1 || seconds > 5 || solver.generation() >= opt.maxGeneration) {
+    cout << "Time limit doesn't stop the solver" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool testPSOSoA() {
+  heu::setRandomSeed(20221017);
+  using soa_t = heu::PSOSoA<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::DONT_RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+  soa_t solver;
+  heu::PSOOption opt;
+  opt.populationSize = 100;
+  opt.maxGeneration = 100000;
+  opt.maxFailTimes = -1;
+  opt.termination.maxEvaluations = 100000;
+  opt.termination.targetFitness = 10;
+  solver.setOption(opt);
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.5);
+  solver.initializePop();
+  solver.run();
+
+  cout << "PSOSoA with target fitness : best fitness = " << solver.bestFitness() << " after "
+       << solver.evaluationCount() << " evaluations" << endl;
+  if (solver.bestFitness() > 10 || solver.evaluationCount() >= 100000) {
+    cout << "Target fitness doesn't stop the solver" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool testAOS() {
+  heu::setRandomSeed(20221017);
+  using aos_t = heu::AOS<heu::FixedContinousBox17<Eigen::Array<double, 3, 1>, heu::encode(-5.0),
+                                                  heu::encode(5.0), heu::encode(1.5)>,
+                         heu::FITNESS_LESS_BETTER, heu::DONT_RECORD_FITNESS, void,
+                         heu::testFunctions<Eigen::Array<double, 3, 1>>::rastrigin>;
+  aos_t solver;
+  heu::AOSOption opt;
+  opt.electronNum = 50;
+  opt.maxGeneration = 100000;
+  opt.maxEarlyStop = 100000;
+  opt.termination.maxEvaluations = 500;
+  solver.setOption(opt);
+  solver.initializePop();
+  solver.run();
+
+  cout << "AOS with evaluation budget : " << solver.evaluationCount() << " evaluations in "
+       << solver.generation() << " generations" << endl;
+  if (solver.evaluationCount() < 500 || solver.generation() >= opt.maxGeneration) {
+    cout << "Evaluation budget doesn't stop the solver" << endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  if (!testEvaluationBudget() || !testTargetFitness() || !testCancellation() || !testPSO() ||
+      !testPSOSoA() || !testAOS()) {
+    return 1;
+  }
+  return 0;
+}
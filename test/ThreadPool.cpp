@@ -0,0 +1,127 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+// Use the built-in thread pool even if OpenMP is available
+#define HEU_USE_THREADPOOL
+
+#include <Eigen/Dense>
+#include <HeuristicFlow/PSO>
+#include <HeuristicFlow/EAGlobal>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Every index must be visited exactly once
+bool testCoverage() {
+  for (int thN : {1, 2, 3, 8}) {
+    heu::setThreadNum(thN);
+    for (int n : {0, 1, 7, 64, 1000}) {
+      vector<atomic<int>> visited(n + 5);
+      for (auto& v : visited) v = 0;
+      heu::parallel_for(5, n + 5, [&](int i) { visited[i]++; });
+      for (int i = 0; i < n + 5; i++) {
+        if (visited[i] != (i >= 5 ? 1 : 0)) {
+          cout << "Index " << i << " visited " << visited[i] << " times with " << thN
+               << " threads and " << n << " tasks" << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// The number of threads must be queried on every call
+bool testThreadNum() {
+  for (int thN : {4, 1, 2}) {
+    heu::setThreadNum(thN);
+    std::mutex lock;
+    std::set<std::thread::id> ids;
+    heu::parallel_for(0, 400, [&](int) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+      std::lock_guard<std::mutex> lk(lock);
+      ids.emplace(std::this_thread::get_id());
+    });
+    if (int(ids.size()) > thN) {
+      cout << ids.size() << " threads are used while threadNum is " << thN << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Nested loops run serially on the calling thread instead of deadlocking
+bool testNested() {
+  heu::setThreadNum(4);
+  atomic<int> sum(0);
+  heu::parallel_for(0, 16, [&](int i) {
+    heu::parallel_for(0, 16, [&](int j) { sum += i * 16 + j; });
+  });
+  if (sum != 255 * 256 / 2) {
+    cout << "Nested parallel_for gives wrong sum " << sum << endl;
+    return false;
+  }
+  return true;
+}
+
+// PSO gives the same result with the thread pool regardless of the number of threads
+double runPSO(int thN) {
+  static constexpr size_t N = 10;
+  using Var_t = Eigen::Array<double, N, 1>;
+  using solver_t = heu::PSO<Var_t, heu::BoxShape::SQUARE_BOX, heu::FITNESS_LESS_BETTER,
+                            heu::DONT_RECORD_FITNESS, void, heu::testFunctions<Var_t>::rastrigin>;
+
+  heu::setThreadNum(thN);
+  heu::setRandomSeed(3407);
+
+  heu::PSOOption opt;
+  opt.populationSize = 100;
+  opt.maxGeneration = 100;
+  opt.maxFailTimes = -1;
+
+  solver_t solver;
+  solver.setRange(-5.12, 5.12);
+  solver.setMaxVelocity(0.1);
+  solver.setOption(opt);
+  solver.initializePop();
+  solver.run();
+
+  cout << "PSO with " << thN << " threads : fitness = " << solver.bestFitness() << endl;
+  return solver.bestFitness();
+}
+
+int main() {
+#ifndef HEU_HAS_THREADPOOL
+  cout << "HEU_HAS_THREADPOOL is not defined" << endl;
+  return 1;
+#endif
+  if (!testCoverage() || !testThreadNum() || !testNested()) {
+    return 1;
+  }
+  if (runPSO(1) != runPSO(4)) {
+    cout << "Results differ with different number of threads" << endl;
+    return 1;
+  }
+  cout << "Thread pool has " << heu::internal::ThreadPool::global().workerNum() << " workers"
+       << endl;
+  return 0;
+}
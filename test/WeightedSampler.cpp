@@ -0,0 +1,94 @@
+/*
+ Copyright © 2021-2022  TokiNoBug
+This file is part of HeuristicFlow.
+
+    HeuristicFlow is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    HeuristicFlow is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with HeuristicFlow.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+#include <HeuristicFlow/Global>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+// Every element should be drawn exactly once
+bool testWithoutReplacement() {
+  vector<double> w{0, 1, 2, 0, 5, 3, 0.5, 0, 7};
+  heu::internal::WeightedSampler sampler;
+  sampler.reset(w);
+
+  vector<int> counter(w.size(), 0);
+  while (sampler.size() > 0) {
+    counter[sampler.draw()]++;
+  }
+
+  for (size_t i = 0; i < w.size(); i++) {
+    if (counter[i] != 1 || !sampler.isDrawn(i)) {
+      cout << "Element " << i << " is drawn " << counter[i] << " times" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The first draw should follow the distribution of weights
+bool testDistribution() {
+  vector<double> w{1, 0, 2, 3, 4};
+  const double sum = 10;
+  const int N = 200000;
+
+  vector<int> counter(w.size(), 0);
+  heu::internal::WeightedSampler sampler;
+  for (int i = 0; i < N; i++) {
+    sampler.reset(w);
+    counter[sampler.draw()]++;
+  }
+
+  for (size_t i = 0; i < w.size(); i++) {
+    const double freq = double(counter[i]) / N;
+    if (std::abs(freq - w[i] / sum) > 0.01) {
+      cout << "Element " << i << " is drawn with frequency " << freq << ", expected "
+           << w[i] / sum << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Elements should be drawn uniformly when all weights are 0
+bool testUniform() {
+  vector<double> w(7, 0);
+  const int N = 70000;
+  vector<int> counter(w.size(), 0);
+  heu::internal::WeightedSampler sampler;
+  for (int i = 0; i < N; i++) {
+    sampler.reset(w);
+    sampler.draw();
+    counter[sampler.draw()]++;
+  }
+  for (size_t i = 0; i < w.size(); i++) {
+    if (std::abs(double(counter[i]) / N - 1.0 / w.size()) > 0.01) {
+      cout << "Element " << i << " is drawn " << counter[i] << " times in uniform mode" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  if (!testWithoutReplacement() || !testDistribution() || !testUniform()) {
+    return 1;
+  }
+  cout << "All tests passed" << endl;
+  return 0;
+}